@@ -0,0 +1,17 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec4 Colour;
+
+out vec4 FragColour;
+
+// texture array sampler, and the layer of the texture in it
+uniform sampler2DArray imageTextureArray;
+uniform float fLayer;
+uniform vec4 ColourTint;
+
+void main()
+{
+	FragColour = Colour * texture(imageTextureArray, vec3(TexCoord, fLayer));
+	FragColour *= ColourTint;
+}
\ No newline at end of file
@@ -5,7 +5,11 @@ smooth in vec3 vNormal;
 smooth in vec3 vWorldPos;
 smooth in vec4 vEyeSpacePos;
 
-uniform sampler2D gSampler[5];
+// The textures which have the same size share a texture array. Each texture is a layer
+// in the texture array iArrays[i], and fLayers[i] is the index of its layer.
+uniform sampler2DArray gSamplers[5];
+uniform int iArrays[5];
+uniform float fLayers[5];
 uniform sampler2D shadowMap;
 
 uniform vec4 vColour;
@@ -18,6 +22,17 @@ uniform float fMaxTextureV;
 
 out vec4 outputColour;
 
+// Sample a texture of the terrain. The samplers can only be indexed by constants in GLSL 3.30.
+vec4 SampleTexture(int iTexture, vec2 vCoord)
+{
+	vec3 vLayerCoord = vec3(vCoord, fLayers[iTexture]);
+	if(iArrays[iTexture] == 0)return texture(gSamplers[0], vLayerCoord);
+	else if(iArrays[iTexture] == 1)return texture(gSamplers[1], vLayerCoord);
+	else if(iArrays[iTexture] == 2)return texture(gSamplers[2], vLayerCoord);
+	else if(iArrays[iTexture] == 3)return texture(gSamplers[3], vLayerCoord);
+	return texture(gSamplers[4], vLayerCoord);
+}
+
 void main()
 {
 	vec3 vNormalized = normalize(vNormal);
@@ -31,7 +46,7 @@ void main()
 	const float fRange3 = 0.65f;
 	const float fRange4 = 0.85f;
 
-	if(fScale >= 0.0 && fScale <= fRange1)vTexColour = texture(gSampler[0], vTexCoord);
+	if(fScale >= 0.0 && fScale <= fRange1)vTexColour = SampleTexture(0, vTexCoord);
 	else if(fScale <= fRange2)
 	{
 		fScale -= fRange1;
@@ -40,10 +55,10 @@ void main()
 		float fScale2 = fScale;
 		fScale = 1.0-fScale; 
 		
-		vTexColour += texture(gSampler[0], vTexCoord)*fScale;
-		vTexColour += texture(gSampler[1], vTexCoord)*fScale2;
+		vTexColour += SampleTexture(0, vTexCoord)*fScale;
+		vTexColour += SampleTexture(1, vTexCoord)*fScale2;
 	}
-	else if(fScale <= fRange3)vTexColour = texture(gSampler[1], vTexCoord);
+	else if(fScale <= fRange3)vTexColour = SampleTexture(1, vTexCoord);
 	else if(fScale <= fRange4)
 	{
 		fScale -= fRange3;
@@ -52,16 +67,16 @@ void main()
 		float fScale2 = fScale;
 		fScale = 1.0-fScale; 
 		
-		vTexColour += texture(gSampler[1], vTexCoord)*fScale;
-		vTexColour += texture(gSampler[2], vTexCoord)*fScale2;		
+		vTexColour += SampleTexture(1, vTexCoord)*fScale;
+		vTexColour += SampleTexture(2, vTexCoord)*fScale2;		
 	}
-	else vTexColour = texture(gSampler[2], vTexCoord);
+	else vTexColour = SampleTexture(2, vTexCoord);
 
 	vec2 vPathCoord = vec2(vTexCoord.x/fMaxTextureU, vTexCoord.y/fMaxTextureV);
-	vec4 vPathIntensity = texture(gSampler[4], vPathCoord);
+	vec4 vPathIntensity = SampleTexture(4, vPathCoord);
 	fScale = vPathIntensity.x;
   
-	vec4 vPathColour = texture(gSampler[3], vTexCoord); // Black Colour means there is a path
+	vec4 vPathColour = SampleTexture(3, vTexCoord); // Black Colour means there is a path
 	vec4 vFinalTexColour = fScale*vTexColour+(1-fScale)*vPathColour;
 
 	vec4 vMixedColour = vFinalTexColour*vColour;
@@ -11,6 +11,8 @@ uniform struct Matrices
 layout (location = 0) in vec3 inPosition;
 layout (location = 1) in vec2 inCoord;
 layout (location = 2) in vec3 inNormal;
+// The column and row of the vertex in the grid patch, which is used by the GPU displacement
+layout (location = 3) in vec2 inGridCoord;
 
 smooth out vec2 vTexCoord;
 smooth out vec3 vNormal;
@@ -19,16 +21,43 @@ smooth out vec4 vEyeSpacePos;
 
 uniform mat4 HeightmapScaleMatrix;
 
+// If bDisplacement is true, then the grid patch is moved to vec2ChunkOrigin and displaced by the heights in heightmapSampler
+uniform bool bDisplacement;
+uniform sampler2D heightmapSampler;
+uniform vec2 vec2ChunkOrigin;
+
 void main()
 {
-  vec4 inPositionScaled = HeightmapScaleMatrix * vec4(inPosition, 1.0);
+  vec3 vPosition = inPosition;
+  vec2 vCoord = inCoord;
+  vec3 vNormalLocal = inNormal;
+  if (bDisplacement)
+  {
+    ivec2 vSize = textureSize(heightmapSampler, 0);
+    ivec2 vCell = ivec2(vec2ChunkOrigin + inGridCoord + 0.5);
+    vec2 vScale = vec2(vCell) / vec2(vSize - 1);
+
+    vPosition = vec3(-0.5 + vScale.x, texelFetch(heightmapSampler, vCell, 0).r, -0.5 + vScale.y);
+    vCoord = vec2(vSize) * 0.1 * vScale;
+
+    // The normal is perpendicular to the central differences of the heights, or the one-sided differences on the edges
+    ivec2 vLeft = ivec2(max(vCell.x - 1, 0), vCell.y);
+    ivec2 vRight = ivec2(min(vCell.x + 1, vSize.x - 1), vCell.y);
+    ivec2 vUp = ivec2(vCell.x, max(vCell.y - 1, 0));
+    ivec2 vDown = ivec2(vCell.x, min(vCell.y + 1, vSize.y - 1));
+    float fSlopeX = (texelFetch(heightmapSampler, vRight, 0).r - texelFetch(heightmapSampler, vLeft, 0).r) * float(vSize.x - 1) / float(vRight.x - vLeft.x);
+    float fSlopeZ = (texelFetch(heightmapSampler, vDown, 0).r - texelFetch(heightmapSampler, vUp, 0).r) * float(vSize.y - 1) / float(vDown.y - vUp.y);
+    vNormalLocal = normalize(vec3(-fSlopeX, 1.0, -fSlopeZ));
+  }
+
+  vec4 inPositionScaled = HeightmapScaleMatrix * vec4(vPosition, 1.0);
   mat4 mMVP = matrices.projMatrix * matrices.viewMatrix * matrices.modelMatrix;
     
   gl_Position = mMVP * inPositionScaled;
-  vEyeSpacePos = matrices.viewMatrix * matrices.modelMatrix * vec4(inPosition, 1.0);
+  vEyeSpacePos = matrices.viewMatrix * matrices.modelMatrix * vec4(vPosition, 1.0);
 
-  vTexCoord = inCoord;
-  vNormal = inNormal;
+  vTexCoord = vCoord;
+  vNormal = vNormalLocal;
     
   vec4 vWorldPosLocal = matrices.modelMatrix * inPositionScaled;
   vWorldPos = vWorldPosLocal.xyz;
@@ -218,6 +218,7 @@ bool Application::Init(void)
 	// Add the shaders to the ShaderManager
 	CShaderManager::GetInstance()->Add("Shader2D", "Shader//Shader2D.vs", "Shader//Shader2D.fs");
 	CShaderManager::GetInstance()->Add("Shader2D_Colour", "Shader//Shader2D_Colour.vs", "Shader//Shader2D_Colour.fs");
+	CShaderManager::GetInstance()->Add("Shader2D_TextureArray", "Shader//Shader2D.vs", "Shader//Shader2D_TextureArray.fs");
 
 	CShaderManager::GetInstance()->Add("Shader3D", "Shader//Shader3D.vs", "Shader//Shader3D.fs");
 	CShaderManager::GetInstance()->Add("Shader3D_Line", "Shader//Shader3D_LineShader.vs", "Shader//Shader3D_LineShader.fs");
@@ -0,0 +1,435 @@
+/**
+ CAssetLoader
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "AssetLoader.h"
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include chrono
+#include <chrono>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Default Constructor
+ */
+CAssetLoader::CAssetLoader(void)
+	: uiMaxNumOfDecoded(8)
+	, uiNumOfRequests(0)
+	, uiNumOfUploaded(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CAssetLoader::~CAssetLoader(void)
+{
+	Exit();
+}
+
+/**
+ @brief Initialise this class instance
+ @param uiMaxNumOfDecoded A const unsigned int variable containing the maximum number of assets
+		which are being decoded or are waiting to be uploaded
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CAssetLoader::Init(const unsigned int uiMaxNumOfDecoded)
+{
+	this->uiMaxNumOfDecoded = (uiMaxNumOfDecoded > 0 ? uiMaxNumOfDecoded : 1);
+	uiNumOfRequests = 0;
+	uiNumOfUploaded = 0;
+
+	return true;
+}
+
+/**
+ @brief Wait for the assets which are being decoded, and discard all the assets which are not uploaded yet.
+		Their callbacks are not called.
+ */
+void CAssetLoader::Exit(void)
+{
+	// Wait for the jobs, since they write to this class instance
+	CJobSystem::GetInstance()->Wait(sDecodingCounter);
+
+	while (dPending.empty() == false)
+	{
+		Free(dPending.front());
+		dPending.pop_front();
+	}
+
+	std::lock_guard<std::mutex> lock(mDecodedMutex);
+	while (dDecoded.empty() == false)
+	{
+		Free(dDecoded.front());
+		dDecoded.pop_front();
+	}
+}
+
+/**
+ @brief Load a mesh from an OBJ file in the background
+ @param sFilePath A const std::string& variable containing the path of the OBJ file
+ @param callback A const MESHCALLBACK& variable containing the callback which uploads the mesh on the main thread
+ */
+void CAssetLoader::LoadMesh(const std::string& sFilePath, const MESHCALLBACK& callback)
+{
+	SRequest* pRequest = new SRequest();
+	pRequest->eType = TYPE::MESH;
+	pRequest->bInvert = false;
+	pRequest->bCompress = false;
+	pRequest->meshCallback = callback;
+	pRequest->sMeshData.sFilePath = sFilePath;
+	pRequest->sMeshData.pVertices = NULL;
+	pRequest->sMeshData.uiNumOfVertices = 0;
+	pRequest->sMeshData.pIndices = NULL;
+	pRequest->sMeshData.uiNumOfIndices = 0;
+	pRequest->sMeshData.eIndexType = GL_UNSIGNED_INT;
+	pRequest->sMeshData.vec3BoundsMin = glm::vec3(0.0f);
+	pRequest->sMeshData.vec3BoundsMax = glm::vec3(0.0f);
+	pRequest->sMeshData.bSuccess = false;
+
+	dPending.push_back(pRequest);
+	uiNumOfRequests++;
+	Dispatch();
+}
+
+/**
+ @brief Load an image in the background
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @param callback A const IMAGECALLBACK& variable containing the callback which uploads the image on the main thread
+ @param bCompress A const bool variable which is true if the image is to be loaded as a compressed texture.
+		It is ignored if the graphics card does not support the compressed formats.
+ */
+void CAssetLoader::LoadImageData(const std::string& sFilePath, const bool bInvert, const IMAGECALLBACK& callback, const bool bCompress)
+{
+	SRequest* pRequest = new SRequest();
+	pRequest->eType = TYPE::IMAGE;
+	pRequest->bInvert = bInvert;
+	pRequest->bCompress = (bCompress == true) && (CTextureCache::IsSupported() == true);
+	pRequest->imageCallback = callback;
+	pRequest->sImageData.sFilePath = sFilePath;
+	pRequest->sImageData.pData = NULL;
+	pRequest->sImageData.iWidth = 0;
+	pRequest->sImageData.iHeight = 0;
+	pRequest->sImageData.iNumOfChannels = 0;
+	pRequest->sImageData.pCompressed = NULL;
+	pRequest->sImageData.bSuccess = false;
+
+	dPending.push_back(pRequest);
+	uiNumOfRequests++;
+	Dispatch();
+}
+
+/**
+ @brief Load an image in the background, and create a 2D texture from it on the main thread
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @param callback A const TEXTURECALLBACK& variable containing the callback which receives the texture ID
+ @param bCompress A const bool variable which is true if the texture is to be compressed
+ */
+void CAssetLoader::LoadTexture(const std::string& sFilePath, const bool bInvert, const TEXTURECALLBACK& callback, const bool bCompress)
+{
+	LoadImageData(sFilePath, bInvert, [callback](const SImageData& sImageData)
+	{
+		GLuint uiTextureID = 0;
+		if (sImageData.bSuccess == true)
+			uiTextureID = CreateTexture(sImageData);
+		else
+			cout << "Unable to load " << sImageData.sFilePath << endl;
+
+		callback(uiTextureID);
+	}, bCompress);
+}
+
+/**
+ @brief Upload the decoded assets on the main thread until the time budget is used up.
+		At least one asset is uploaded in each call, so that the loading always progresses.
+ @param dBudgetMilliseconds A const double variable containing the time budget in milliseconds
+ @return An unsigned int variable containing the number of assets which were uploaded
+ */
+unsigned int CAssetLoader::Update(const double dBudgetMilliseconds)
+{
+	const std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+	unsigned int uiNumOfUploadedNow = 0;
+
+	while (true)
+	{
+		SRequest* pRequest = NULL;
+		{
+			std::lock_guard<std::mutex> lock(mDecodedMutex);
+			if (dDecoded.empty() == false)
+			{
+				pRequest = dDecoded.front();
+				dDecoded.pop_front();
+			}
+		}
+
+		// Send more requests to the worker threads, since there is space in the upload queue now
+		Dispatch();
+
+		if (pRequest == NULL)
+			break;
+
+		if (pRequest->eType == TYPE::MESH)
+		{
+			if (pRequest->sMeshData.bSuccess == false)
+				cout << "Unable to load " << pRequest->sMeshData.sFilePath << endl;
+			if (pRequest->meshCallback)
+				pRequest->meshCallback(pRequest->sMeshData);
+		}
+		else
+		{
+			if (pRequest->imageCallback)
+				pRequest->imageCallback(pRequest->sImageData);
+		}
+		Free(pRequest);
+
+		uiNumOfUploaded++;
+		uiNumOfUploadedNow++;
+
+		const double dElapsedMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tStart).count();
+		if (dElapsedMilliseconds >= dBudgetMilliseconds)
+			break;
+	}
+
+	return uiNumOfUploadedNow;
+}
+
+/**
+ @brief Check if all the assets are loaded
+ @return A bool variable which is true if there are no assets to decode or to upload
+ */
+bool CAssetLoader::IsIdle(void)
+{
+	std::lock_guard<std::mutex> lock(mDecodedMutex);
+	return ((dPending.empty() == true) && (dDecoded.empty() == true) && (sDecodingCounter.IsDone() == true));
+}
+
+/**
+ @brief Get the fraction of the assets which are loaded
+ @return A float variable containing the fraction of the assets which are loaded, from 0.0 to 1.0
+ */
+float CAssetLoader::GetProgress(void) const
+{
+	if (uiNumOfRequests == 0)
+		return 1.0f;
+
+	return (float)uiNumOfUploaded / (float)uiNumOfRequests;
+}
+
+/**
+ @brief Create a 2D texture from a decoded image. A compressed texture is uploaded with its cooked mipmaps.
+ @param sImageData A const SImageData& variable containing the decoded image
+ @return A GLuint variable containing the texture ID, or 0 if the image is not valid
+ */
+GLuint CAssetLoader::CreateTexture(const SImageData& sImageData)
+{
+	if (sImageData.pCompressed)
+		return CTextureCache::CreateTexture(*sImageData.pCompressed);
+
+	if ((sImageData.pData == NULL) || (sImageData.iWidth <= 0) || (sImageData.iHeight <= 0))
+		return 0;
+
+	GLenum eFormat = GL_RGB;
+	if (sImageData.iNumOfChannels == 1)
+		eFormat = GL_RED;
+	else if (sImageData.iNumOfChannels == 4)
+		eFormat = GL_RGBA;
+
+	GLuint uiTextureID = 0;
+	glGenTextures(1, &uiTextureID);
+	glBindTexture(GL_TEXTURE_2D, uiTextureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// The rows of an RGB image may not be aligned to 4 bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, eFormat, sImageData.iWidth, sImageData.iHeight, 0, eFormat, GL_UNSIGNED_BYTE, sImageData.pData);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return uiTextureID;
+}
+
+/**
+ @brief Decode an image with the CImageLoader. It is locked while the image is decoded, since
+		the worker threads decode images with it while the assets are loaded in the background.
+ @param sFilePath A const char* variable containing the file path of the image
+ @param iWidth An int& variable which the width of the image is returned in
+ @param iHeight An int& variable which the height of the image is returned in
+ @param iNumOfChannels An int& variable which the number of channels of the image is returned in
+ @param bInvert A const bool variable to indicate if the image should be flipped vertically
+ @return An unsigned char* variable containing the pixels, which must be freed with free(), or NULL if the image could not be loaded
+ */
+unsigned char* CAssetLoader::DecodeImage(const char* sFilePath, int& iWidth, int& iHeight, int& iNumOfChannels, const bool bInvert)
+{
+	std::lock_guard<std::mutex> lock(mImageLoaderMutex);
+	return CImageLoader::GetInstance()->Load(sFilePath, iWidth, iHeight, iNumOfChannels, bInvert);
+}
+
+/**
+ @brief Load an image and create a 2D texture from it with the CImageLoader. It must be called on
+		the main thread, and the CImageLoader is locked while the image is decoded.
+ @param sFilePath A const char* variable containing the file path of the image
+ @param bInvert A const bool variable to indicate if the image should be flipped vertically
+ @return A GLuint variable containing the texture ID, or 0 if the image could not be loaded
+ */
+GLuint CAssetLoader::LoadTextureGetID(const char* sFilePath, const bool bInvert)
+{
+	std::lock_guard<std::mutex> lock(mImageLoaderMutex);
+	return CImageLoader::GetInstance()->LoadTextureGetID(sFilePath, bInvert);
+}
+
+/**
+ @brief PrintSelf
+ */
+void CAssetLoader::PrintSelf(void)
+{
+	cout << "CAssetLoader::PrintSelf()" << endl;
+	cout << "Number of requests: " << uiNumOfRequests << endl;
+	cout << "Number of uploaded assets: " << uiNumOfUploaded << endl;
+	cout << "Number of pending requests: " << dPending.size() << endl;
+	cout << "Number of assets being decoded: " << sDecodingCounter.iValue << endl;
+}
+
+/**
+ @brief Send the pending requests to the worker threads while the upload queue has space
+ */
+void CAssetLoader::Dispatch(void)
+{
+	while (dPending.empty() == false)
+	{
+		unsigned int uiNumOfDecoded = (unsigned int)sDecodingCounter.iValue.load();
+		{
+			std::lock_guard<std::mutex> lock(mDecodedMutex);
+			uiNumOfDecoded += (unsigned int)dDecoded.size();
+		}
+		if (uiNumOfDecoded >= uiMaxNumOfDecoded)
+			break;
+
+		SRequest* pRequest = dPending.front();
+		dPending.pop_front();
+		CJobSystem::GetInstance()->Run([this, pRequest]() { Decode(pRequest); }, &sDecodingCounter);
+	}
+}
+
+/**
+ @brief Decode an asset on a worker thread, and put it into the upload queue
+ @param pRequest A SRequest* variable containing the request
+ */
+void CAssetLoader::Decode(SRequest* pRequest)
+{
+	if (pRequest->eType == TYPE::MESH)
+	{
+		SMeshData& sMeshData = pRequest->sMeshData;
+		CMeshCache::SMappedMesh& sMappedMesh = pRequest->sMappedMesh;
+
+		// Parse the OBJ file and cook it if it was not cooked yet, or if it was changed
+		if (CMeshCache::Open(sMeshData.sFilePath, sMappedMesh) == false)
+		{
+			if (CMeshCache::LoadOBJ(sMeshData.sFilePath, sMeshData.vVertices, sMeshData.vIndices,
+									sMeshData.vec3BoundsMin, sMeshData.vec3BoundsMax) == true)
+			{
+				if (CMeshCache::Cook(	sMeshData.sFilePath, sMeshData.vVertices, sMeshData.vIndices,
+										sMeshData.vec3BoundsMin, sMeshData.vec3BoundsMax) == true)
+				{
+					CMeshCache::Open(sMeshData.sFilePath, sMappedMesh);
+				}
+			}
+		}
+
+		if (sMappedMesh.IsOpen() == true)
+		{
+			// Upload the vertices and indices straight from the cooked mesh
+			const CMeshCache::SHeader* pHeader = sMappedMesh.pHeader;
+			sMeshData.pVertices = sMappedMesh.pVertices;
+			sMeshData.uiNumOfVertices = pHeader->uiNumOfVertices;
+			sMeshData.pIndices = sMappedMesh.pIndices;
+			sMeshData.uiNumOfIndices = pHeader->uiNumOfIndices;
+			sMeshData.eIndexType = sMappedMesh.GetIndexType();
+			sMeshData.vec3BoundsMin = glm::vec3(pHeader->arrBoundsMin[0], pHeader->arrBoundsMin[1], pHeader->arrBoundsMin[2]);
+			sMeshData.vec3BoundsMax = glm::vec3(pHeader->arrBoundsMax[0], pHeader->arrBoundsMax[1], pHeader->arrBoundsMax[2]);
+			std::vector<ModelVertex>().swap(sMeshData.vVertices);
+			std::vector<GLuint>().swap(sMeshData.vIndices);
+		}
+		else if (sMeshData.vIndices.empty() == false)
+		{
+			// The mesh could not be cooked, so upload the vertices and indices which were loaded from the OBJ file
+			sMeshData.pVertices = &sMeshData.vVertices[0];
+			sMeshData.uiNumOfVertices = (unsigned int)sMeshData.vVertices.size();
+			sMeshData.pIndices = &sMeshData.vIndices[0];
+			sMeshData.uiNumOfIndices = (unsigned int)sMeshData.vIndices.size();
+			sMeshData.eIndexType = GL_UNSIGNED_INT;
+		}
+		sMeshData.bSuccess = (sMeshData.uiNumOfIndices > 0);
+	}
+	else
+	{
+		SImageData& sImageData = pRequest->sImageData;
+		CTextureCache::SMappedTexture& sMappedTexture = pRequest->sMappedTexture;
+
+		// A compressed texture which was cooked before does not need to be decoded
+		if ((pRequest->bCompress == false) ||
+			(CTextureCache::Open(sImageData.sFilePath, pRequest->bInvert, false, sMappedTexture) == false))
+		{
+			sImageData.pData = DecodeImage(	sImageData.sFilePath.c_str(),
+											sImageData.iWidth,
+											sImageData.iHeight,
+											sImageData.iNumOfChannels,
+											pRequest->bInvert);
+
+			// Cook the image if it was not cooked yet, or if it was changed. If it cannot be cooked,
+			// such as a single channel image, then the decoded pixels are uploaded instead.
+			if ((pRequest->bCompress == true) &&
+				(CTextureCache::Cook(	sImageData.sFilePath, pRequest->bInvert, false, sImageData.pData,
+										sImageData.iWidth, sImageData.iHeight, sImageData.iNumOfChannels) == true))
+			{
+				CTextureCache::Open(sImageData.sFilePath, pRequest->bInvert, false, sMappedTexture);
+			}
+		}
+
+		if (sMappedTexture.IsOpen() == true)
+		{
+			// Upload the compressed texture straight from the cooked texture
+			sImageData.pCompressed = &sMappedTexture;
+			sImageData.iWidth = (int)sMappedTexture.pHeader->uiWidth;
+			sImageData.iHeight = (int)sMappedTexture.pHeader->uiHeight;
+			sImageData.iNumOfChannels = (int)sMappedTexture.pHeader->uiNumOfChannels;
+			if (sImageData.pData)
+			{
+				free(sImageData.pData);
+				sImageData.pData = NULL;
+			}
+		}
+		sImageData.bSuccess = ((sImageData.pData != NULL) || (sImageData.pCompressed != NULL));
+	}
+
+	std::lock_guard<std::mutex> lock(mDecodedMutex);
+	dDecoded.push_back(pRequest);
+}
+
+/**
+ @brief Free a request and the decoded asset in it
+ @param pRequest A SRequest* variable containing the request
+ */
+void CAssetLoader::Free(SRequest* pRequest)
+{
+	if (pRequest->sImageData.pData)
+	{
+		// Free up the memory of the file data read in
+		free(pRequest->sImageData.pData);
+		pRequest->sImageData.pData = NULL;
+	}
+	CMeshCache::Close(pRequest->sMappedMesh);
+	CTextureCache::Close(pRequest->sMappedTexture);
+	delete pRequest;
+}
@@ -0,0 +1,178 @@
+/**
+ CAssetLoader
+ @brief This class loads the assets in the background. The files are read and decoded as jobs
+		on the worker threads of the CJobSystem, and the decoded assets are put into a bounded
+		upload queue. The main thread, which owns the OpenGL context, calls Update every frame
+		to upload the decoded assets until a time budget is used up. The meshes are read from
+		the CMeshCache, and the compressed textures are read from the CTextureCache. They are
+		cooked when they are loaded for the first time.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include LoadOBJ
+#include "System/LoadOBJ.h"
+
+// Include CMeshCache
+#include "MeshCache.h"
+
+// Include CTextureCache
+#include "TextureCache.h"
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include CJobSystem
+#include "../JobSystem/JobSystem.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <functional>
+
+class CAssetLoader : public CSingletonTemplate<CAssetLoader>
+{
+	friend class CSingletonTemplate<CAssetLoader>;
+
+public:
+	// The decoded vertices and indices of a mesh. They are freed after the callback is called.
+	struct SMeshData
+	{
+		std::string sFilePath;
+		// The vertices and indices to upload. They point into the cooked mesh, or into vVertices and vIndices.
+		const ModelVertex* pVertices;
+		unsigned int uiNumOfVertices;
+		const void* pIndices;
+		unsigned int uiNumOfIndices;
+		// The type of the indices, which is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+		GLenum eIndexType;
+		// The bounds of the mesh
+		glm::vec3 vec3BoundsMin, vec3BoundsMax;
+		bool bSuccess;
+
+		// The vertices and indices which are loaded from the OBJ file if the mesh could not be cooked
+		std::vector<ModelVertex> vVertices;
+		std::vector<GLuint> vIndices;
+
+		// Get the size of the vertices in bytes
+		GLsizeiptr GetVertexBufferSize(void) const
+		{
+			return (GLsizeiptr)uiNumOfVertices * sizeof(ModelVertex);
+		}
+		// Get the size of the indices in bytes
+		GLsizeiptr GetIndexBufferSize(void) const
+		{
+			return (GLsizeiptr)uiNumOfIndices * (eIndexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint));
+		}
+	};
+
+	// The decoded pixels of an image. The pixels are freed after the callback is called.
+	struct SImageData
+	{
+		std::string sFilePath;
+		unsigned char* pData;
+		int iWidth, iHeight, iNumOfChannels;
+		// The cooked texture if the image was loaded as a compressed texture, or NULL if pData contains the pixels
+		const CTextureCache::SMappedTexture* pCompressed;
+		bool bSuccess;
+	};
+
+	// The callback which uploads a decoded mesh on the main thread
+	typedef std::function<void(const SMeshData& sMeshData)> MESHCALLBACK;
+	// The callback which uploads a decoded image on the main thread
+	typedef std::function<void(const SImageData& sImageData)> IMAGECALLBACK;
+	// The callback which receives a texture on the main thread. The texture ID is 0 if the loading had failed.
+	typedef std::function<void(const GLuint uiTextureID)> TEXTURECALLBACK;
+
+	// Initialise this class instance
+	bool Init(const unsigned int uiMaxNumOfDecoded = 8);
+	// Wait for the assets which are being decoded, and discard all the assets which are not uploaded yet
+	void Exit(void);
+
+	// Load a mesh from an OBJ file in the background
+	void LoadMesh(const std::string& sFilePath, const MESHCALLBACK& callback);
+	// Load an image in the background. It is not named LoadImage, which is a macro in windows.h.
+	void LoadImageData(const std::string& sFilePath, const bool bInvert, const IMAGECALLBACK& callback, const bool bCompress = false);
+	// Load an image in the background, and create a 2D texture from it on the main thread
+	void LoadTexture(const std::string& sFilePath, const bool bInvert, const TEXTURECALLBACK& callback, const bool bCompress = true);
+
+	// Upload the decoded assets on the main thread until the time budget is used up
+	unsigned int Update(const double dBudgetMilliseconds);
+
+	// Check if all the assets are loaded
+	bool IsIdle(void);
+	// Get the fraction of the assets which are loaded, from 0.0 to 1.0
+	float GetProgress(void) const;
+
+	// Create a 2D texture from a decoded image
+	static GLuint CreateTexture(const SImageData& sImageData);
+
+	// Decode an image with the CImageLoader. Every image is decoded through this method or
+	// LoadTextureGetID, since the CImageLoader is shared with the worker threads.
+	unsigned char* DecodeImage(const char* sFilePath, int& iWidth, int& iHeight, int& iNumOfChannels, const bool bInvert = false);
+	// Load an image and create a 2D texture from it with the CImageLoader, on the main thread
+	GLuint LoadTextureGetID(const char* sFilePath, const bool bInvert);
+
+	// PrintSelf
+	void PrintSelf(void);
+
+protected:
+	// The types of assets
+	enum class TYPE : unsigned int
+	{
+		MESH = 0,
+		IMAGE,
+		NUM_TYPE
+	};
+
+	// A request to load an asset, which also stores the decoded asset
+	struct SRequest
+	{
+		TYPE eType;
+		bool bInvert;
+		bool bCompress;
+		MESHCALLBACK meshCallback;
+		IMAGECALLBACK imageCallback;
+		SMeshData sMeshData;
+		SImageData sImageData;
+		// The cooked mesh which the vertices and indices of sMeshData point into
+		CMeshCache::SMappedMesh sMappedMesh;
+		// The cooked texture which sImageData points to
+		CTextureCache::SMappedTexture sMappedTexture;
+	};
+
+	// The maximum number of assets which are being decoded or are waiting to be uploaded.
+	// This bounds the memory which is used by the decoded assets.
+	unsigned int uiMaxNumOfDecoded;
+	// The requests which are not sent to the worker threads yet. Only used by the main thread.
+	std::deque<SRequest*> dPending;
+	// The decoded assets which are waiting to be uploaded
+	std::deque<SRequest*> dDecoded;
+	// Protects dDecoded
+	std::mutex mDecodedMutex;
+	// Serialises the use of the CImageLoader, since it is shared by all the threads. See DecodeImage.
+	std::mutex mImageLoaderMutex;
+	// The number of jobs which are decoding an asset
+	CJobSystem::SCounter sDecodingCounter;
+
+	// The number of requests and the number of assets which are uploaded
+	unsigned int uiNumOfRequests;
+	unsigned int uiNumOfUploaded;
+
+	// Send the pending requests to the worker threads while the upload queue has space
+	void Dispatch(void);
+	// Decode an asset on a worker thread
+	void Decode(SRequest* pRequest);
+	// Free a request and the decoded asset in it
+	void Free(SRequest* pRequest);
+
+	// Default Constructor
+	CAssetLoader(void);
+	// Destructor
+	virtual ~CAssetLoader(void);
+};
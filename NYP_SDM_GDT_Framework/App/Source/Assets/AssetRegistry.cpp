@@ -0,0 +1,553 @@
+/**
+ CAssetRegistry
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "AssetRegistry.h"
+
+// Include MeshBuilder
+#include "Primitives/MeshBuilder.h"
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include sstream for the keys of the meshes
+#include <sstream>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Default Constructor
+ */
+CAssetRegistry::CAssetRegistry(void)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CAssetRegistry::~CAssetRegistry(void)
+{
+	Exit();
+}
+
+/**
+ @brief Initialise this class instance
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CAssetRegistry::Init(void)
+{
+	return true;
+}
+
+/**
+ @brief Delete all the assets, even if they are still acquired
+ */
+void CAssetRegistry::Exit(void)
+{
+	for (std::map<std::string, SMesh*>::iterator it = mMeshes.begin(); it != mMeshes.end(); ++it)
+	{
+		DeleteMesh(it->second);
+		delete it->second;
+	}
+	mMeshes.clear();
+
+	for (std::map<std::string, STexture*>::iterator it = mTextures.begin(); it != mTextures.end(); ++it)
+	{
+		DeleteTexture(it->second);
+		delete it->second;
+	}
+	mTextures.clear();
+}
+
+/**
+ @brief Acquire a mesh which is created by a builder. The builder is only called if the mesh is not created yet.
+		The VAO of the mesh is bound while the builder is called, and is unbound after that.
+ @param sKey A const std::string& variable containing the key of the mesh, which describes its recipe
+ @param builder A const MESHBUILDER& variable containing the function which creates the mesh
+ @return A SMesh* variable containing the mesh
+ */
+CAssetRegistry::SMesh* CAssetRegistry::AcquireMesh(const std::string& sKey, const MESHBUILDER& builder)
+{
+	std::map<std::string, SMesh*>::iterator it = mMeshes.find(sKey);
+	if (it != mMeshes.end())
+	{
+		it->second->uiRefCount++;
+		return it->second;
+	}
+
+	SMesh* pMesh = new SMesh();
+	pMesh->sKey = sKey;
+	pMesh->uiVBO = 0;
+	pMesh->uiIBO = 0;
+	pMesh->uiNumOfIndices = 0;
+	pMesh->eIndexType = GL_UNSIGNED_INT;
+	pMesh->vec3BoundsMin = glm::vec3(0.0f);
+	pMesh->vec3BoundsMax = glm::vec3(0.0f);
+	pMesh->uiRefCount = 1;
+
+	// Generate and bind the VAO
+	glGenVertexArrays(1, &pMesh->uiVAO);
+	glBindVertexArray(pMesh->uiVAO);
+	pMesh->p3DMesh = builder();
+	pMesh->uiMemorySize = GetBoundBufferSize();
+	glBindVertexArray(0);
+
+	pMesh->bLoaded = (pMesh->p3DMesh != NULL);
+	if (pMesh->bLoaded == false)
+		cout << "Unable to create the mesh " << sKey << endl;
+
+	mMeshes[sKey] = pMesh;
+	return pMesh;
+}
+
+/**
+ @brief Acquire a box which is created by the CMeshBuilder
+ @param vec4Colour A const glm::vec4& variable containing the colour of the box
+ @param fLength A const float variable containing the length of the box
+ @param fWidth A const float variable containing the width of the box
+ @param fHeight A const float variable containing the height of the box
+ @return A SMesh* variable containing the mesh
+ */
+CAssetRegistry::SMesh* CAssetRegistry::AcquireBox(	const glm::vec4& vec4Colour,
+													const float fLength, const float fWidth, const float fHeight)
+{
+	std::ostringstream ssKey;
+	ssKey << "Box(" << vec4Colour.x << "," << vec4Colour.y << "," << vec4Colour.z << "," << vec4Colour.w
+		<< "," << fLength << "," << fWidth << "," << fHeight << ")";
+
+	return AcquireMesh(ssKey.str(), [vec4Colour, fLength, fWidth, fHeight]()
+	{
+		return CMeshBuilder::GenerateBox(vec4Colour, fLength, fWidth, fHeight);
+	});
+}
+
+/**
+ @brief Acquire a mesh which is loaded from an OBJ file in the background. The position is at attribute 0
+		and the texture coordinate is at attribute 1. The callback is called on the main thread when
+		the mesh is loaded, or now if the mesh was already loaded.
+ @param sFilePath A const std::string& variable containing the path of the OBJ file
+ @param pOwner A const void* variable containing the owner of the callback, which must release the mesh with it
+ @param callback A const MESHCALLBACK& variable containing the callback which receives the mesh
+ @return A SMesh* variable containing the mesh
+ */
+CAssetRegistry::SMesh* CAssetRegistry::AcquireModel(const std::string& sFilePath, const void* pOwner, const MESHCALLBACK& callback)
+{
+	std::map<std::string, SMesh*>::iterator it = mMeshes.find(sFilePath);
+	if (it != mMeshes.end())
+	{
+		SMesh* pMesh = it->second;
+		pMesh->uiRefCount++;
+		if (pMesh->bLoaded == true)
+			callback(*pMesh);
+		else
+			pMesh->vWaiting.push_back(std::make_pair(pOwner, callback));
+		return pMesh;
+	}
+
+	SMesh* pMesh = new SMesh();
+	pMesh->sKey = sFilePath;
+	pMesh->uiVAO = 0;
+	pMesh->uiVBO = 0;
+	pMesh->uiIBO = 0;
+	pMesh->p3DMesh = NULL;
+	pMesh->uiNumOfIndices = 0;
+	pMesh->eIndexType = GL_UNSIGNED_INT;
+	pMesh->vec3BoundsMin = glm::vec3(0.0f);
+	pMesh->vec3BoundsMax = glm::vec3(0.0f);
+	pMesh->uiMemorySize = 0;
+	// The loading holds a reference too, so that the mesh is not deleted before it is uploaded
+	pMesh->uiRefCount = 2;
+	pMesh->bLoaded = false;
+	pMesh->vWaiting.push_back(std::make_pair(pOwner, callback));
+	mMeshes[sFilePath] = pMesh;
+
+	CAssetLoader::GetInstance()->LoadMesh(sFilePath, [this, pMesh](const CAssetLoader::SMeshData& sMeshData)
+	{
+		UploadModel(pMesh, sMeshData);
+		Release(pMesh);
+	});
+
+	return pMesh;
+}
+
+/**
+ @brief Release a mesh. It is deleted when it is not used anymore.
+ @param pMesh A SMesh* variable containing the mesh
+ @param pOwner A const void* variable containing the owner which acquired the mesh. If its callback is still
+		waiting for the mesh to be loaded, then it is removed, so that it is not called after this.
+ */
+void CAssetRegistry::Release(SMesh* pMesh, const void* pOwner)
+{
+	if ((pMesh == NULL) || (pMesh->uiRefCount == 0))
+		return;
+
+	if (pOwner != NULL)
+	{
+		for (unsigned int i = 0; i < pMesh->vWaiting.size(); i++)
+		{
+			if (pMesh->vWaiting[i].first == pOwner)
+			{
+				pMesh->vWaiting.erase(pMesh->vWaiting.begin() + i);
+				break;
+			}
+		}
+	}
+
+	pMesh->uiRefCount--;
+	if (pMesh->uiRefCount > 0)
+		return;
+
+	mMeshes.erase(pMesh->sKey);
+	DeleteMesh(pMesh);
+	delete pMesh;
+}
+
+/**
+ @brief Acquire a texture which is loaded now. It is a compressed texture if the image can be cooked.
+		If the texture is still being loaded in the background, then it is loaded now instead,
+		and the callbacks which are waiting for it are called now.
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @return A STexture* variable containing the texture
+ */
+CAssetRegistry::STexture* CAssetRegistry::AcquireTexture(const std::string& sFilePath, const bool bInvert)
+{
+	const std::string sKey = sFilePath + (bInvert == true ? "|Inverted" : "");
+	std::map<std::string, STexture*>::iterator it = mTextures.find(sKey);
+	if (it != mTextures.end())
+	{
+		STexture* pTexture = it->second;
+		pTexture->uiRefCount++;
+		if (pTexture->bLoaded == false)
+			SetLoaded(pTexture, LoadTextureNow(sFilePath, bInvert));
+		return pTexture;
+	}
+
+	STexture* pTexture = new STexture();
+	pTexture->sKey = sKey;
+	pTexture->sFilePath = sFilePath;
+	pTexture->bInvert = bInvert;
+	pTexture->uiTextureID = 0;
+	pTexture->uiMemorySize = 0;
+	pTexture->uiRefCount = 1;
+	pTexture->bLoaded = false;
+	mTextures[sKey] = pTexture;
+	SetLoaded(pTexture, LoadTextureNow(sFilePath, bInvert));
+
+	return pTexture;
+}
+
+/**
+ @brief Acquire a texture which is loaded in the background. The callback is called on the main thread
+		when the texture is loaded, or now if the texture was already loaded.
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @param pOwner A const void* variable containing the owner of the callback, which must release the texture with it
+ @param callback A const TEXTURECALLBACK& variable containing the callback which receives the texture
+ @return A STexture* variable containing the texture
+ */
+CAssetRegistry::STexture* CAssetRegistry::AcquireTexture(const std::string& sFilePath, const bool bInvert, const void* pOwner, const TEXTURECALLBACK& callback)
+{
+	const std::string sKey = sFilePath + (bInvert == true ? "|Inverted" : "");
+	std::map<std::string, STexture*>::iterator it = mTextures.find(sKey);
+	if (it != mTextures.end())
+	{
+		STexture* pTexture = it->second;
+		pTexture->uiRefCount++;
+		if (pTexture->bLoaded == true)
+			callback(*pTexture);
+		else
+			pTexture->vWaiting.push_back(std::make_pair(pOwner, callback));
+		return pTexture;
+	}
+
+	STexture* pTexture = new STexture();
+	pTexture->sKey = sKey;
+	pTexture->sFilePath = sFilePath;
+	pTexture->bInvert = bInvert;
+	pTexture->uiTextureID = 0;
+	pTexture->uiMemorySize = 0;
+	// The loading holds a reference too, so that the texture is not deleted before it is uploaded
+	pTexture->uiRefCount = 2;
+	pTexture->bLoaded = false;
+	pTexture->vWaiting.push_back(std::make_pair(pOwner, callback));
+	mTextures[sKey] = pTexture;
+
+	CAssetLoader::GetInstance()->LoadTexture(sFilePath, bInvert, [this, pTexture](const GLuint uiTextureID)
+	{
+		// Discard this texture if the texture was already loaded now by the other AcquireTexture
+		if (pTexture->bLoaded == true)
+		{
+			if (uiTextureID != 0)
+				glDeleteTextures(1, &uiTextureID);
+		}
+		else
+		{
+			SetLoaded(pTexture, uiTextureID);
+		}
+
+		Release(pTexture);
+	});
+
+	return pTexture;
+}
+
+/**
+ @brief Release a texture. It is deleted when it is not used anymore.
+ @param pTexture A STexture* variable containing the texture
+ @param pOwner A const void* variable containing the owner which acquired the texture. If its callback is still
+		waiting for the texture to be loaded, then it is removed, so that it is not called after this.
+ */
+void CAssetRegistry::Release(STexture* pTexture, const void* pOwner)
+{
+	if ((pTexture == NULL) || (pTexture->uiRefCount == 0))
+		return;
+
+	if (pOwner != NULL)
+	{
+		for (unsigned int i = 0; i < pTexture->vWaiting.size(); i++)
+		{
+			if (pTexture->vWaiting[i].first == pOwner)
+			{
+				pTexture->vWaiting.erase(pTexture->vWaiting.begin() + i);
+				break;
+			}
+		}
+	}
+
+	pTexture->uiRefCount--;
+	if (pTexture->uiRefCount > 0)
+		return;
+
+	mTextures.erase(pTexture->sKey);
+	DeleteTexture(pTexture);
+	delete pTexture;
+}
+
+/**
+ @brief Get the number of bytes which are used by all the meshes and textures
+ @return An unsigned int variable containing the number of bytes
+ */
+unsigned int CAssetRegistry::GetMemorySize(void) const
+{
+	unsigned int uiMemorySize = 0;
+	for (std::map<std::string, SMesh*>::const_iterator it = mMeshes.begin(); it != mMeshes.end(); ++it)
+		uiMemorySize += it->second->uiMemorySize;
+	for (std::map<std::string, STexture*>::const_iterator it = mTextures.begin(); it != mTextures.end(); ++it)
+		uiMemorySize += it->second->uiMemorySize;
+
+	return uiMemorySize;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CAssetRegistry::PrintSelf(void)
+{
+	cout << "CAssetRegistry::PrintSelf()" << endl;
+	cout << "Number of meshes: " << mMeshes.size() << endl;
+	for (std::map<std::string, SMesh*>::iterator it = mMeshes.begin(); it != mMeshes.end(); ++it)
+	{
+		const SMesh* pMesh = it->second;
+		cout << "\t" << pMesh->sKey << ": " << (pMesh->bLoaded == true ? "resident" : "loading")
+			<< ", references = " << pMesh->uiRefCount << ", bytes = " << pMesh->uiMemorySize << endl;
+	}
+	cout << "Number of textures: " << mTextures.size() << endl;
+	for (std::map<std::string, STexture*>::iterator it = mTextures.begin(); it != mTextures.end(); ++it)
+	{
+		const STexture* pTexture = it->second;
+		cout << "\t" << pTexture->sKey << ": " << (pTexture->bLoaded == true ? "resident" : "loading")
+			<< ", references = " << pTexture->uiRefCount << ", bytes = " << pTexture->uiMemorySize << endl;
+	}
+	cout << "Total bytes: " << GetMemorySize() << endl;
+}
+
+/**
+ @brief Upload a mesh which was loaded from an OBJ file, and call the callbacks which are waiting for it
+ @param pMesh A SMesh* variable containing the mesh
+ @param sMeshData A const CAssetLoader::SMeshData& variable containing the vertices and indices of the mesh
+ */
+void CAssetRegistry::UploadModel(SMesh* pMesh, const CAssetLoader::SMeshData& sMeshData)
+{
+	if ((sMeshData.bSuccess == true) && (sMeshData.uiNumOfIndices > 0))
+	{
+		glGenVertexArrays(1, &pMesh->uiVAO);
+		glBindVertexArray(pMesh->uiVAO);
+		glGenBuffers(1, &pMesh->uiVBO);
+		glGenBuffers(1, &pMesh->uiIBO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, pMesh->uiVBO);
+		glBufferData(GL_ARRAY_BUFFER, sMeshData.GetVertexBufferSize(), sMeshData.pVertices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pMesh->uiIBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sMeshData.GetIndexBufferSize(), sMeshData.pIndices, GL_STATIC_DRAW);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		pMesh->uiNumOfIndices = sMeshData.uiNumOfIndices;
+		pMesh->eIndexType = sMeshData.eIndexType;
+		pMesh->vec3BoundsMin = sMeshData.vec3BoundsMin;
+		pMesh->vec3BoundsMax = sMeshData.vec3BoundsMax;
+		pMesh->uiMemorySize = (unsigned int)(sMeshData.GetVertexBufferSize() + sMeshData.GetIndexBufferSize());
+	}
+	pMesh->bLoaded = true;
+
+	std::vector<std::pair<const void*, MESHCALLBACK> > vWaiting;
+	vWaiting.swap(pMesh->vWaiting);
+	for (unsigned int i = 0; i < vWaiting.size(); i++)
+		vWaiting[i].second(*pMesh);
+}
+
+/**
+ @brief Delete the objects of a mesh in the graphics card
+ @param pMesh A SMesh* variable containing the mesh
+ */
+void CAssetRegistry::DeleteMesh(SMesh* pMesh)
+{
+	if (pMesh->p3DMesh)
+	{
+		delete pMesh->p3DMesh;
+		pMesh->p3DMesh = NULL;
+	}
+	if (pMesh->uiIBO != 0)
+		glDeleteBuffers(1, &pMesh->uiIBO);
+	if (pMesh->uiVBO != 0)
+		glDeleteBuffers(1, &pMesh->uiVBO);
+	if (pMesh->uiVAO != 0)
+		glDeleteVertexArrays(1, &pMesh->uiVAO);
+	pMesh->uiVAO = pMesh->uiVBO = pMesh->uiIBO = 0;
+}
+
+/**
+ @brief Delete a texture in the graphics card
+ @param pTexture A STexture* variable containing the texture
+ */
+void CAssetRegistry::DeleteTexture(STexture* pTexture)
+{
+	if (pTexture->uiTextureID != 0)
+		glDeleteTextures(1, &pTexture->uiTextureID);
+	pTexture->uiTextureID = 0;
+}
+
+/**
+ @brief Load a texture now. It is a compressed texture if the image can be cooked.
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @return A GLuint variable containing the texture ID, or 0 if the image could not be loaded
+ */
+GLuint CAssetRegistry::LoadTextureNow(const std::string& sFilePath, const bool bInvert)
+{
+	GLuint uiTextureID = 0;
+
+	// Upload the compressed texture, and cook it if it was not cooked yet
+	if (CTextureCache::IsSupported() == true)
+	{
+		CTextureCache::SMappedTexture sMappedTexture;
+		if ((CTextureCache::Open(sFilePath, bInvert, false, sMappedTexture) == true) ||
+			((CTextureCache::Cook(sFilePath, bInvert, false) == true) &&
+			 (CTextureCache::Open(sFilePath, bInvert, false, sMappedTexture) == true)))
+		{
+			uiTextureID = CTextureCache::CreateTexture(sMappedTexture);
+		}
+		CTextureCache::Close(sMappedTexture);
+	}
+	// Upload the decoded pixels if the image could not be cooked
+	if (uiTextureID == 0)
+		uiTextureID = CAssetLoader::GetInstance()->LoadTextureGetID(sFilePath.c_str(), bInvert);
+
+	return uiTextureID;
+}
+
+/**
+ @brief Set the texture of a STexture which is loaded, and call the callbacks which are waiting for it
+ @param pTexture A STexture* variable containing the texture
+ @param uiTextureID A const GLuint variable containing the texture ID, or 0 if the loading had failed
+ */
+void CAssetRegistry::SetLoaded(STexture* pTexture, const GLuint uiTextureID)
+{
+	pTexture->uiTextureID = uiTextureID;
+	pTexture->uiMemorySize = GetTextureMemorySize(uiTextureID);
+	pTexture->bLoaded = true;
+
+	std::vector<std::pair<const void*, TEXTURECALLBACK> > vWaiting;
+	vWaiting.swap(pTexture->vWaiting);
+	for (unsigned int i = 0; i < vWaiting.size(); i++)
+		vWaiting[i].second(*pTexture);
+}
+
+/**
+ @brief Get the number of bytes which are used by the vertex and index buffers which are bound now.
+		This is used to measure a mesh which was created by the CMeshBuilder.
+ @return An unsigned int variable containing the number of bytes
+ */
+unsigned int CAssetRegistry::GetBoundBufferSize(void)
+{
+	unsigned int uiMemorySize = 0;
+	GLint iBuffer = 0, iSize = 0;
+
+	glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &iBuffer);
+	if (iBuffer != 0)
+	{
+		glGetBufferParameteriv(GL_ARRAY_BUFFER, GL_BUFFER_SIZE, &iSize);
+		uiMemorySize += (unsigned int)iSize;
+	}
+
+	iBuffer = 0;
+	iSize = 0;
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &iBuffer);
+	if (iBuffer != 0)
+	{
+		glGetBufferParameteriv(GL_ELEMENT_ARRAY_BUFFER, GL_BUFFER_SIZE, &iSize);
+		uiMemorySize += (unsigned int)iSize;
+	}
+
+	return uiMemorySize;
+}
+
+/**
+ @brief Get the number of bytes which are used by a texture, including its mipmaps
+ @param uiTextureID A const GLuint variable containing the texture ID
+ @return An unsigned int variable containing the number of bytes
+ */
+unsigned int CAssetRegistry::GetTextureMemorySize(const GLuint uiTextureID)
+{
+	if (uiTextureID == 0)
+		return 0;
+
+	unsigned int uiMemorySize = 0;
+	glBindTexture(GL_TEXTURE_2D, uiTextureID);
+	for (GLint iLevel = 0; iLevel < 16; iLevel++)
+	{
+		GLint iWidth = 0, iHeight = 0, iCompressed = GL_FALSE, iFormat = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_WIDTH, &iWidth);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_HEIGHT, &iHeight);
+		if ((iWidth == 0) || (iHeight == 0))
+			break;
+
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_COMPRESSED, &iCompressed);
+		if (iCompressed == GL_TRUE)
+		{
+			GLint iSize = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &iSize);
+			uiMemorySize += (unsigned int)iSize;
+			continue;
+		}
+
+		// Estimate the number of bytes of each texel from the internal format
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, iLevel, GL_TEXTURE_INTERNAL_FORMAT, &iFormat);
+		unsigned int uiBytesPerTexel = 4;
+		if ((iFormat == GL_RGB) || (iFormat == GL_RGB8))
+			uiBytesPerTexel = 3;
+		else if ((iFormat == GL_RED) || (iFormat == GL_R8))
+			uiBytesPerTexel = 1;
+		uiMemorySize += (unsigned int)(iWidth * iHeight) * uiBytesPerTexel;
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return uiMemorySize;
+}
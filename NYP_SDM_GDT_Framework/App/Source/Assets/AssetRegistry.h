@@ -0,0 +1,139 @@
+/**
+ CAssetRegistry
+ @brief This class shares the meshes and textures between the entities. A mesh is keyed by its
+		recipe, such as the colour and size of a box, or by the path of its OBJ file. A texture is
+		keyed by its path and whether it is flipped. Each asset is created once, when it is acquired
+		for the first time, and is deleted when the last entity which acquired it releases it.
+		The entities keep the pointers which are returned as handles, and must release each of them once.
+		An entity which acquires an asset in the background passes itself as the owner of its callback,
+		and releases the asset with the same owner, so that its callback is not called after it is released.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include CMesh
+#include "Primitives/Mesh.h"
+
+// Include CAssetLoader
+#include "AssetLoader.h"
+
+#include <string>
+#include <map>
+#include <vector>
+#include <utility>
+#include <functional>
+
+class CAssetRegistry : public CSingletonTemplate<CAssetRegistry>
+{
+	friend class CSingletonTemplate<CAssetRegistry>;
+
+public:
+	// A shared mesh. Its VAO is 0 until it is loaded, or if the loading had failed.
+	struct SMesh;
+	// A shared texture. Its texture ID is 0 until it is loaded, or if the loading had failed.
+	struct STexture;
+
+	// The callback which receives a mesh on the main thread when it is loaded
+	typedef std::function<void(const SMesh& sMesh)> MESHCALLBACK;
+	// The callback which receives a texture on the main thread when it is loaded
+	typedef std::function<void(const STexture& sTexture)> TEXTURECALLBACK;
+	// The function which creates a mesh using the CMeshBuilder, while the VAO of the mesh is bound
+	typedef std::function<CMesh*(void)> MESHBUILDER;
+
+	struct SMesh
+	{
+		std::string sKey;
+		GLuint uiVAO, uiVBO, uiIBO;
+		// The mesh which was created by the CMeshBuilder, or NULL if the mesh was loaded from an OBJ file
+		CMesh* p3DMesh;
+		unsigned int uiNumOfIndices;
+		GLenum eIndexType;
+		glm::vec3 vec3BoundsMin, vec3BoundsMax;
+		// The number of bytes which are used by the buffers of this mesh
+		unsigned int uiMemorySize;
+		// The number of entities which acquired this mesh
+		unsigned int uiRefCount;
+		bool bLoaded;
+		// The callbacks which are waiting for this mesh to be loaded, and their owners
+		std::vector<std::pair<const void*, MESHCALLBACK> > vWaiting;
+	};
+
+	struct STexture
+	{
+		std::string sKey;
+		std::string sFilePath;
+		bool bInvert;
+		GLuint uiTextureID;
+		// The number of bytes which are used by this texture, including its mipmaps
+		unsigned int uiMemorySize;
+		// The number of entities which acquired this texture
+		unsigned int uiRefCount;
+		bool bLoaded;
+		// The callbacks which are waiting for this texture to be loaded, and their owners
+		std::vector<std::pair<const void*, TEXTURECALLBACK> > vWaiting;
+	};
+
+	// Initialise this class instance
+	bool Init(void);
+	// Delete all the assets
+	void Exit(void);
+
+	// Acquire a mesh which is created by a builder. The builder is only called if the mesh is not created yet.
+	SMesh* AcquireMesh(const std::string& sKey, const MESHBUILDER& builder);
+	// Acquire a box which is created by the CMeshBuilder
+	SMesh* AcquireBox(	const glm::vec4& vec4Colour,
+						const float fLength = 1.0f, const float fWidth = 1.0f, const float fHeight = 1.0f);
+	// Acquire a mesh which is loaded from an OBJ file in the background
+	SMesh* AcquireModel(const std::string& sFilePath, const void* pOwner, const MESHCALLBACK& callback);
+	// Release a mesh, and remove the callback of the owner if it is still waiting. It is deleted when it is not used anymore.
+	void Release(SMesh* pMesh, const void* pOwner = NULL);
+
+	// Acquire a texture which is loaded now, even if it is still being loaded in the background
+	STexture* AcquireTexture(const std::string& sFilePath, const bool bInvert);
+	// Acquire a texture which is loaded in the background
+	STexture* AcquireTexture(const std::string& sFilePath, const bool bInvert, const void* pOwner, const TEXTURECALLBACK& callback);
+	// Release a texture, and remove the callback of the owner if it is still waiting. It is deleted when it is not used anymore.
+	void Release(STexture* pTexture, const void* pOwner = NULL);
+
+	// Get the number of bytes which are used by all the meshes and textures
+	unsigned int GetMemorySize(void) const;
+
+	// PrintSelf
+	void PrintSelf(void);
+
+protected:
+	// The meshes and the textures, keyed by their recipes or paths
+	std::map<std::string, SMesh*> mMeshes;
+	std::map<std::string, STexture*> mTextures;
+
+	// Upload a mesh which was loaded from an OBJ file
+	void UploadModel(SMesh* pMesh, const CAssetLoader::SMeshData& sMeshData);
+	// Delete the objects of a mesh in the graphics card
+	void DeleteMesh(SMesh* pMesh);
+	// Delete a texture in the graphics card
+	void DeleteTexture(STexture* pTexture);
+	// Load a texture now, as a compressed texture if the image can be cooked
+	GLuint LoadTextureNow(const std::string& sFilePath, const bool bInvert);
+	// Set the texture of a STexture which is loaded, and call the callbacks which are waiting for it
+	void SetLoaded(STexture* pTexture, const GLuint uiTextureID);
+
+	// Get the number of bytes which are used by the buffers which are bound now
+	static unsigned int GetBoundBufferSize(void);
+	// Get the number of bytes which are used by a texture, including its mipmaps
+	static unsigned int GetTextureMemorySize(const GLuint uiTextureID);
+
+	// Default Constructor
+	CAssetRegistry(void);
+	// Destructor
+	virtual ~CAssetRegistry(void);
+};
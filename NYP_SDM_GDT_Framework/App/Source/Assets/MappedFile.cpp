@@ -0,0 +1,266 @@
+/**
+ CMappedFile
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "MappedFile.h"
+
+// Include stdio and stat for reading the files
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// Include thread and sstream for the names of the temporary files
+#include <thread>
+#include <sstream>
+
+// Include Windows for the memory-mapped files, without the min and max macros
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+/**
+ @brief Constructor
+ */
+CMappedFile::CMappedFile(void)
+	: pView(NULL)
+	, uiSize(0)
+	, hFile(NULL)
+	, hMapping(NULL)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CMappedFile::~CMappedFile(void)
+{
+	Close();
+}
+
+/**
+ @brief Map a file into memory. The file is read into memory if memory-mapped files are not supported.
+ @param sFilePath A const std::string& variable containing the path of the file
+ @return A bool variable which is true if the file is mapped
+ */
+bool CMappedFile::Open(const std::string& sFilePath)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE hNewFile = CreateFileA(sFilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hNewFile == INVALID_HANDLE_VALUE)
+		return false;
+	hFile = hNewFile;
+
+	LARGE_INTEGER liFileSize;
+	if ((GetFileSizeEx(hNewFile, &liFileSize) == 0) || (liFileSize.QuadPart == 0))
+	{
+		Close();
+		return false;
+	}
+	uiSize = (size_t)liFileSize.QuadPart;
+
+	hMapping = CreateFileMappingA(hNewFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMapping != NULL)
+		pView = MapViewOfFile((HANDLE)hMapping, FILE_MAP_READ, 0, 0, 0);
+#else
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return false;
+
+	fseek(pFile, 0, SEEK_END);
+	const long lFileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+	if (lFileSize > 0)
+	{
+		uiSize = (size_t)lFileSize;
+		pView = malloc(uiSize);
+		if ((pView) && (fread(pView, 1, uiSize, pFile) != uiSize))
+		{
+			free(pView);
+			pView = NULL;
+		}
+	}
+	fclose(pFile);
+#endif
+
+	if (pView == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ @brief Unmap the file
+ */
+void CMappedFile::Close(void)
+{
+#ifdef _WIN32
+	if (pView)
+		UnmapViewOfFile(pView);
+	if (hMapping)
+		CloseHandle((HANDLE)hMapping);
+	if (hFile)
+		CloseHandle((HANDLE)hFile);
+#else
+	free(pView);
+#endif
+
+	pView = NULL;
+	uiSize = 0;
+	hFile = NULL;
+	hMapping = NULL;
+}
+
+/**
+ @brief Check if a file is mapped
+ @return A bool variable which is true if a file is mapped
+ */
+bool CMappedFile::IsOpen(void) const
+{
+	return (pView != NULL);
+}
+
+/**
+ @brief Get the contents of the file
+ @return A const unsigned char* variable pointing to the contents of the file, or NULL if no file is mapped
+ */
+const unsigned char* CMappedFile::GetData(void) const
+{
+	return (const unsigned char*)pView;
+}
+
+/**
+ @brief Get the size of the file in bytes
+ @return A size_t variable containing the size of the file
+ */
+size_t CMappedFile::GetSize(void) const
+{
+	return uiSize;
+}
+
+/**
+ @brief Get the key of a source file
+ @param sFilePath A const std::string& variable containing the path of the source file
+ @param sSourceKey A SSourceKey& variable to store the key
+ @return A bool variable which is true if the source file was read
+ */
+bool CMappedFile::GetSourceKey(const std::string& sFilePath, SSourceKey& sSourceKey)
+{
+	return ((GetFileInfo(sFilePath, sSourceKey.ullSize, sSourceKey.llTime) == true) &&
+			(GetFileHash(sFilePath, sSourceKey.ullHash) == true));
+}
+
+/**
+ @brief Check if a source file is unchanged since its key was taken. Its contents are only
+		hashed if it was touched. If the source file does not exist, then it is treated as
+		unchanged, so that the cooked files can be shipped without the source files.
+ @param sFilePath A const std::string& variable containing the path of the source file
+ @param sSourceKey A const SSourceKey& variable containing the key which was stored in the cooked file
+ @return A bool variable which is true if the cooked file can be used
+ */
+bool CMappedFile::IsSourceUnchanged(const std::string& sFilePath, const SSourceKey& sSourceKey)
+{
+	unsigned long long ullSize = 0;
+	long long llTime = 0;
+	if (GetFileInfo(sFilePath, ullSize, llTime) == false)
+		return true;
+	if (ullSize != sSourceKey.ullSize)
+		return false;
+	if (llTime == sSourceKey.llTime)
+		return true;
+
+	// The source file was touched, so check if its contents were changed
+	unsigned long long ullHash = 0;
+	return ((GetFileHash(sFilePath, ullHash) == true) && (ullHash == sSourceKey.ullHash));
+}
+
+/**
+ @brief Get the path of a temporary file to write a cooked file to. It is unique to the calling
+		thread, so that the threads which are cooking the same file do not write to the same file.
+ @param sFilePath A const std::string& variable containing the path of the cooked file
+ @return A std::string variable containing the path of the temporary file
+ */
+std::string CMappedFile::GetTempPath(const std::string& sFilePath)
+{
+	std::ostringstream ssTempPath;
+	ssTempPath << sFilePath << "." << std::hash<std::thread::id>()(std::this_thread::get_id()) << ".tmp";
+	return ssTempPath.str();
+}
+
+/**
+ @brief Replace a file with a temporary file. This fails if another thread has mapped the file,
+		and then the temporary file is deleted and the old file is kept.
+ @param sTempPath A const std::string& variable containing the path of the temporary file
+ @param sFilePath A const std::string& variable containing the path of the file to replace
+ @return A bool variable which is true if the file was replaced
+ */
+bool CMappedFile::ReplaceFile(const std::string& sTempPath, const std::string& sFilePath)
+{
+#ifdef _WIN32
+	const bool bResult = (MoveFileExA(sTempPath.c_str(), sFilePath.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+	const bool bResult = (rename(sTempPath.c_str(), sFilePath.c_str()) == 0);
+#endif
+	if (bResult == false)
+		remove(sTempPath.c_str());
+
+	return bResult;
+}
+
+/**
+ @brief Get the size and modification time of a file
+ @param sFilePath A const std::string& variable containing the path of the file
+ @param ullSize An unsigned long long& variable to store the size of the file
+ @param llTime A long long& variable to store the modification time of the file
+ @return A bool variable which is true if the file exists
+ */
+bool CMappedFile::GetFileInfo(const std::string& sFilePath, unsigned long long& ullSize, long long& llTime)
+{
+	struct stat sStat;
+	if (stat(sFilePath.c_str(), &sStat) != 0)
+		return false;
+
+	ullSize = (unsigned long long)sStat.st_size;
+	llTime = (long long)sStat.st_mtime;
+	return true;
+}
+
+/**
+ @brief Calculate the FNV-1a hash of the contents of a file
+ @param sFilePath A const std::string& variable containing the path of the file
+ @param ullHash An unsigned long long& variable to store the hash
+ @return A bool variable which is true if the file was read
+ */
+bool CMappedFile::GetFileHash(const std::string& sFilePath, unsigned long long& ullHash)
+{
+	FILE* pFile = fopen(sFilePath.c_str(), "rb");
+	if (pFile == NULL)
+		return false;
+
+	ullHash = 14695981039346656037ULL;
+	unsigned char arrBuffer[65536];
+	size_t uiNumOfBytes = 0;
+	while ((uiNumOfBytes = fread(arrBuffer, 1, sizeof(arrBuffer), pFile)) > 0)
+	{
+		for (size_t i = 0; i < uiNumOfBytes; i++)
+		{
+			ullHash ^= arrBuffer[i];
+			ullHash *= 1099511628211ULL;
+		}
+	}
+	fclose(pFile);
+
+	return true;
+}
@@ -0,0 +1,67 @@
+/**
+ CMappedFile
+ @brief This class maps a file into memory, so that its contents can be read without copying them.
+		It also has the helpers which are shared by the caches of the cooked assets, which check if
+		a cooked file is still up to date with the source file which it was cooked from.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+#include <string>
+
+class CMappedFile
+{
+public:
+	// The key of a source file, which is stored in the cooked file to check if the source file was changed
+	struct SSourceKey
+	{
+		unsigned long long ullSize;
+		long long llTime;
+		unsigned long long ullHash;
+	};
+
+	// Constructor
+	CMappedFile(void);
+	// Destructor, which unmaps the file if it is still mapped
+	~CMappedFile(void);
+
+	// A mapped file is not copied, because only one instance may unmap it
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+
+	// Map a file into memory
+	bool Open(const std::string& sFilePath);
+	// Unmap the file
+	void Close(void);
+
+	// Check if a file is mapped
+	bool IsOpen(void) const;
+	// Get the contents of the file
+	const unsigned char* GetData(void) const;
+	// Get the size of the file in bytes
+	size_t GetSize(void) const;
+
+	// Get the key of a source file
+	static bool GetSourceKey(const std::string& sFilePath, SSourceKey& sSourceKey);
+	// Check if a source file is unchanged since its key was taken
+	static bool IsSourceUnchanged(const std::string& sFilePath, const SSourceKey& sSourceKey);
+
+	// Get the path of a temporary file to write a cooked file to
+	static std::string GetTempPath(const std::string& sFilePath);
+	// Replace a file with a temporary file
+	static bool ReplaceFile(const std::string& sTempPath, const std::string& sFilePath);
+
+protected:
+	// The mapped view of the file, and its size
+	void* pView;
+	size_t uiSize;
+	// The handles of the file and the mapping
+	void* hFile;
+	void* hMapping;
+
+	// Get the size and modification time of a file
+	static bool GetFileInfo(const std::string& sFilePath, unsigned long long& ullSize, long long& llTime);
+	// Calculate the FNV-1a hash of the contents of a file
+	static bool GetFileHash(const std::string& sFilePath, unsigned long long& ullHash);
+};
@@ -0,0 +1,415 @@
+/**
+ CMaterialTable
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "MaterialTable.h"
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include CAssetLoader
+#include "AssetLoader.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CMaterialTable::CMaterialTable(void)
+	: bCompressed(true)
+	, bBuilt(false)
+{
+}
+
+/**
+ @brief Destructor. The texture arrays are not deleted here, since the OpenGL context may be
+		destroyed already when a global material table is destroyed. Call Exit to delete them.
+ */
+CMaterialTable::~CMaterialTable(void)
+{
+	FreeSources();
+}
+
+/**
+ @brief Set if the textures are compressed when the images can be cooked. It must be set before the materials are added.
+ @param bCompressed A const bool variable which is true if the textures are to be compressed
+ */
+void CMaterialTable::SetCompressed(const bool bCompressed)
+{
+	this->bCompressed = bCompressed;
+}
+
+/**
+ @brief Add a material which uses the texture in an image file. The texture is loaded now, and is
+		uploaded when the table is built. It is compressed if compression is enabled and the image can be cooked.
+ @param sName A const std::string& variable containing the name of the material
+ @param sFilePath A const std::string& variable containing the path of the image file
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @param bSwapRedBlue A const bool variable which is true if the red and blue channels of an RGB image are to be swapped
+ @return An int variable containing the index of the material, or -1 if the image could not be loaded
+ */
+int CMaterialTable::Add(const std::string& sName, const std::string& sFilePath, const bool bInvert, const bool bSwapRedBlue)
+{
+	if (bBuilt == true)
+	{
+		cout << "Unable to add the material " << sName << " after the material table is built" << endl;
+		return -1;
+	}
+
+	std::map<std::string, int>::const_iterator it = mMaterialIndices.find(sName);
+	if (it != mMaterialIndices.end())
+		return it->second;
+
+	SSource sSource;
+	sSource.pData = NULL;
+	sSource.iWidth = 0;
+	sSource.iHeight = 0;
+	sSource.iNumOfChannels = 0;
+	sSource.bSwapRedBlue = bSwapRedBlue;
+	sSource.pCompressed = NULL;
+
+	// Use the cooked texture, and cook the image if it was not cooked yet
+	if ((bCompressed == true) && (CTextureCache::IsSupported() == true))
+	{
+		CTextureCache::SMappedTexture* pMappedTexture = new CTextureCache::SMappedTexture();
+		if ((CTextureCache::Open(sFilePath, bInvert, bSwapRedBlue, *pMappedTexture) == true) ||
+			((CTextureCache::Cook(sFilePath, bInvert, bSwapRedBlue) == true) &&
+			 (CTextureCache::Open(sFilePath, bInvert, bSwapRedBlue, *pMappedTexture) == true)))
+		{
+			sSource.pCompressed = pMappedTexture;
+			sSource.iWidth = (int)pMappedTexture->pHeader->uiWidth;
+			sSource.iHeight = (int)pMappedTexture->pHeader->uiHeight;
+			sSource.iNumOfChannels = (int)pMappedTexture->pHeader->uiNumOfChannels;
+		}
+		else
+		{
+			delete pMappedTexture;
+		}
+	}
+
+	// Use the decoded pixels if the image could not be cooked
+	if (sSource.pCompressed == NULL)
+	{
+		sSource.pData = CAssetLoader::GetInstance()->DecodeImage(	sFilePath.c_str(),
+																	sSource.iWidth, sSource.iHeight, sSource.iNumOfChannels,
+																	bInvert);
+		if (sSource.pData == NULL)
+		{
+			cout << "Unable to load " << sFilePath << endl;
+			return -1;
+		}
+
+		// Expand a luminance image to RGB, and a luminance-alpha image to RGBA. Otherwise they are
+		// uploaded as GL_RED or GL_RG into the RGBA8 array, and become red instead of grey.
+		if ((sSource.iNumOfChannels == 1) || (sSource.iNumOfChannels == 2))
+		{
+			const int iNumOfChannels = sSource.iNumOfChannels + 2;
+			const size_t uiNumOfPixels = (size_t)sSource.iWidth * sSource.iHeight;
+			unsigned char* pExpanded = (unsigned char*)malloc(uiNumOfPixels * iNumOfChannels);
+			if (pExpanded == NULL)
+			{
+				cout << "Unable to expand " << sFilePath << endl;
+				free(sSource.pData);
+				return -1;
+			}
+			for (size_t i = 0; i < uiNumOfPixels; i++)
+			{
+				const unsigned char* pSourcePixel = sSource.pData + i * sSource.iNumOfChannels;
+				unsigned char* pExpandedPixel = pExpanded + i * iNumOfChannels;
+				pExpandedPixel[0] = pSourcePixel[0];
+				pExpandedPixel[1] = pSourcePixel[0];
+				pExpandedPixel[2] = pSourcePixel[0];
+				if (iNumOfChannels == 4)
+					pExpandedPixel[3] = pSourcePixel[1];
+			}
+			free(sSource.pData);
+			sSource.pData = pExpanded;
+			sSource.iNumOfChannels = iNumOfChannels;
+		}
+	}
+
+	SMaterial sMaterial;
+	sMaterial.sName = sName;
+	sMaterial.uiArray = 0;
+	sMaterial.uiLayer = 0;
+
+	const int iMaterial = (int)vMaterials.size();
+	vMaterials.push_back(sMaterial);
+	vSources.push_back(sSource);
+	mMaterialIndices[sName] = iMaterial;
+
+	return iMaterial;
+}
+
+/**
+ @brief Create the texture arrays and upload the textures of all the materials.
+		The textures which have the same size and format share a texture array.
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CMaterialTable::Build(void)
+{
+	if (bBuilt == true)
+		return true;
+
+	for (unsigned int i = 0; i < vSources.size(); i++)
+	{
+		const SSource& sSource = vSources[i];
+		const GLenum eFormat = (sSource.pCompressed ? sSource.pCompressed->pHeader->uiFormat : GL_RGBA8);
+
+		// Find the texture array which has the same size and format
+		unsigned int uiArray = 0;
+		while ((uiArray < vArrays.size()) &&
+			   ((vArrays[uiArray].iWidth != sSource.iWidth) ||
+				(vArrays[uiArray].iHeight != sSource.iHeight) ||
+				(vArrays[uiArray].eFormat != eFormat)))
+		{
+			uiArray++;
+		}
+		if (uiArray == vArrays.size())
+		{
+			SArray sArray;
+			sArray.uiTextureID = 0;
+			sArray.iWidth = sSource.iWidth;
+			sArray.iHeight = sSource.iHeight;
+			sArray.eFormat = eFormat;
+			sArray.uiNumOfLayers = 0;
+			if (sSource.pCompressed)
+			{
+				sArray.uiNumOfLevels = sSource.pCompressed->pHeader->uiNumOfLevels;
+			}
+			else
+			{
+				sArray.uiNumOfLevels = 1;
+				for (int w = sSource.iWidth, h = sSource.iHeight; (w > 1) || (h > 1); w = std::max(1, w / 2), h = std::max(1, h / 2))
+					sArray.uiNumOfLevels++;
+			}
+			vArrays.push_back(sArray);
+		}
+
+		vMaterials[i].uiArray = uiArray;
+		vMaterials[i].uiLayer = vArrays[uiArray].uiNumOfLayers;
+		vArrays[uiArray].uiNumOfLayers++;
+	}
+
+	for (unsigned int i = 0; i < vArrays.size(); i++)
+	{
+		UploadArray(i);
+	}
+
+	FreeSources();
+	bBuilt = true;
+
+	return true;
+}
+
+/**
+ @brief Delete the texture arrays and the materials
+ */
+void CMaterialTable::Exit(void)
+{
+	for (unsigned int i = 0; i < vArrays.size(); i++)
+	{
+		glDeleteTextures(1, &vArrays[i].uiTextureID);
+	}
+	vArrays.clear();
+
+	FreeSources();
+	vMaterials.clear();
+	mMaterialIndices.clear();
+	bBuilt = false;
+}
+
+/**
+ @brief Check if the texture arrays were created
+ @return A bool variable which is true if the table is built
+ */
+bool CMaterialTable::IsBuilt(void) const
+{
+	return bBuilt;
+}
+
+/**
+ @brief Get the index of a material by its name
+ @param sName A const std::string& variable containing the name of the material
+ @return An int variable containing the index of the material, or -1 if it is not found
+ */
+int CMaterialTable::GetMaterialIndex(const std::string& sName) const
+{
+	std::map<std::string, int>::const_iterator it = mMaterialIndices.find(sName);
+	if (it == mMaterialIndices.end())
+		return -1;
+
+	return it->second;
+}
+
+/**
+ @brief Get a material
+ @param uiMaterial A const unsigned int variable containing the index of the material
+ @return A const SMaterial& variable containing the material
+ */
+const CMaterialTable::SMaterial& CMaterialTable::GetMaterial(const unsigned int uiMaterial) const
+{
+	return vMaterials[uiMaterial];
+}
+
+/**
+ @brief Get the number of materials
+ @return An unsigned int variable containing the number of materials
+ */
+unsigned int CMaterialTable::GetNumOfMaterials(void) const
+{
+	return (unsigned int)vMaterials.size();
+}
+
+/**
+ @brief Get the texture ID of a texture array
+ @param uiArray A const unsigned int variable containing the index of the texture array
+ @return A GLuint variable containing the texture ID
+ */
+GLuint CMaterialTable::GetArrayID(const unsigned int uiArray) const
+{
+	return vArrays[uiArray].uiTextureID;
+}
+
+/**
+ @brief Get the number of texture arrays
+ @return An unsigned int variable containing the number of texture arrays
+ */
+unsigned int CMaterialTable::GetNumOfArrays(void) const
+{
+	return (unsigned int)vArrays.size();
+}
+
+/**
+ @brief Bind a texture array to a texture unit
+ @param uiArray A const unsigned int variable containing the index of the texture array
+ @param uiTextureUnit A const unsigned int variable containing the texture unit
+ */
+void CMaterialTable::Bind(const unsigned int uiArray, const unsigned int uiTextureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + uiTextureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, vArrays[uiArray].uiTextureID);
+}
+
+/**
+ @brief Unbind the texture array from a texture unit
+ @param uiTextureUnit A const unsigned int variable containing the texture unit
+ */
+void CMaterialTable::Unbind(const unsigned int uiTextureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + uiTextureUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/**
+ @brief PrintSelf
+ */
+void CMaterialTable::PrintSelf(void)
+{
+	cout << "CMaterialTable::PrintSelf()" << endl;
+	cout << "Number of materials: " << vMaterials.size() << endl;
+	cout << "Number of texture arrays: " << vArrays.size() << endl;
+	for (unsigned int i = 0; i < vArrays.size(); i++)
+	{
+		cout << "Array " << i << ": " << vArrays[i].iWidth << " x " << vArrays[i].iHeight
+			 << ", " << vArrays[i].uiNumOfLayers << " layers, "
+			 << (vArrays[i].eFormat == GL_RGBA8 ? "uncompressed" : "compressed") << endl;
+	}
+}
+
+/**
+ @brief Upload the textures of the materials into a texture array. The compressed textures are
+		uploaded with their cooked mipmaps, while the mipmaps of the other textures are generated.
+ @param uiArray A const unsigned int variable containing the index of the texture array
+ */
+void CMaterialTable::UploadArray(const unsigned int uiArray)
+{
+	SArray& sArray = vArrays[uiArray];
+
+	glGenTextures(1, &sArray.uiTextureID);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, sArray.uiTextureID);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, sArray.uiNumOfLevels - 1);
+
+	if (sArray.eFormat != GL_RGBA8)
+	{
+		// Find a texture in this array, to get the sizes of the mipmap levels
+		unsigned int uiFirst = 0;
+		while (vMaterials[uiFirst].uiArray != uiArray)
+			uiFirst++;
+		const CTextureCache::SLevel* pLevels = vSources[uiFirst].pCompressed->pLevels;
+
+		for (unsigned int uiLevel = 0; uiLevel < sArray.uiNumOfLevels; uiLevel++)
+		{
+			const CTextureCache::SLevel& sLevel = pLevels[uiLevel];
+			glCompressedTexImage3D(	GL_TEXTURE_2D_ARRAY, uiLevel, sArray.eFormat,
+									sLevel.uiWidth, sLevel.uiHeight, sArray.uiNumOfLayers, 0,
+									sLevel.uiSize * sArray.uiNumOfLayers, NULL);
+			for (unsigned int i = uiFirst; i < vMaterials.size(); i++)
+			{
+				if (vMaterials[i].uiArray != uiArray)
+					continue;
+
+				glCompressedTexSubImage3D(	GL_TEXTURE_2D_ARRAY, uiLevel, 0, 0, vMaterials[i].uiLayer,
+											sLevel.uiWidth, sLevel.uiHeight, 1, sArray.eFormat,
+											sLevel.uiSize, vSources[i].pCompressed->GetLevelData(uiLevel));
+			}
+		}
+	}
+	else
+	{
+		glTexImage3D(	GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, sArray.iWidth, sArray.iHeight, sArray.uiNumOfLayers, 0,
+						GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+		// The rows of an RGB image may not be aligned to 4 bytes
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (unsigned int i = 0; i < vMaterials.size(); i++)
+		{
+			if (vMaterials[i].uiArray != uiArray)
+				continue;
+
+			const SSource& sSource = vSources[i];
+			// The luminance images were expanded to RGB or RGBA when they were added
+			GLenum eFormat = GL_RGBA;
+			if (sSource.iNumOfChannels == 3)
+				eFormat = (sSource.bSwapRedBlue == true ? GL_BGR : GL_RGB);
+
+			glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, vMaterials[i].uiLayer,
+							sSource.iWidth, sSource.iHeight, 1, eFormat, GL_UNSIGNED_BYTE, sSource.pData);
+		}
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+/**
+ @brief Free the textures which are waiting to be uploaded
+ */
+void CMaterialTable::FreeSources(void)
+{
+	for (unsigned int i = 0; i < vSources.size(); i++)
+	{
+		if (vSources[i].pData)
+		{
+			// Free up the memory of the file data read in
+			free(vSources[i].pData);
+		}
+		if (vSources[i].pCompressed)
+		{
+			CTextureCache::Close(*vSources[i].pCompressed);
+			delete vSources[i].pCompressed;
+		}
+	}
+	vSources.clear();
+}
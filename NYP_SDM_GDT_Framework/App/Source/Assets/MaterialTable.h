@@ -0,0 +1,112 @@
+/**
+ CMaterialTable
+ @brief This class packs the textures of a set of materials into texture arrays, so that the
+		materials can be drawn after binding one texture array instead of one texture per material.
+		The textures which have the same size and format are packed into the layers of the same
+		GL_TEXTURE_2D_ARRAY, and each material is given the index of its array and its layer.
+		The materials are added first, and then the table is built.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include CTextureCache
+#include "TextureCache.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+class CMaterialTable
+{
+public:
+	// A material, which is a layer in a texture array
+	struct SMaterial
+	{
+		std::string sName;
+		// The index of the texture array and the layer in it
+		unsigned int uiArray;
+		unsigned int uiLayer;
+	};
+
+	// Constructor
+	CMaterialTable(void);
+	// Destructor
+	~CMaterialTable(void);
+
+	// Set if the textures are compressed when the images can be cooked
+	void SetCompressed(const bool bCompressed);
+
+	// Add a material which uses the texture in an image file
+	int Add(const std::string& sName, const std::string& sFilePath, const bool bInvert, const bool bSwapRedBlue = false);
+	// Create the texture arrays and upload the textures of all the materials
+	bool Build(void);
+	// Delete the texture arrays and the materials
+	void Exit(void);
+
+	// Check if the texture arrays were created
+	bool IsBuilt(void) const;
+
+	// Get the index of a material by its name, or -1 if it is not found
+	int GetMaterialIndex(const std::string& sName) const;
+	// Get a material
+	const SMaterial& GetMaterial(const unsigned int uiMaterial) const;
+	// Get the number of materials
+	unsigned int GetNumOfMaterials(void) const;
+
+	// Get the texture ID of a texture array
+	GLuint GetArrayID(const unsigned int uiArray) const;
+	// Get the number of texture arrays
+	unsigned int GetNumOfArrays(void) const;
+
+	// Bind a texture array to a texture unit
+	void Bind(const unsigned int uiArray, const unsigned int uiTextureUnit) const;
+	// Unbind the texture array from a texture unit
+	void Unbind(const unsigned int uiTextureUnit) const;
+
+	// PrintSelf
+	void PrintSelf(void);
+
+protected:
+	// The texture of a material which is waiting to be uploaded
+	struct SSource
+	{
+		// The decoded pixels, or NULL if the texture is compressed
+		unsigned char* pData;
+		int iWidth, iHeight, iNumOfChannels;
+		bool bSwapRedBlue;
+		// The cooked texture if the texture is compressed
+		CTextureCache::SMappedTexture* pCompressed;
+	};
+
+	// A texture array, which has the same size and format for all its layers
+	struct SArray
+	{
+		GLuint uiTextureID;
+		int iWidth, iHeight;
+		// The compressed format, or GL_RGBA8 if the layers are not compressed
+		GLenum eFormat;
+		unsigned int uiNumOfLevels;
+		unsigned int uiNumOfLayers;
+	};
+
+	// Indicate if the textures are compressed when the images can be cooked
+	bool bCompressed;
+
+	// The materials, the textures which are waiting to be uploaded, and the texture arrays
+	std::vector<SMaterial> vMaterials;
+	std::vector<SSource> vSources;
+	std::vector<SArray> vArrays;
+	// The indices of the materials, keyed by their names
+	std::map<std::string, int> mMaterialIndices;
+
+	bool bBuilt;
+
+	// Upload the textures of the materials into a texture array
+	void UploadArray(const unsigned int uiArray);
+	// Free the textures which are waiting to be uploaded
+	void FreeSources(void);
+};
@@ -0,0 +1,214 @@
+/**
+ CMeshCache
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "MeshCache.h"
+
+// Include stdio for writing the files
+#include <stdio.h>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Get the path of the cooked mesh of an OBJ file
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @return A std::string variable containing the path of the cooked mesh
+ */
+std::string CMeshCache::GetCachePath(const std::string& sSourcePath)
+{
+	return sSourcePath + ".mesh";
+}
+
+/**
+ @brief Map the cooked mesh of an OBJ file into memory, if it exists and is not out of date
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @param sMappedMesh A SMappedMesh& variable to store the mapped mesh
+ @return A bool variable which is true if the cooked mesh is mapped
+ */
+bool CMeshCache::Open(const std::string& sSourcePath, SMappedMesh& sMappedMesh)
+{
+	Close(sMappedMesh);
+	if (sMappedMesh.cFile.Open(GetCachePath(sSourcePath)) == false)
+		return false;
+
+	if (IsValid(sSourcePath, sMappedMesh.cFile) == false)
+	{
+		Close(sMappedMesh);
+		return false;
+	}
+
+	const unsigned char* pData = sMappedMesh.cFile.GetData();
+	sMappedMesh.pHeader = (const SHeader*)pData;
+	sMappedMesh.pVertices = (const ModelVertex*)(pData + sizeof(SHeader));
+	sMappedMesh.pIndices = pData + sizeof(SHeader) + sMappedMesh.pHeader->uiNumOfVertices * sizeof(ModelVertex);
+
+	return true;
+}
+
+/**
+ @brief Unmap a cooked mesh
+ @param sMappedMesh A SMappedMesh& variable containing the mapped mesh
+ */
+void CMeshCache::Close(SMappedMesh& sMappedMesh)
+{
+	sMappedMesh.cFile.Close();
+	sMappedMesh.pHeader = NULL;
+	sMappedMesh.pVertices = NULL;
+	sMappedMesh.pIndices = NULL;
+}
+
+/**
+ @brief Cook a mesh which was loaded from an OBJ file, and write it next to the OBJ file.
+		The file is written to a temporary file first and then renamed, so that another thread
+		which is cooking or opening the same mesh never reads a partly written file.
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @param vVertices A const std::vector<ModelVertex>& variable containing the indexed vertices
+ @param vIndices A const std::vector<GLuint>& variable containing the indices
+ @param vec3BoundsMin A const glm::vec3& variable containing the minimum corner of the bounds
+ @param vec3BoundsMax A const glm::vec3& variable containing the maximum corner of the bounds
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CMeshCache::Cook(	const std::string& sSourcePath,
+						const std::vector<ModelVertex>& vVertices,
+						const std::vector<GLuint>& vIndices,
+						const glm::vec3& vec3BoundsMin,
+						const glm::vec3& vec3BoundsMax)
+{
+	if ((vVertices.empty() == true) || (vIndices.empty() == true))
+		return false;
+
+	SHeader sHeader;
+	sHeader.uiMagic = uiFileMagic;
+	sHeader.uiVersion = uiFileVersion;
+	if (CMappedFile::GetSourceKey(sSourcePath, sHeader.sSourceKey) == false)
+		return false;
+	sHeader.uiNumOfVertices = (unsigned int)vVertices.size();
+	sHeader.uiNumOfIndices = (unsigned int)vIndices.size();
+	// Use 16-bit indices if all the vertices can be indexed by them, to halve the size of the IBO
+	sHeader.uiIndexSize = (vVertices.size() <= 0x10000 ? sizeof(GLushort) : sizeof(GLuint));
+	sHeader.uiReserved = 0;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		sHeader.arrBoundsMin[i] = vec3BoundsMin[i];
+		sHeader.arrBoundsMax[i] = vec3BoundsMax[i];
+	}
+
+	const std::string sCachePath = GetCachePath(sSourcePath);
+	const std::string sTempPath = CMappedFile::GetTempPath(sCachePath);
+
+	FILE* pFile = fopen(sTempPath.c_str(), "wb");
+	if (pFile == NULL)
+		return false;
+
+	bool bResult = (fwrite(&sHeader, sizeof(SHeader), 1, pFile) == 1);
+	bResult = bResult && (fwrite(&vVertices[0], sizeof(ModelVertex), vVertices.size(), pFile) == vVertices.size());
+	if (sHeader.uiIndexSize == sizeof(GLushort))
+	{
+		std::vector<GLushort> vShortIndices(vIndices.begin(), vIndices.end());
+		bResult = bResult && (fwrite(&vShortIndices[0], sizeof(GLushort), vShortIndices.size(), pFile) == vShortIndices.size());
+	}
+	else
+	{
+		bResult = bResult && (fwrite(&vIndices[0], sizeof(GLuint), vIndices.size(), pFile) == vIndices.size());
+	}
+	bResult = (fclose(pFile) == 0) && bResult;
+
+	// Replace the old cooked mesh. This fails if another thread has mapped it, and then the old one is kept.
+	if (bResult == true)
+		bResult = CMappedFile::ReplaceFile(sTempPath, sCachePath);
+	else
+		remove(sTempPath.c_str());
+	if (bResult == false)
+	{
+		cout << "Unable to write the cooked mesh " << sCachePath << endl;
+	}
+
+	return bResult;
+}
+
+/**
+ @brief Load an OBJ file and cook it. This is used to cook the meshes offline.
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CMeshCache::Cook(const std::string& sSourcePath)
+{
+	std::vector<ModelVertex> vVertices;
+	std::vector<GLuint> vIndices;
+	glm::vec3 vec3BoundsMin, vec3BoundsMax;
+	if (LoadOBJ(sSourcePath, vVertices, vIndices, vec3BoundsMin, vec3BoundsMax) == false)
+		return false;
+
+	return Cook(sSourcePath, vVertices, vIndices, vec3BoundsMin, vec3BoundsMax);
+}
+
+/**
+ @brief Load and index an OBJ file, and calculate the bounds of the mesh
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @param vVertices A std::vector<ModelVertex>& variable to store the indexed vertices
+ @param vIndices A std::vector<GLuint>& variable to store the indices
+ @param vec3BoundsMin A glm::vec3& variable to store the minimum corner of the bounds
+ @param vec3BoundsMax A glm::vec3& variable to store the maximum corner of the bounds
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CMeshCache::LoadOBJ(	const std::string& sSourcePath,
+							std::vector<ModelVertex>& vVertices,
+							std::vector<GLuint>& vIndices,
+							glm::vec3& vec3BoundsMin,
+							glm::vec3& vec3BoundsMax)
+{
+	std::vector<glm::vec3> vertices;
+	std::vector<glm::vec2> uvs;
+	std::vector<glm::vec3> normals;
+	if (CLoadOBJ::LoadOBJ(sSourcePath.c_str(), vertices, uvs, normals, true) == false)
+		return false;
+
+	vec3BoundsMin = glm::vec3(0.0f);
+	vec3BoundsMax = glm::vec3(0.0f);
+	for (unsigned int i = 0; i < vertices.size(); i++)
+	{
+		if (i == 0)
+		{
+			vec3BoundsMin = vertices[i];
+			vec3BoundsMax = vertices[i];
+		}
+		vec3BoundsMin = glm::min(vec3BoundsMin, vertices[i]);
+		vec3BoundsMax = glm::max(vec3BoundsMax, vertices[i]);
+	}
+
+	CLoadOBJ::IndexVBO(vertices, uvs, normals, vIndices, vVertices);
+
+	return (vIndices.empty() == false);
+}
+
+/**
+ @brief Check if a cooked mesh is valid and is cooked from the current OBJ file.
+		If the OBJ file does not exist, then the cooked mesh is used as it is, so that
+		the cooked meshes can be shipped without the OBJ files.
+ @param sSourcePath A const std::string& variable containing the path of the OBJ file
+ @param cFile A const CMappedFile& variable containing the mapped file
+ @return A bool variable which is true if the cooked mesh can be used
+ */
+bool CMeshCache::IsValid(const std::string& sSourcePath, const CMappedFile& cFile)
+{
+	if (cFile.GetSize() < sizeof(SHeader))
+		return false;
+
+	const SHeader* pHeader = (const SHeader*)cFile.GetData();
+	if ((pHeader->uiMagic != uiFileMagic) || (pHeader->uiVersion != uiFileVersion))
+		return false;
+	if ((pHeader->uiIndexSize != sizeof(GLushort)) && (pHeader->uiIndexSize != sizeof(GLuint)))
+		return false;
+	if ((pHeader->uiNumOfVertices == 0) || (pHeader->uiNumOfIndices == 0))
+		return false;
+
+	const unsigned long long ullExpectedSize = sizeof(SHeader)
+											+ (unsigned long long)pHeader->uiNumOfVertices * sizeof(ModelVertex)
+											+ (unsigned long long)pHeader->uiNumOfIndices * pHeader->uiIndexSize;
+	if ((unsigned long long)cFile.GetSize() != ullExpectedSize)
+		return false;
+
+	return CMappedFile::IsSourceUnchanged(sSourcePath, pHeader->sSourceKey);
+}
@@ -0,0 +1,112 @@
+/**
+ CMeshCache
+ @brief This class cooks the meshes which are loaded from OBJ files into binary files, which are
+		stored next to the OBJ files with a ".mesh" extension. A cooked mesh contains the indexed
+		ModelVertex data, the indices as 16-bit or 32-bit values and the bounds of the mesh.
+		It is keyed by the size, modification time and hash of the OBJ file, so it is cooked again
+		when the OBJ file is changed. A cooked mesh is memory-mapped when it is opened, so that its
+		vertices and indices can be uploaded to the graphics card without parsing or copying them.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include LoadOBJ
+#include "System/LoadOBJ.h"
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include CMappedFile
+#include "MappedFile.h"
+
+#include <string>
+#include <vector>
+
+class CMeshCache
+{
+public:
+	// The header at the start of a cooked mesh file
+	struct SHeader
+	{
+		// The magic number and the version of the file format
+		unsigned int uiMagic;
+		unsigned int uiVersion;
+		// The key of the OBJ file which this mesh was cooked from
+		CMappedFile::SSourceKey sSourceKey;
+		// The number of vertices and indices, and the size of an index in bytes (2 or 4)
+		unsigned int uiNumOfVertices;
+		unsigned int uiNumOfIndices;
+		unsigned int uiIndexSize;
+		unsigned int uiReserved;
+		// The bounds of the mesh
+		float arrBoundsMin[3];
+		float arrBoundsMax[3];
+	};
+
+	// A cooked mesh which is mapped into memory. The pointers are valid until it is closed.
+	struct SMappedMesh
+	{
+		const SHeader* pHeader;
+		const ModelVertex* pVertices;
+		const void* pIndices;
+
+		// The mapped file
+		CMappedFile cFile;
+
+		SMappedMesh(void)
+			: pHeader(NULL)
+			, pVertices(NULL)
+			, pIndices(NULL)
+		{
+		}
+
+		// Check if a cooked mesh is mapped
+		bool IsOpen(void) const
+		{
+			return cFile.IsOpen();
+		}
+
+		// Get the OpenGL type of the indices
+		GLenum GetIndexType(void) const
+		{
+			return (pHeader->uiIndexSize == sizeof(GLushort) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT);
+		}
+	};
+
+	// Get the path of the cooked mesh of an OBJ file
+	static std::string GetCachePath(const std::string& sSourcePath);
+
+	// Map the cooked mesh of an OBJ file into memory, if it exists and is not out of date
+	static bool Open(const std::string& sSourcePath, SMappedMesh& sMappedMesh);
+	// Unmap a cooked mesh
+	static void Close(SMappedMesh& sMappedMesh);
+
+	// Cook a mesh which was loaded from an OBJ file, and write it next to the OBJ file
+	static bool Cook(	const std::string& sSourcePath,
+						const std::vector<ModelVertex>& vVertices,
+						const std::vector<GLuint>& vIndices,
+						const glm::vec3& vec3BoundsMin,
+						const glm::vec3& vec3BoundsMax);
+	// Load an OBJ file and cook it. This is used to cook the meshes offline.
+	static bool Cook(const std::string& sSourcePath);
+
+	// Load and index an OBJ file, and calculate the bounds of the mesh
+	static bool LoadOBJ(const std::string& sSourcePath,
+						std::vector<ModelVertex>& vVertices,
+						std::vector<GLuint>& vIndices,
+						glm::vec3& vec3BoundsMin,
+						glm::vec3& vec3BoundsMax);
+
+protected:
+	// The magic number of a cooked mesh file, which is "MESH" in little endian
+	static const unsigned int uiFileMagic = 0x4853454D;
+	// The version of the file format. Increase it when the format or the indexing is changed.
+	static const unsigned int uiFileVersion = 1;
+
+	// Check if a cooked mesh is valid and is cooked from the current OBJ file
+	static bool IsValid(const std::string& sSourcePath, const CMappedFile& cFile);
+};
@@ -0,0 +1,180 @@
+/**
+ CMeshSimplifier
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "MeshSimplifier.h"
+
+using namespace std;
+
+/**
+ @brief Create the indices of a simplified mesh. The cells are cubes, and their size is the longest side
+		of the bounds divided by uiNumOfCells, so a smaller uiNumOfCells creates a simpler mesh.
+ @param sMeshData A const CAssetLoader::SMeshData& variable containing the vertices and indices of the mesh
+ @param uiNumOfCells A const unsigned int variable containing the number of cells along the longest side of the bounds
+ @param vIndices A std::vector<GLuint>& variable which the indices of the simplified mesh are returned in
+ @return true if the simplified mesh has at least one triangle, else false
+ */
+bool CMeshSimplifier::Simplify(	const CAssetLoader::SMeshData& sMeshData,
+								const unsigned int uiNumOfCells,
+								std::vector<GLuint>& vIndices)
+{
+	vIndices.clear();
+	if ((sMeshData.bSuccess == false) || (sMeshData.uiNumOfVertices == 0) || (sMeshData.uiNumOfIndices < 3) || (uiNumOfCells == 0))
+		return false;
+
+	// Calculate the size of the cells and the number of cells along each axis
+	const glm::vec3 vec3Extent = sMeshData.vec3BoundsMax - sMeshData.vec3BoundsMin;
+	float fLongestSide = vec3Extent.x;
+	if (vec3Extent.y > fLongestSide)
+		fLongestSide = vec3Extent.y;
+	if (vec3Extent.z > fLongestSide)
+		fLongestSide = vec3Extent.z;
+	if (fLongestSide <= 0.0f)
+		return false;
+	const float fCellSize = fLongestSide / uiNumOfCells;
+	const unsigned int uiNumOfCellsX = (unsigned int)(vec3Extent.x / fCellSize) + 1;
+	const unsigned int uiNumOfCellsY = (unsigned int)(vec3Extent.y / fCellSize) + 1;
+	const unsigned int uiNumOfCellsZ = (unsigned int)(vec3Extent.z / fCellSize) + 1;
+
+	// Find the cell of each vertex, and the vertex which is nearest to the centre of each cell
+	const GLuint uiNoVertex = 0xFFFFFFFF;
+	vector<unsigned int> vCellOfVertex(sMeshData.uiNumOfVertices);
+	vector<GLuint> vVertexOfCell(uiNumOfCellsX * uiNumOfCellsY * uiNumOfCellsZ, uiNoVertex);
+	vector<float> vDistanceInCell(vVertexOfCell.size(), 0.0f);
+	for (unsigned int i = 0; i < sMeshData.uiNumOfVertices; i++)
+	{
+		// The position is at the start of a ModelVertex, which is where the position attribute points to
+		const glm::vec3& vec3Position = *(const glm::vec3*)&sMeshData.pVertices[i];
+		const glm::vec3 vec3Cell = (vec3Position - sMeshData.vec3BoundsMin) / fCellSize;
+		unsigned int uiCellX = vec3Cell.x > 0.0f ? (unsigned int)vec3Cell.x : 0;
+		unsigned int uiCellY = vec3Cell.y > 0.0f ? (unsigned int)vec3Cell.y : 0;
+		unsigned int uiCellZ = vec3Cell.z > 0.0f ? (unsigned int)vec3Cell.z : 0;
+		if (uiCellX >= uiNumOfCellsX)
+			uiCellX = uiNumOfCellsX - 1;
+		if (uiCellY >= uiNumOfCellsY)
+			uiCellY = uiNumOfCellsY - 1;
+		if (uiCellZ >= uiNumOfCellsZ)
+			uiCellZ = uiNumOfCellsZ - 1;
+
+		const unsigned int uiCell = (uiCellZ * uiNumOfCellsY + uiCellY) * uiNumOfCellsX + uiCellX;
+		vCellOfVertex[i] = uiCell;
+
+		const glm::vec3 vec3Offset = vec3Cell - glm::vec3(uiCellX + 0.5f, uiCellY + 0.5f, uiCellZ + 0.5f);
+		const float fDistance = glm::dot(vec3Offset, vec3Offset);
+		if ((vVertexOfCell[uiCell] == uiNoVertex) || (fDistance < vDistanceInCell[uiCell]))
+		{
+			vVertexOfCell[uiCell] = i;
+			vDistanceInCell[uiCell] = fDistance;
+		}
+	}
+
+	// Merge the vertices of the triangles, and remove the triangles which have collapsed
+	for (unsigned int i = 0; i + 2 < sMeshData.uiNumOfIndices; i += 3)
+	{
+		const GLuint uiVertex0 = vVertexOfCell[vCellOfVertex[GetIndex(sMeshData, i)]];
+		const GLuint uiVertex1 = vVertexOfCell[vCellOfVertex[GetIndex(sMeshData, i + 1)]];
+		const GLuint uiVertex2 = vVertexOfCell[vCellOfVertex[GetIndex(sMeshData, i + 2)]];
+		if ((uiVertex0 == uiVertex1) || (uiVertex1 == uiVertex2) || (uiVertex2 == uiVertex0))
+			continue;
+
+		vIndices.push_back(uiVertex0);
+		vIndices.push_back(uiVertex1);
+		vIndices.push_back(uiVertex2);
+	}
+
+	return (vIndices.empty() == false);
+}
+
+/**
+ @brief Create the VAOs and IBOs of the lower LODs of an instanced mesh. The first LOD is the mesh itself,
+		so its VAO and IBO are not created here. The mid LOD is simplified with 8 cells along the longest
+		side of the mesh, and each lower LOD with half the cells of the previous LOD. Each VAO uses the VBO
+		of the mesh with the position in attribute 0 and the texture coordinate in attribute 2, which
+		match the instancing shader. It stops at the first LOD which cannot be simplified.
+ @param sMeshData A const CAssetLoader::SMeshData& variable containing the vertices and indices of the mesh
+ @param uiVBO A const GLuint variable containing the VBO of the mesh
+ @param uiNumOfLODs A const unsigned int variable containing the number of LODs, including the first LOD
+ @param pVAOs A GLuint* variable containing uiNumOfLODs VAOs, which the VAOs of the lower LODs are returned in
+ @param pIBOs A GLuint* variable containing uiNumOfLODs IBOs, which the IBOs of the lower LODs are returned in
+ @param pIndicesSizes An unsigned int* variable containing uiNumOfLODs sizes, which the numbers of indices of the lower LODs are returned in
+ @param pIndexTypes A GLenum* variable containing uiNumOfLODs types, which the types of the indices of the lower LODs are returned in
+ @return The number of LODs which can be drawn, including the first LOD
+ */
+unsigned int CMeshSimplifier::CreateLODs(	const CAssetLoader::SMeshData& sMeshData,
+											const GLuint uiVBO,
+											const unsigned int uiNumOfLODs,
+											GLuint* pVAOs, GLuint* pIBOs,
+											unsigned int* pIndicesSizes, GLenum* pIndexTypes)
+{
+	unsigned int uiNumOfCreatedLODs = 1;
+	for (; uiNumOfCreatedLODs < uiNumOfLODs; uiNumOfCreatedLODs++)
+	{
+		const unsigned int i = uiNumOfCreatedLODs;
+		vector<GLuint> vIndices;
+		if (Simplify(sMeshData, 16 >> i, vIndices) == false)
+			break;
+
+		glGenVertexArrays(1, &pVAOs[i]);
+		glBindVertexArray(pVAOs[i]);
+		glBindBuffer(GL_ARRAY_BUFFER, uiVBO);
+		// position attribute
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
+		// texture coord attribute
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
+		glGenBuffers(1, &pIBOs[i]);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pIBOs[i]);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, vIndices.size() * sizeof(GLuint), &vIndices[0], GL_STATIC_DRAW);
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		pIndicesSizes[i] = (unsigned int)vIndices.size();
+		pIndexTypes[i] = GL_UNSIGNED_INT;
+	}
+
+	return uiNumOfCreatedLODs;
+}
+
+/**
+ @brief Delete the VAOs and IBOs of the lower LODs which were created by CreateLODs.
+		The first LOD is the VAO and IBO of the mesh, so it is not deleted here.
+ @param uiNumOfLODs A const unsigned int variable containing the number of LODs, including the first LOD
+ @param pVAOs A GLuint* variable containing uiNumOfLODs VAOs. The deleted VAOs are set to 0.
+ @param pIBOs A GLuint* variable containing uiNumOfLODs IBOs. The deleted IBOs are set to 0.
+ */
+void CMeshSimplifier::DeleteLODs(const unsigned int uiNumOfLODs, GLuint* pVAOs, GLuint* pIBOs)
+{
+	for (unsigned int i = 1; i < uiNumOfLODs; i++)
+	{
+		if (pVAOs[i] != 0)
+		{
+			glDeleteVertexArrays(1, &pVAOs[i]);
+			pVAOs[i] = 0;
+		}
+		if (pIBOs[i] != 0)
+		{
+			glDeleteBuffers(1, &pIBOs[i]);
+			pIBOs[i] = 0;
+		}
+	}
+}
+
+/**
+ @brief Get the index of a vertex from the indices of a mesh
+ @param sMeshData A const CAssetLoader::SMeshData& variable containing the indices of the mesh
+ @param uiIndex A const unsigned int variable containing the position of the index in the indices
+ @return The index of the vertex. It is clamped to the last vertex if the index is out of range.
+ */
+GLuint CMeshSimplifier::GetIndex(const CAssetLoader::SMeshData& sMeshData, const unsigned int uiIndex)
+{
+	GLuint uiVertex;
+	if (sMeshData.eIndexType == GL_UNSIGNED_SHORT)
+		uiVertex = ((const GLushort*)sMeshData.pIndices)[uiIndex];
+	else
+		uiVertex = ((const GLuint*)sMeshData.pIndices)[uiIndex];
+
+	if (uiVertex >= sMeshData.uiNumOfVertices)
+		uiVertex = sMeshData.uiNumOfVertices - 1;
+	return uiVertex;
+}
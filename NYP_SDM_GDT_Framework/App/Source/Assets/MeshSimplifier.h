@@ -0,0 +1,42 @@
+/**
+ CMeshSimplifier
+ @brief This class creates the indices of a simplified mesh by vertex clustering. The bounds of the
+		mesh are divided into a grid of cells, and all the vertices in a cell are merged into the
+		vertex which is nearest to the centre of the cell. The triangles which collapse are removed.
+		The simplified mesh uses the vertices of the original mesh, so only its indices are created
+		and it can share the vertex buffer of the original mesh. CreateLODs uploads the simplified
+		meshes of the lower levels of detail (LOD) of an instanced mesh, with a VAO for each of them.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include CAssetLoader
+#include "AssetLoader.h"
+
+// Include GLEW
+#include <GL/glew.h>
+
+#include <vector>
+
+class CMeshSimplifier
+{
+public:
+	// Create the indices of a simplified mesh, with uiNumOfCells cells along the longest side of the bounds
+	static bool Simplify(	const CAssetLoader::SMeshData& sMeshData,
+							const unsigned int uiNumOfCells,
+							std::vector<GLuint>& vIndices);
+
+	// Create the VAOs and IBOs of the lower LODs of an instanced mesh, which use the VBO of the mesh
+	static unsigned int CreateLODs(	const CAssetLoader::SMeshData& sMeshData,
+									const GLuint uiVBO,
+									const unsigned int uiNumOfLODs,
+									GLuint* pVAOs, GLuint* pIBOs,
+									unsigned int* pIndicesSizes, GLenum* pIndexTypes);
+	// Delete the VAOs and IBOs of the lower LODs which were created by CreateLODs
+	static void DeleteLODs(const unsigned int uiNumOfLODs, GLuint* pVAOs, GLuint* pIBOs);
+
+protected:
+	// Get the index of a vertex from the indices of a mesh, which are GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	static GLuint GetIndex(const CAssetLoader::SMeshData& sMeshData, const unsigned int uiIndex);
+};
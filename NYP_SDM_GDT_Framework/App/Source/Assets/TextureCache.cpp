@@ -0,0 +1,365 @@
+/**
+ CTextureCache
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "TextureCache.h"
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include CAssetLoader
+#include "AssetLoader.h"
+
+// Include the DXT compressor and the mipmap filter of SOIL, which are compiled as C
+extern "C"
+{
+#include <image_DXT.h>
+#include <image_helper.h>
+}
+
+// Include stdio for writing the files
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <vector>
+#include <algorithm>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Check if the graphics card supports the compressed formats. GLEW must be initialised first.
+ @return A bool variable which is true if the DXT formats can be uploaded
+ */
+bool CTextureCache::IsSupported(void)
+{
+	return (GLEW_EXT_texture_compression_s3tc != 0);
+}
+
+/**
+ @brief Get the path of the cooked texture of an image
+ @param sSourcePath A const std::string& variable containing the path of the image
+ @param bInvert A const bool variable which is true if the image is flipped vertically
+ @param bSwapRedBlue A const bool variable which is true if the red and blue channels of an RGB image are swapped
+ @return A std::string variable containing the path of the cooked texture
+ */
+std::string CTextureCache::GetCachePath(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue)
+{
+	std::string sCachePath = sSourcePath;
+	if (bInvert == true)
+		sCachePath += ".inverted";
+	if (bSwapRedBlue == true)
+		sCachePath += ".bgr";
+	return sCachePath + ".tex";
+}
+
+/**
+ @brief Map the cooked texture of an image into memory, if it exists and is not out of date
+ @param sSourcePath A const std::string& variable containing the path of the image
+ @param bInvert A const bool variable which is true if the image is flipped vertically
+ @param bSwapRedBlue A const bool variable which is true if the red and blue channels of an RGB image are swapped
+ @param sMappedTexture A SMappedTexture& variable to store the mapped texture
+ @return A bool variable which is true if the cooked texture is mapped
+ */
+bool CTextureCache::Open(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue, SMappedTexture& sMappedTexture)
+{
+	Close(sMappedTexture);
+	if (sMappedTexture.cFile.Open(GetCachePath(sSourcePath, bInvert, bSwapRedBlue)) == false)
+		return false;
+
+	if (IsValid(sSourcePath, sMappedTexture.cFile) == false)
+	{
+		Close(sMappedTexture);
+		return false;
+	}
+
+	const unsigned char* pData = sMappedTexture.cFile.GetData();
+	sMappedTexture.pHeader = (const SHeader*)pData;
+	sMappedTexture.pLevels = (const SLevel*)(pData + sizeof(SHeader));
+
+	return true;
+}
+
+/**
+ @brief Unmap a cooked texture
+ @param sMappedTexture A SMappedTexture& variable containing the mapped texture
+ */
+void CTextureCache::Close(SMappedTexture& sMappedTexture)
+{
+	sMappedTexture.cFile.Close();
+	sMappedTexture.pHeader = NULL;
+	sMappedTexture.pLevels = NULL;
+}
+
+/**
+ @brief Cook the decoded pixels of an image, and write the texture next to the image.
+		Each mipmap level is filtered from the level above it before it is compressed.
+		Only RGB and RGBA images are cooked, since the DXT formats do not keep the channels
+		of the single channel and two channel images apart.
+ @param sSourcePath A const std::string& variable containing the path of the image
+ @param bInvert A const bool variable which is true if the pixels were flipped vertically when they were decoded
+ @param bSwapRedBlue A const bool variable which is true if the red and blue channels of an RGB image are to be swapped
+ @param pData A const unsigned char* variable containing the decoded pixels
+ @param iWidth A const int variable containing the width of the image
+ @param iHeight A const int variable containing the height of the image
+ @param iNumOfChannels A const int variable containing the number of channels of the image
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CTextureCache::Cook(	const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue,
+							const unsigned char* pData, const int iWidth, const int iHeight, const int iNumOfChannels)
+{
+	if ((pData == NULL) || (iWidth <= 0) || (iHeight <= 0) || ((iNumOfChannels != 3) && (iNumOfChannels != 4)))
+		return false;
+
+	SHeader sHeader;
+	sHeader.uiMagic = uiFileMagic;
+	sHeader.uiVersion = uiFileVersion;
+	if (CMappedFile::GetSourceKey(sSourcePath, sHeader.sSourceKey) == false)
+		return false;
+	sHeader.uiFormat = (iNumOfChannels == 4 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+	sHeader.uiWidth = (unsigned int)iWidth;
+	sHeader.uiHeight = (unsigned int)iHeight;
+	sHeader.uiNumOfChannels = (unsigned int)iNumOfChannels;
+	sHeader.uiNumOfLevels = 1;
+	for (int w = iWidth, h = iHeight; (w > 1) || (h > 1); w = std::max(1, w / 2), h = std::max(1, h / 2))
+		sHeader.uiNumOfLevels++;
+	sHeader.uiReserved = 0;
+	if (sHeader.uiNumOfLevels > uiMaxNumOfLevels)
+		return false;
+
+	// The pixels of the current level. The first level uses the decoded pixels, unless they have to be swapped.
+	const unsigned char* pLevelPixels = pData;
+	unsigned char* pLevelBuffer = NULL;
+	if ((bSwapRedBlue == true) && (iNumOfChannels == 3))
+	{
+		const size_t uiNumOfBytes = (size_t)iWidth * iHeight * iNumOfChannels;
+		pLevelBuffer = (unsigned char*)malloc(uiNumOfBytes);
+		if (pLevelBuffer == NULL)
+			return false;
+		for (size_t i = 0; i < uiNumOfBytes; i += 3)
+		{
+			pLevelBuffer[i] = pData[i + 2];
+			pLevelBuffer[i + 1] = pData[i + 1];
+			pLevelBuffer[i + 2] = pData[i];
+		}
+		pLevelPixels = pLevelBuffer;
+	}
+
+	std::vector<SLevel> vLevels;
+	std::vector<unsigned char*> vBlocks;
+	unsigned int uiOffset = sizeof(SHeader) + sHeader.uiNumOfLevels * sizeof(SLevel);
+	int iLevelWidth = iWidth;
+	int iLevelHeight = iHeight;
+	bool bResult = true;
+	for (unsigned int i = 0; i < sHeader.uiNumOfLevels; i++)
+	{
+		int iSize = 0;
+		unsigned char* pBlocks = NULL;
+		if (sHeader.uiFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
+			pBlocks = convert_image_to_DXT5(pLevelPixels, iLevelWidth, iLevelHeight, iNumOfChannels, &iSize);
+		else
+			pBlocks = convert_image_to_DXT1(pLevelPixels, iLevelWidth, iLevelHeight, iNumOfChannels, &iSize);
+		if ((pBlocks == NULL) || ((unsigned int)iSize != GetLevelSize(sHeader.uiFormat, iLevelWidth, iLevelHeight)))
+		{
+			free(pBlocks);
+			bResult = false;
+			break;
+		}
+
+		SLevel sLevel;
+		sLevel.uiOffset = uiOffset;
+		sLevel.uiSize = (unsigned int)iSize;
+		sLevel.uiWidth = (unsigned int)iLevelWidth;
+		sLevel.uiHeight = (unsigned int)iLevelHeight;
+		vLevels.push_back(sLevel);
+		vBlocks.push_back(pBlocks);
+		uiOffset += sLevel.uiSize;
+
+		if (i + 1 == sHeader.uiNumOfLevels)
+			break;
+
+		// Filter the next level from this level
+		const int iMipWidth = std::max(1, iLevelWidth / 2);
+		const int iMipHeight = std::max(1, iLevelHeight / 2);
+		unsigned char* pMipPixels = (unsigned char*)malloc((size_t)iMipWidth * iMipHeight * iNumOfChannels);
+		if ((pMipPixels == NULL) ||
+			(mipmap_image(	pLevelPixels, iLevelWidth, iLevelHeight, iNumOfChannels, pMipPixels,
+							(iLevelWidth > 1 ? 2 : 1), (iLevelHeight > 1 ? 2 : 1)) == 0))
+		{
+			free(pMipPixels);
+			bResult = false;
+			break;
+		}
+		free(pLevelBuffer);
+		pLevelBuffer = pMipPixels;
+		pLevelPixels = pMipPixels;
+		iLevelWidth = iMipWidth;
+		iLevelHeight = iMipHeight;
+	}
+	free(pLevelBuffer);
+
+	const std::string sCachePath = GetCachePath(sSourcePath, bInvert, bSwapRedBlue);
+	const std::string sTempPath = CMappedFile::GetTempPath(sCachePath);
+	FILE* pFile = NULL;
+	if (bResult == true)
+	{
+		pFile = fopen(sTempPath.c_str(), "wb");
+		bResult = (pFile != NULL);
+	}
+	if (bResult == true)
+	{
+		bResult = (fwrite(&sHeader, sizeof(SHeader), 1, pFile) == 1);
+		bResult = bResult && (fwrite(&vLevels[0], sizeof(SLevel), vLevels.size(), pFile) == vLevels.size());
+		for (unsigned int i = 0; i < vBlocks.size(); i++)
+		{
+			bResult = bResult && (fwrite(vBlocks[i], 1, vLevels[i].uiSize, pFile) == vLevels[i].uiSize);
+		}
+		bResult = (fclose(pFile) == 0) && bResult;
+
+		// Replace the old cooked texture. This fails if another thread has mapped it, and then the old one is kept.
+		if (bResult == true)
+			bResult = CMappedFile::ReplaceFile(sTempPath, sCachePath);
+		else
+			remove(sTempPath.c_str());
+		if (bResult == false)
+			cout << "Unable to write the cooked texture " << sCachePath << endl;
+	}
+
+	for (unsigned int i = 0; i < vBlocks.size(); i++)
+	{
+		free(vBlocks[i]);
+	}
+
+	return bResult;
+}
+
+/**
+ @brief Load an image and cook it. This is used to cook the textures offline.
+ @param sSourcePath A const std::string& variable containing the path of the image
+ @param bInvert A const bool variable which is true if the image is to be flipped vertically
+ @param bSwapRedBlue A const bool variable which is true if the red and blue channels of an RGB image are to be swapped
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CTextureCache::Cook(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue)
+{
+	int iWidth = 0, iHeight = 0, iNumOfChannels = 0;
+	unsigned char* pData = NULL;
+	pData = CAssetLoader::GetInstance()->DecodeImage(sSourcePath.c_str(), iWidth, iHeight, iNumOfChannels, bInvert);
+	if (pData == NULL)
+		return false;
+
+	const bool bResult = Cook(sSourcePath, bInvert, bSwapRedBlue, pData, iWidth, iHeight, iNumOfChannels);
+
+	// Free up the memory of the file data read in
+	free(pData);
+
+	return bResult;
+}
+
+/**
+ @brief Upload all the mipmap levels of a cooked texture to the bound texture
+ @param sMappedTexture A const SMappedTexture& variable containing the mapped texture
+ @param eTarget A const GLenum variable containing the target, such as GL_TEXTURE_2D or a face of a cube map
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CTextureCache::Upload(const SMappedTexture& sMappedTexture, const GLenum eTarget)
+{
+	if (sMappedTexture.IsOpen() == false)
+		return false;
+
+	const SHeader* pHeader = sMappedTexture.pHeader;
+	for (unsigned int i = 0; i < pHeader->uiNumOfLevels; i++)
+	{
+		const SLevel& sLevel = sMappedTexture.pLevels[i];
+		glCompressedTexImage2D(	eTarget, i, pHeader->uiFormat, sLevel.uiWidth, sLevel.uiHeight, 0,
+								sLevel.uiSize, sMappedTexture.GetLevelData(i));
+	}
+
+	return true;
+}
+
+/**
+ @brief Create a 2D texture from a cooked texture
+ @param sMappedTexture A const SMappedTexture& variable containing the mapped texture
+ @return A GLuint variable containing the texture ID, or 0 if the cooked texture is not mapped
+ */
+GLuint CTextureCache::CreateTexture(const SMappedTexture& sMappedTexture)
+{
+	if (sMappedTexture.IsOpen() == false)
+		return 0;
+
+	GLuint uiTextureID = 0;
+	glGenTextures(1, &uiTextureID);
+	glBindTexture(GL_TEXTURE_2D, uiTextureID);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, sMappedTexture.pHeader->uiNumOfLevels - 1);
+
+	Upload(sMappedTexture, GL_TEXTURE_2D);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	return uiTextureID;
+}
+
+/**
+ @brief Get the size of the compressed blocks of a mipmap level. Each block has 4 x 4 pixels,
+		and uses 8 bytes in DXT1 or 16 bytes in DXT5.
+ @param uiFormat A const unsigned int variable containing the compressed format
+ @param uiWidth A const unsigned int variable containing the width of the mipmap level
+ @param uiHeight A const unsigned int variable containing the height of the mipmap level
+ @return An unsigned int variable containing the size in bytes
+ */
+unsigned int CTextureCache::GetLevelSize(const unsigned int uiFormat, const unsigned int uiWidth, const unsigned int uiHeight)
+{
+	const unsigned int uiBlockSize = (uiFormat == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT ? 16 : 8);
+	return ((uiWidth + 3) / 4) * ((uiHeight + 3) / 4) * uiBlockSize;
+}
+
+/**
+ @brief Check if a cooked texture is valid and is cooked from the current image.
+		If the image does not exist, then the cooked texture is used as it is, so that
+		the cooked textures can be shipped without the images.
+ @param sSourcePath A const std::string& variable containing the path of the image
+ @param cFile A const CMappedFile& variable containing the mapped file
+ @return A bool variable which is true if the cooked texture can be used
+ */
+bool CTextureCache::IsValid(const std::string& sSourcePath, const CMappedFile& cFile)
+{
+	if (cFile.GetSize() < sizeof(SHeader))
+		return false;
+
+	const SHeader* pHeader = (const SHeader*)cFile.GetData();
+	if ((pHeader->uiMagic != uiFileMagic) || (pHeader->uiVersion != uiFileVersion))
+		return false;
+	if ((pHeader->uiFormat != GL_COMPRESSED_RGB_S3TC_DXT1_EXT) && (pHeader->uiFormat != GL_COMPRESSED_RGBA_S3TC_DXT5_EXT))
+		return false;
+	if ((pHeader->uiWidth == 0) || (pHeader->uiHeight == 0))
+		return false;
+	if ((pHeader->uiNumOfLevels == 0) || (pHeader->uiNumOfLevels > uiMaxNumOfLevels))
+		return false;
+	if (cFile.GetSize() < sizeof(SHeader) + pHeader->uiNumOfLevels * sizeof(SLevel))
+		return false;
+
+	// Check that each level has the expected size and lies inside the file
+	const SLevel* pLevels = (const SLevel*)(cFile.GetData() + sizeof(SHeader));
+	unsigned int uiWidth = pHeader->uiWidth;
+	unsigned int uiHeight = pHeader->uiHeight;
+	for (unsigned int i = 0; i < pHeader->uiNumOfLevels; i++)
+	{
+		if ((pLevels[i].uiWidth != uiWidth) || (pLevels[i].uiHeight != uiHeight))
+			return false;
+		if (pLevels[i].uiSize != GetLevelSize(pHeader->uiFormat, uiWidth, uiHeight))
+			return false;
+		if ((unsigned long long)pLevels[i].uiOffset + pLevels[i].uiSize > (unsigned long long)cFile.GetSize())
+			return false;
+
+		uiWidth = std::max(1u, uiWidth / 2);
+		uiHeight = std::max(1u, uiHeight / 2);
+	}
+
+	return CMappedFile::IsSourceUnchanged(sSourcePath, pHeader->sSourceKey);
+}
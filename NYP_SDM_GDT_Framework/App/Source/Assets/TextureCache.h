@@ -0,0 +1,116 @@
+/**
+ CTextureCache
+ @brief This class cooks the images into compressed textures, which are stored next to the images
+		with a ".tex" extension. A cooked texture contains a full mipmap chain, which is compressed
+		to DXT1 (BC1) for RGB images or DXT5 (BC3) for RGBA images, so that it uses 1/6 or 1/4 of
+		the memory of an uncompressed texture in the graphics card, and is uploaded without
+		decoding the image or generating its mipmaps. It is keyed by the size, modification time
+		and hash of the image, so it is cooked again when the image is changed.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include CMappedFile
+#include "MappedFile.h"
+
+#include <string>
+
+class CTextureCache
+{
+public:
+	// The header at the start of a cooked texture file
+	struct SHeader
+	{
+		// The magic number and the version of the file format
+		unsigned int uiMagic;
+		unsigned int uiVersion;
+		// The key of the image which this texture was cooked from
+		CMappedFile::SSourceKey sSourceKey;
+		// The compressed format, which is GL_COMPRESSED_RGB_S3TC_DXT1_EXT or GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+		unsigned int uiFormat;
+		// The size of the image and its number of channels
+		unsigned int uiWidth;
+		unsigned int uiHeight;
+		unsigned int uiNumOfChannels;
+		// The number of mipmap levels, which are stored in a table after this header
+		unsigned int uiNumOfLevels;
+		unsigned int uiReserved;
+	};
+
+	// A mipmap level in a cooked texture file
+	struct SLevel
+	{
+		// The offset of the compressed blocks from the start of the file, and their size in bytes
+		unsigned int uiOffset;
+		unsigned int uiSize;
+		unsigned int uiWidth;
+		unsigned int uiHeight;
+	};
+
+	// A cooked texture which is mapped into memory. The pointers are valid until it is closed.
+	struct SMappedTexture
+	{
+		const SHeader* pHeader;
+		const SLevel* pLevels;
+
+		// The mapped file
+		CMappedFile cFile;
+
+		SMappedTexture(void)
+			: pHeader(NULL)
+			, pLevels(NULL)
+		{
+		}
+
+		// Check if a cooked texture is mapped
+		bool IsOpen(void) const
+		{
+			return cFile.IsOpen();
+		}
+
+		// Get the compressed blocks of a mipmap level
+		const unsigned char* GetLevelData(const unsigned int uiLevel) const
+		{
+			return cFile.GetData() + pLevels[uiLevel].uiOffset;
+		}
+	};
+
+	// Check if the graphics card supports the compressed formats
+	static bool IsSupported(void);
+
+	// Get the path of the cooked texture of an image
+	static std::string GetCachePath(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue);
+
+	// Map the cooked texture of an image into memory, if it exists and is not out of date
+	static bool Open(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue, SMappedTexture& sMappedTexture);
+	// Unmap a cooked texture
+	static void Close(SMappedTexture& sMappedTexture);
+
+	// Cook the decoded pixels of an image, and write the texture next to the image
+	static bool Cook(	const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue,
+						const unsigned char* pData, const int iWidth, const int iHeight, const int iNumOfChannels);
+	// Load an image and cook it. This is used to cook the textures offline.
+	static bool Cook(const std::string& sSourcePath, const bool bInvert, const bool bSwapRedBlue);
+
+	// Upload all the mipmap levels of a cooked texture to the bound texture
+	static bool Upload(const SMappedTexture& sMappedTexture, const GLenum eTarget);
+	// Create a 2D texture from a cooked texture
+	static GLuint CreateTexture(const SMappedTexture& sMappedTexture);
+
+protected:
+	// The magic number of a cooked texture file, which is "TEXC" in little endian
+	static const unsigned int uiFileMagic = 0x43584554;
+	// The version of the file format. Increase it when the format or the compression is changed.
+	static const unsigned int uiFileVersion = 1;
+	// The maximum number of mipmap levels, which is enough for a 32768 x 32768 image
+	static const unsigned int uiMaxNumOfLevels = 16;
+
+	// Get the size of the compressed blocks of a mipmap level
+	static unsigned int GetLevelSize(const unsigned int uiFormat, const unsigned int uiWidth, const unsigned int uiHeight);
+	// Check if a cooked texture is valid and is cooked from the current image
+	static bool IsValid(const std::string& sSourcePath, const CMappedFile& cFile);
+};
@@ -0,0 +1,282 @@
+/**
+ CHandlePool
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "HandlePool.h"
+
+// The value of an invalid slot or index
+const unsigned int CHandlePool::UINT_INVALID;
+
+/**
+ @brief Constructor
+ */
+CHandlePool::CHandlePool(void)
+	: ePolicy(POLICY::GROW)
+	, uiNumOfActive(0)
+	, uiNumOfSteals(0)
+	, ullActivationCount(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CHandlePool::~CHandlePool(void)
+{
+}
+
+/**
+ @brief Initialise the pool with a capacity and a policy. All the elements are deactivated.
+ @param uiCapacity A const unsigned int variable containing the capacity of the pool
+ @param ePolicy A const POLICY variable containing the policy when the pool is full
+ */
+void CHandlePool::Init(const unsigned int uiCapacity, const POLICY ePolicy)
+{
+	this->ePolicy = ePolicy;
+	uiNumOfActive = 0;
+	uiNumOfSteals = 0;
+	ullActivationCount = 0;
+
+	vSlotToDense.clear();
+	vSlotGeneration.clear();
+	vDenseToSlot.clear();
+	vDenseActivation.clear();
+	vFreeSlots.clear();
+
+	Grow(uiCapacity);
+}
+
+/**
+ @brief Set the policy when the pool is full
+ @param ePolicy A const POLICY variable containing the policy
+ */
+void CHandlePool::SetPolicy(const POLICY ePolicy)
+{
+	if (ePolicy >= POLICY::NUM_POLICY)
+		return;
+
+	this->ePolicy = ePolicy;
+}
+
+/**
+ @brief Get the policy when the pool is full
+ @return A POLICY variable containing the policy
+ */
+CHandlePool::POLICY CHandlePool::GetPolicy(void) const
+{
+	return ePolicy;
+}
+
+/**
+ @brief Activate an element. The owner stores the element at uiDenseIndex.
+		If the pool is full, then the policy decides if the pool grows, or if the oldest active element is reused.
+		The owner should check GetCapacity() after this, in case the pool had grown.
+ @param sHandle A SHandle& variable to store the handle of the new element
+ @param uiDenseIndex An unsigned int& variable to store the dense index of the new element
+ @return A bool variable which is true if the element was activated
+ */
+bool CHandlePool::Activate(SHandle& sHandle, unsigned int& uiDenseIndex)
+{
+	if (vFreeSlots.empty())
+	{
+		if ((ePolicy == POLICY::STEAL) && (uiNumOfActive > 0))
+		{
+			// Find the oldest active element
+			uiDenseIndex = 0;
+			for (unsigned int i = 1; i < uiNumOfActive; i++)
+			{
+				if (vDenseActivation[i] < vDenseActivation[uiDenseIndex])
+					uiDenseIndex = i;
+			}
+
+			// Free its slot so that its handles become invalid, and reuse its dense index
+			FreeSlot(vDenseToSlot[uiDenseIndex]);
+			uiNumOfSteals++;
+
+			const unsigned int uiSlot = vFreeSlots.back();
+			vFreeSlots.pop_back();
+			vSlotToDense[uiSlot] = uiDenseIndex;
+			vDenseToSlot[uiDenseIndex] = uiSlot;
+			vDenseActivation[uiDenseIndex] = ullActivationCount++;
+
+			sHandle.uiSlot = uiSlot;
+			sHandle.uiGeneration = vSlotGeneration[uiSlot];
+			return true;
+		}
+		else if (ePolicy == POLICY::GROW)
+		{
+			// Double the capacity of the pool
+			Grow(vSlotToDense.empty() ? 1 : (unsigned int)vSlotToDense.size() * 2);
+		}
+		else
+		{
+			sHandle = SHandle();
+			uiDenseIndex = UINT_INVALID;
+			return false;
+		}
+	}
+
+	// The new element is added after the last active element
+	const unsigned int uiSlot = vFreeSlots.back();
+	vFreeSlots.pop_back();
+	uiDenseIndex = uiNumOfActive;
+	uiNumOfActive++;
+
+	vSlotToDense[uiSlot] = uiDenseIndex;
+	vDenseToSlot[uiDenseIndex] = uiSlot;
+	vDenseActivation[uiDenseIndex] = ullActivationCount++;
+
+	sHandle.uiSlot = uiSlot;
+	sHandle.uiGeneration = vSlotGeneration[uiSlot];
+	return true;
+}
+
+/**
+ @brief Deactivate an element using its handle.
+		The last active element is moved into its dense index, so the owner must copy
+		the element at uiMovedFrom to uiDenseIndex if they are different.
+ @param sHandle A const SHandle& variable containing the handle of the element
+ @param uiDenseIndex An unsigned int& variable to store the dense index of the deactivated element
+ @param uiMovedFrom An unsigned int& variable to store the dense index of the element which was moved
+ @return A bool variable which is true if the element was deactivated
+ */
+bool CHandlePool::Deactivate(const SHandle& sHandle, unsigned int& uiDenseIndex, unsigned int& uiMovedFrom)
+{
+	if (IsValid(sHandle) == false)
+		return false;
+
+	uiDenseIndex = vSlotToDense[sHandle.uiSlot];
+	return DeactivateAt(uiDenseIndex, uiMovedFrom);
+}
+
+/**
+ @brief Deactivate an element using its dense index.
+		The last active element is moved into this dense index, so the owner must copy
+		the element at uiMovedFrom to uiDenseIndex if they are different.
+ @param uiDenseIndex A const unsigned int variable containing the dense index of the element
+ @param uiMovedFrom An unsigned int& variable to store the dense index of the element which was moved
+ @return A bool variable which is true if the element was deactivated
+ */
+bool CHandlePool::DeactivateAt(const unsigned int uiDenseIndex, unsigned int& uiMovedFrom)
+{
+	if (uiDenseIndex >= uiNumOfActive)
+		return false;
+
+	FreeSlot(vDenseToSlot[uiDenseIndex]);
+
+	// Swap the last active element into this dense index, and pop the last one
+	uiNumOfActive--;
+	uiMovedFrom = uiNumOfActive;
+	if (uiMovedFrom != uiDenseIndex)
+	{
+		const unsigned int uiMovedSlot = vDenseToSlot[uiMovedFrom];
+		vDenseToSlot[uiDenseIndex] = uiMovedSlot;
+		vDenseActivation[uiDenseIndex] = vDenseActivation[uiMovedFrom];
+		vSlotToDense[uiMovedSlot] = uiDenseIndex;
+	}
+	vDenseToSlot[uiMovedFrom] = UINT_INVALID;
+
+	return true;
+}
+
+/**
+ @brief Check if a handle is still valid
+ @param sHandle A const SHandle& variable containing the handle
+ @return A bool variable which is true if the element of this handle is still active
+ */
+bool CHandlePool::IsValid(const SHandle& sHandle) const
+{
+	return ((sHandle.uiSlot < vSlotToDense.size()) &&
+			(vSlotToDense[sHandle.uiSlot] != UINT_INVALID) &&
+			(vSlotGeneration[sHandle.uiSlot] == sHandle.uiGeneration));
+}
+
+/**
+ @brief Get the dense index of an element using its handle
+ @param sHandle A const SHandle& variable containing the handle
+ @return An unsigned int variable containing the dense index, or UINT_INVALID if the handle is not valid
+ */
+unsigned int CHandlePool::GetDenseIndex(const SHandle& sHandle) const
+{
+	if (IsValid(sHandle) == false)
+		return UINT_INVALID;
+
+	return vSlotToDense[sHandle.uiSlot];
+}
+
+/**
+ @brief Get the handle of an element using its dense index
+ @param uiDenseIndex A const unsigned int variable containing the dense index
+ @return A SHandle variable containing the handle, which is not valid if the dense index is not active
+ */
+CHandlePool::SHandle CHandlePool::GetHandle(const unsigned int uiDenseIndex) const
+{
+	SHandle sHandle;
+	if (uiDenseIndex < uiNumOfActive)
+	{
+		sHandle.uiSlot = vDenseToSlot[uiDenseIndex];
+		sHandle.uiGeneration = vSlotGeneration[sHandle.uiSlot];
+	}
+	return sHandle;
+}
+
+/**
+ @brief Get the number of active elements
+ @return An unsigned int variable containing the number of active elements
+ */
+unsigned int CHandlePool::GetNumOfActive(void) const
+{
+	return uiNumOfActive;
+}
+
+/**
+ @brief Get the capacity of the pool
+ @return An unsigned int variable containing the capacity of the pool
+ */
+unsigned int CHandlePool::GetCapacity(void) const
+{
+	return (unsigned int)vSlotToDense.size();
+}
+
+/**
+ @brief Get the number of elements which were stolen
+ @return An unsigned int variable containing the number of elements which were stolen
+ */
+unsigned int CHandlePool::GetNumOfSteals(void) const
+{
+	return uiNumOfSteals;
+}
+
+/**
+ @brief Increase the capacity of the pool
+ @param uiNewCapacity A const unsigned int variable containing the new capacity of the pool
+ */
+void CHandlePool::Grow(const unsigned int uiNewCapacity)
+{
+	const unsigned int uiOldCapacity = (unsigned int)vSlotToDense.size();
+	if (uiNewCapacity <= uiOldCapacity)
+		return;
+
+	vSlotToDense.resize(uiNewCapacity, UINT_INVALID);
+	vSlotGeneration.resize(uiNewCapacity, 0);
+	vDenseToSlot.resize(uiNewCapacity, UINT_INVALID);
+	vDenseActivation.resize(uiNewCapacity, 0);
+
+	// Add the new slots in reverse, so that the lower slots are used first
+	for (unsigned int i = uiNewCapacity; i > uiOldCapacity; i--)
+	{
+		vFreeSlots.push_back(i - 1);
+	}
+}
+
+/**
+ @brief Free a slot so that its handles become invalid
+ @param uiSlot A const unsigned int variable containing the slot
+ */
+void CHandlePool::FreeSlot(const unsigned int uiSlot)
+{
+	vSlotToDense[uiSlot] = UINT_INVALID;
+	vSlotGeneration[uiSlot]++;
+	vFreeSlots.push_back(uiSlot);
+}
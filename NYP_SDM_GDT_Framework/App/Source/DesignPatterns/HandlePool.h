@@ -0,0 +1,102 @@
+/**
+ CHandlePool
+ @brief This class keeps the active elements of a pool packed at the front of the pool,
+		and gives each active element a handle which stays valid while the element moves.
+		The pool does not store the elements. The owner stores them in arrays indexed by
+		the dense index, and copies the element which is moved when another one is deactivated.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include vector
+#include <vector>
+
+class CHandlePool
+{
+public:
+	// A handle to an active element. It becomes invalid when the element is deactivated.
+	struct SHandle
+	{
+		unsigned int uiSlot;
+		unsigned int uiGeneration;
+
+		SHandle(void)
+			: uiSlot(UINT_INVALID)
+			, uiGeneration(0)
+		{
+		}
+	};
+
+	// The policy when an element is activated and the pool is full
+	enum class POLICY : unsigned int
+	{
+		GROW = 0,	// Double the capacity of the pool
+		STEAL,		// Reuse the oldest active element
+		FAIL,		// Do not activate the element
+		NUM_POLICY
+	};
+
+	// The value of an invalid slot or index
+	static const unsigned int UINT_INVALID = 0xFFFFFFFF;
+
+	// Constructor
+	CHandlePool(void);
+	// Destructor
+	virtual ~CHandlePool(void);
+
+	// Initialise the pool with a capacity and a policy
+	void Init(const unsigned int uiCapacity, const POLICY ePolicy = POLICY::GROW);
+
+	// Set the policy when the pool is full
+	void SetPolicy(const POLICY ePolicy);
+	// Get the policy when the pool is full
+	POLICY GetPolicy(void) const;
+
+	// Activate an element. Its dense index is the index to store the element at.
+	bool Activate(SHandle& sHandle, unsigned int& uiDenseIndex);
+	// Deactivate an element using its handle
+	bool Deactivate(const SHandle& sHandle, unsigned int& uiDenseIndex, unsigned int& uiMovedFrom);
+	// Deactivate an element using its dense index
+	bool DeactivateAt(const unsigned int uiDenseIndex, unsigned int& uiMovedFrom);
+
+	// Check if a handle is still valid
+	bool IsValid(const SHandle& sHandle) const;
+	// Get the dense index of an element using its handle
+	unsigned int GetDenseIndex(const SHandle& sHandle) const;
+	// Get the handle of an element using its dense index
+	SHandle GetHandle(const unsigned int uiDenseIndex) const;
+
+	// Get the number of active elements
+	unsigned int GetNumOfActive(void) const;
+	// Get the capacity of the pool
+	unsigned int GetCapacity(void) const;
+	// Get the number of elements which were stolen
+	unsigned int GetNumOfSteals(void) const;
+
+protected:
+	// The policy when the pool is full
+	POLICY ePolicy;
+	// The number of active elements
+	unsigned int uiNumOfActive;
+	// The number of elements which were stolen
+	unsigned int uiNumOfSteals;
+	// The number of elements activated so far, used to find the oldest active element
+	unsigned long long ullActivationCount;
+
+	// The dense index of each slot, or UINT_INVALID if the slot is free
+	std::vector<unsigned int> vSlotToDense;
+	// The generation of each slot, which is increased when the slot is freed
+	std::vector<unsigned int> vSlotGeneration;
+	// The slot of each dense index
+	std::vector<unsigned int> vDenseToSlot;
+	// The activation count of each dense index
+	std::vector<unsigned long long> vDenseActivation;
+	// The slots which are free
+	std::vector<unsigned int> vFreeSlots;
+
+	// Increase the capacity of the pool
+	void Grow(const unsigned int uiNewCapacity);
+	// Free a slot so that its handles become invalid
+	void FreeSlot(const unsigned int uiSlot);
+};
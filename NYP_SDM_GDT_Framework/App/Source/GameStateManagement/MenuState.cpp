@@ -19,8 +19,8 @@
 
 // Include Mesh Builder
 #include "Primitives/MeshBuilder.h"
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 
 // Include CSettings
 #include "GameControl/Settings.h"
@@ -73,15 +73,15 @@ bool CMenuState::Init(void)
 	ImGui_ImplOpenGL3_Init(glsl_version);
 
 	// Load the images for buttons
-	CImageLoader* il = CImageLoader::GetInstance();
+	CAssetLoader* cAssetLoader = CAssetLoader::GetInstance();
 	startButtonData.fileName = "Image\\GUI\\PlayButton.png";
-	startButtonData.textureID = il->LoadTextureGetID(startButtonData.fileName.c_str(), false);
+	startButtonData.textureID = cAssetLoader->LoadTextureGetID(startButtonData.fileName.c_str(), false);
 
 	play3DButtonData.fileName = "Image\\GUI\\PlayButton_3D.png";
-	play3DButtonData.textureID = il->LoadTextureGetID(play3DButtonData.fileName.c_str(), false);
+	play3DButtonData.textureID = cAssetLoader->LoadTextureGetID(play3DButtonData.fileName.c_str(), false);
 
 	exitButtonData.fileName = "Image\\GUI\\ExitButton.png";
-	exitButtonData.textureID = il->LoadTextureGetID(exitButtonData.fileName.c_str(), false);
+	exitButtonData.textureID = cAssetLoader->LoadTextureGetID(exitButtonData.fileName.c_str(), false);
 
 	// Enable the cursor
 	if (CSettings::GetInstance()->bDisableMousePointer == true)
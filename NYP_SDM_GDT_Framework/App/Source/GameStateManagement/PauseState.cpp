@@ -19,8 +19,8 @@
 
 // Include Mesh Builder
 #include "Primitives/MeshBuilder.h"
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
 
@@ -61,11 +61,11 @@ bool CPauseState::Init(void)
 	CShaderManager::GetInstance()->activeShader->setInt("texture1", 0);
 
 	// Load the images for buttons
-	CImageLoader* il = CImageLoader::GetInstance();
+	CAssetLoader* cAssetLoader = CAssetLoader::GetInstance();
 	VolumeIncreaseButtonData.fileName = "Image\\GUI\\VolumeIncreaseButton.png";
-	VolumeIncreaseButtonData.textureID = il->LoadTextureGetID(VolumeIncreaseButtonData.fileName.c_str(), false);
+	VolumeIncreaseButtonData.textureID = cAssetLoader->LoadTextureGetID(VolumeIncreaseButtonData.fileName.c_str(), false);
 	VolumeDecreaseButtonData.fileName = "Image\\GUI\\VolumeDecreaseButton.png";
-	VolumeDecreaseButtonData.textureID = il->LoadTextureGetID(VolumeDecreaseButtonData.fileName.c_str(), false);
+	VolumeDecreaseButtonData.textureID = cAssetLoader->LoadTextureGetID(VolumeDecreaseButtonData.fileName.c_str(), false);
 
 	return true;
 }
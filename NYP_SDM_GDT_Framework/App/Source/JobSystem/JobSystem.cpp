@@ -0,0 +1,298 @@
+/**
+ CJobSystem
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "JobSystem.h"
+
+// Include chrono
+#include <chrono>
+
+#include <iostream>
+using namespace std;
+
+// The index of the calling thread. The worker threads set it when they start,
+// so the main thread and any other thread use the deque of thread 0.
+static thread_local unsigned int uiCurrentThreadIndex = 0;
+
+/**
+ @brief Default Constructor
+ */
+CJobSystem::CJobSystem(void)
+	: iNumOfPendingJobs(0)
+	, bRunning(false)
+	, uiNumOfSteals(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CJobSystem::~CJobSystem(void)
+{
+	Exit();
+}
+
+/**
+ @brief Initialise this class instance
+ @param uiNumOfWorkers A const unsigned int variable containing the number of worker threads.
+		If it is 0, then one worker thread is created for each hardware thread except the main thread.
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CJobSystem::Init(const unsigned int uiNumOfWorkers)
+{
+	// Don't initialise again if the worker threads are already running
+	if (bRunning == true)
+		return true;
+
+	unsigned int uiWorkers = uiNumOfWorkers;
+	if (uiWorkers == 0)
+	{
+		const unsigned int uiHardwareThreads = std::thread::hardware_concurrency();
+		uiWorkers = (uiHardwareThreads > 1 ? uiHardwareThreads - 1 : 0);
+	}
+
+	// Create a deque for the main thread and for each worker thread
+	for (unsigned int i = 0; i < uiWorkers + 1; i++)
+	{
+		vJobQueues.push_back(new SJobQueue());
+	}
+
+	iNumOfPendingJobs = 0;
+	uiNumOfSteals = 0;
+	bRunning = true;
+	for (unsigned int i = 1; i < uiWorkers + 1; i++)
+	{
+		vWorkers.push_back(std::thread(&CJobSystem::WorkerLoop, this, i));
+	}
+
+	return true;
+}
+
+/**
+ @brief Stop all the worker threads. The jobs which are still in the deques are discarded.
+ */
+void CJobSystem::Exit(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		bRunning = false;
+	}
+	cvSleep.notify_all();
+
+	for (unsigned int i = 0; i < vWorkers.size(); i++)
+	{
+		if (vWorkers[i].joinable())
+			vWorkers[i].join();
+	}
+	vWorkers.clear();
+
+	for (unsigned int i = 0; i < vJobQueues.size(); i++)
+	{
+		delete vJobQueues[i];
+	}
+	vJobQueues.clear();
+	iNumOfPendingJobs = 0;
+}
+
+/**
+ @brief Run a job on the worker threads.
+ @param job A const JOB& variable containing the job
+ @param pCounter A SCounter* variable which is increased now and decreased when the job is done. It can be NULL.
+ */
+void CJobSystem::Run(const JOB& job, SCounter* pCounter)
+{
+	if (pCounter)
+		pCounter->iValue.fetch_add(1, std::memory_order_relaxed);
+
+	// If there are no worker threads, then run the job now
+	if (vWorkers.empty())
+	{
+		job();
+		if (pCounter)
+			pCounter->iValue.fetch_sub(1, std::memory_order_release);
+		return;
+	}
+
+	SJob sJob;
+	sJob.job = job;
+	sJob.pCounter = pCounter;
+	Push(GetThreadIndex(), sJob);
+
+	// Wake up a worker thread to run or steal this job
+	cvSleep.notify_one();
+}
+
+/**
+ @brief Run a job on each range of uiGrainSize elements of [0, uiCount), and wait for all of them to be done.
+		The ranges do not overlap, so the job can write to the elements of its range without locking.
+ @param uiCount A const unsigned int variable containing the number of elements
+ @param uiGrainSize A const unsigned int variable containing the number of elements in each range
+ @param job A const RANGEJOB& variable containing the job
+ */
+void CJobSystem::ParallelFor(const unsigned int uiCount, const unsigned int uiGrainSize, const RANGEJOB& job)
+{
+	if (uiCount == 0)
+		return;
+
+	const unsigned int uiGrain = (uiGrainSize > 0 ? uiGrainSize : 1);
+
+	// Run it on this thread if there is only one range, or if there are no worker threads
+	if ((uiCount <= uiGrain) || (vWorkers.empty()))
+	{
+		job(0, uiCount);
+		return;
+	}
+
+	SCounter sCounter;
+	for (unsigned int uiBegin = 0; uiBegin < uiCount; uiBegin += uiGrain)
+	{
+		const unsigned int uiEnd = (uiCount - uiBegin > uiGrain ? uiBegin + uiGrain : uiCount);
+		Run([&job, uiBegin, uiEnd]() { job(uiBegin, uiEnd); }, &sCounter);
+	}
+	Wait(sCounter);
+}
+
+/**
+ @brief Wait for a counter to reach zero. The calling thread runs other jobs while it waits.
+ @param sCounter A const SCounter& variable containing the counter
+ */
+void CJobSystem::Wait(const SCounter& sCounter)
+{
+	const unsigned int uiThreadIndex = GetThreadIndex();
+	while (sCounter.IsDone() == false)
+	{
+		if (RunOneJob(uiThreadIndex) == false)
+			std::this_thread::yield();
+	}
+}
+
+/**
+ @brief Get the number of threads, including the main thread
+ @return An unsigned int variable containing the number of threads
+ */
+unsigned int CJobSystem::GetNumOfThreads(void) const
+{
+	return (unsigned int)vWorkers.size() + 1;
+}
+
+/**
+ @brief Get the index of the calling thread. The main thread is 0.
+ @return An unsigned int variable containing the index of the calling thread
+ */
+unsigned int CJobSystem::GetThreadIndex(void) const
+{
+	return uiCurrentThreadIndex;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CJobSystem::PrintSelf(void)
+{
+	cout << "CJobSystem::PrintSelf()" << endl;
+	cout << "Number of threads: " << GetNumOfThreads() << endl;
+	cout << "Number of pending jobs: " << iNumOfPendingJobs << endl;
+	cout << "Number of stolen jobs: " << uiNumOfSteals << endl;
+}
+
+/**
+ @brief The main loop of a worker thread
+ @param uiThreadIndex A const unsigned int variable containing the index of this thread
+ */
+void CJobSystem::WorkerLoop(const unsigned int uiThreadIndex)
+{
+	uiCurrentThreadIndex = uiThreadIndex;
+
+	while (bRunning == true)
+	{
+		if (RunOneJob(uiThreadIndex) == true)
+			continue;
+
+		// Sleep until a job is added. Wake up regularly in case a notification was missed.
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+		cvSleep.wait_for(lock, std::chrono::milliseconds(1), [this]()
+		{
+			return ((bRunning == false) || (iNumOfPendingJobs > 0));
+		});
+	}
+}
+
+/**
+ @brief Take a job from the deques and run it
+ @param uiThreadIndex A const unsigned int variable containing the index of the calling thread
+ @return A bool variable which is true if a job was run
+ */
+bool CJobSystem::RunOneJob(const unsigned int uiThreadIndex)
+{
+	SJob sJob;
+	if ((Pop(uiThreadIndex, sJob) == false) && (Steal(uiThreadIndex, sJob) == false))
+		return false;
+
+	sJob.job();
+	if (sJob.pCounter)
+		sJob.pCounter->iValue.fetch_sub(1, std::memory_order_release);
+
+	return true;
+}
+
+/**
+ @brief Take a job from the back of a thread's own deque
+ @param uiThreadIndex A const unsigned int variable containing the index of the thread
+ @param sJob A SJob& variable to store the job
+ @return A bool variable which is true if a job was taken
+ */
+bool CJobSystem::Pop(const unsigned int uiThreadIndex, SJob& sJob)
+{
+	SJobQueue* cJobQueue = vJobQueues[uiThreadIndex];
+	std::lock_guard<std::mutex> lock(cJobQueue->mMutex);
+	if (cJobQueue->dJobs.empty())
+		return false;
+
+	sJob = cJobQueue->dJobs.back();
+	cJobQueue->dJobs.pop_back();
+	iNumOfPendingJobs--;
+	return true;
+}
+
+/**
+ @brief Take a job from the front of another thread's deque
+ @param uiThreadIndex A const unsigned int variable containing the index of the thread which is stealing
+ @param sJob A SJob& variable to store the job
+ @return A bool variable which is true if a job was taken
+ */
+bool CJobSystem::Steal(const unsigned int uiThreadIndex, SJob& sJob)
+{
+	// Start from the next thread, so that the threads do not all steal from the same deque
+	const unsigned int uiNumOfQueues = (unsigned int)vJobQueues.size();
+	for (unsigned int i = 1; i < uiNumOfQueues; i++)
+	{
+		SJobQueue* cJobQueue = vJobQueues[(uiThreadIndex + i) % uiNumOfQueues];
+		std::lock_guard<std::mutex> lock(cJobQueue->mMutex);
+		if (cJobQueue->dJobs.empty())
+			continue;
+
+		sJob = cJobQueue->dJobs.front();
+		cJobQueue->dJobs.pop_front();
+		iNumOfPendingJobs--;
+		uiNumOfSteals++;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ @brief Add a job to the back of a thread's deque
+ @param uiThreadIndex A const unsigned int variable containing the index of the thread
+ @param sJob A const SJob& variable containing the job
+ */
+void CJobSystem::Push(const unsigned int uiThreadIndex, const SJob& sJob)
+{
+	SJobQueue* cJobQueue = vJobQueues[uiThreadIndex];
+	{
+		std::lock_guard<std::mutex> lock(cJobQueue->mMutex);
+		cJobQueue->dJobs.push_back(sJob);
+	}
+	iNumOfPendingJobs++;
+}
@@ -0,0 +1,121 @@
+/**
+ CJobSystem
+ @brief This class runs jobs on a pool of worker threads. Each thread has its own deque of jobs.
+		A thread takes jobs from the back of its own deque, and steals from the front of the
+		deques of the other threads when its own deque is empty. The main thread is thread 0,
+		and it runs jobs too while it waits for a counter to reach zero.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include SingletonTemplate
+#include "DesignPatterns\SingletonTemplate.h"
+
+// Include atomic, thread, mutex and condition_variable
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// Include functional
+#include <functional>
+
+// Include deque and vector
+#include <deque>
+#include <vector>
+
+class CJobSystem : public CSingletonTemplate<CJobSystem>
+{
+	friend class CSingletonTemplate<CJobSystem>;
+
+public:
+	// A counter of the jobs which are not done yet. A job can wait for a counter to reach zero.
+	struct SCounter
+	{
+		std::atomic<int> iValue;
+
+		SCounter(void)
+			: iValue(0)
+		{
+		}
+
+		// Check if all the jobs of this counter are done
+		bool IsDone(void) const
+		{
+			return (iValue.load(std::memory_order_acquire) == 0);
+		}
+	};
+
+	// A job which runs once
+	typedef std::function<void(void)> JOB;
+	// A job which runs on the range [uiBegin, uiEnd) of a parallel for
+	typedef std::function<void(const unsigned int uiBegin, const unsigned int uiEnd)> RANGEJOB;
+
+	// Initialise this class instance. If uiNumOfWorkers is 0, then the number of hardware threads is used.
+	bool Init(const unsigned int uiNumOfWorkers = 0);
+	// Stop all the worker threads
+	void Exit(void);
+
+	// Run a job. The counter is increased now and decreased when the job is done.
+	void Run(const JOB& job, SCounter* pCounter = NULL);
+	// Run a job on each range of uiGrainSize elements of [0, uiCount), and wait for all of them
+	void ParallelFor(const unsigned int uiCount, const unsigned int uiGrainSize, const RANGEJOB& job);
+	// Wait for a counter to reach zero. The calling thread runs other jobs while it waits.
+	void Wait(const SCounter& sCounter);
+
+	// Get the number of threads, including the main thread
+	unsigned int GetNumOfThreads(void) const;
+	// Get the index of the calling thread. The main thread is 0.
+	unsigned int GetThreadIndex(void) const;
+
+	// PrintSelf
+	void PrintSelf(void);
+
+protected:
+	// A job in a deque
+	struct SJob
+	{
+		JOB job;
+		SCounter* pCounter;
+	};
+
+	// The deque of jobs of a thread
+	struct SJobQueue
+	{
+		std::mutex mMutex;
+		std::deque<SJob> dJobs;
+	};
+
+	// The deques of jobs, one for each thread
+	std::vector<SJobQueue*> vJobQueues;
+	// The worker threads
+	std::vector<std::thread> vWorkers;
+
+	// The number of jobs which are in the deques
+	std::atomic<int> iNumOfPendingJobs;
+	// Boolean flag to indicate if the worker threads should keep running
+	std::atomic<bool> bRunning;
+	// Used by the idle worker threads to sleep until a job is added
+	std::mutex mSleepMutex;
+	std::condition_variable cvSleep;
+
+	// The number of jobs which were stolen from another thread
+	std::atomic<unsigned int> uiNumOfSteals;
+
+	// The main loop of a worker thread
+	void WorkerLoop(const unsigned int uiThreadIndex);
+	// Take a job from the deques and run it. Return false if no job was run.
+	bool RunOneJob(const unsigned int uiThreadIndex);
+	// Take a job from the back of a thread's own deque
+	bool Pop(const unsigned int uiThreadIndex, SJob& sJob);
+	// Take a job from the front of another thread's deque
+	bool Steal(const unsigned int uiThreadIndex, SJob& sJob);
+	// Add a job to the back of a thread's deque
+	void Push(const unsigned int uiThreadIndex, const SJob& sJob);
+
+	// Default Constructor
+	CJobSystem(void);
+	// Destructor
+	virtual ~CJobSystem(void);
+};
@@ -15,8 +15,8 @@
 // For allowing creating of Quad Mesh 
 #include "Primitives/MeshBuilder.h"
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 
 #include <iostream>
 #include <vector>
@@ -64,7 +64,7 @@ bool CBackgroundEntity::Init(void)
 	model = glm::scale(model, glm::vec3(CSettings::GetInstance()->iWindowWidth, CSettings::GetInstance()->iWindowHeight, 1.0f));
 
 	// Load a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID(textureName.c_str(), true);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID(textureName.c_str(), true);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load " << textureName.c_str() << endl;
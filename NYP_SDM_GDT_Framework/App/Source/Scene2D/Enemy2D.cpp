@@ -17,8 +17,8 @@ using namespace std;
 // Include GLEW
 #include <GL/glew.h>
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
@@ -97,7 +97,7 @@ bool CEnemy2D::Init(void)
 	p2DMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), 1, 1);
 
 	// Load the enemy2D texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_EnemyTile.tga", true);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_EnemyTile.tga", true);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/Scene2D_EnemyTile.tga" << endl;
@@ -13,8 +13,6 @@ using namespace std;
  */
 CEnemy2DManager::CEnemy2DManager(void)
 	: uiTotalElements(2)
-	, uiIndexFirst(0)
-	, uiIndexLast(0)
 {
 }
 
@@ -50,58 +48,103 @@ bool CEnemy2DManager::Init(void)
 	// Clear the vector
 	vEnemy2D.clear();
 
-	// Reserve the size of the vector
-	vEnemy2D.reserve(uiTotalElements);
+	// Reserve the size of the vector. The pool grows when it is full.
+	cHandlePool.Init(uiTotalElements, CHandlePool::POLICY::GROW);
 
 	// Create the instances of CEnemy2D* and store them in the vector
-	for (unsigned int i = 0; i < uiTotalElements; i++)
-	{
-		vEnemy2D.push_back(new CEnemy2D());
-	}
+	Resize();
 	return true;
 }
 
 /**
- @brief Activate a CEnemy2D* to this class instance
- @param vec3Position A const glm::vec3 variable containing the source position of the cEnemy2D
+ @brief Activate a CEnemy2D* to this class instance.
+		If the pool is full, then it grows or the oldest CEnemy2D is reused, depending on the policy.
+ @param vec2Position A const glm::vec2 variable containing the source position of the cEnemy2D
+ @param sHandle A CHandlePool::SHandle& variable to store the handle of the cEnemy2D
  @return A bool variable which is true if the CEnemy2D was activated successfully, otherwise false.
  */
-bool CEnemy2DManager::Activate(glm::vec2 vec2Position, int& uiIndex)
+bool CEnemy2DManager::Activate(glm::vec2 vec2Position, CHandlePool::SHandle& sHandle)
 {
-	// Since a cEnemy2D has been added, we activate the next element in the vector
-	vEnemy2D[uiIndexLast]->vec2Position = vec2Position;
-	if (vEnemy2D[uiIndexLast]->Init() == false)
+	unsigned int uiIndex;
+	if (cHandlePool.Activate(sHandle, uiIndex) == false)
 		return false;
-	vEnemy2D[uiIndexLast]->SetShader(sShaderName);
 
-	// Increase the uiIndexLast by 1 since a cEnemy2D is going to be added
-	if (uiIndexLast + 1 == vEnemy2D.size())
-		uiIndexLast = 0;
-	else
-		uiIndexLast++;
+	// Create more CEnemy2Ds if the pool had grown
+	Resize();
 
-	uiIndex = uiIndexLast;
+	vEnemy2D[uiIndex]->vec2Position = vec2Position;
+	if (vEnemy2D[uiIndex]->Init() == false)
+	{
+		Deactivate(uiIndex);
+		return false;
+	}
+	vEnemy2D[uiIndex]->SetShader(sShaderName);
 
 	return true;
 }
 
 /**
- @brief Deactivate a CEnemy2D* from this class instance
+ @brief Deactivate a CEnemy2D* from this class instance using its index.
+		The last active CEnemy2D is swapped into this index.
  @param iIndex A const unsigned int variable containing the index of the cEnemy2D to deactivate
  @return A bool variable to indicate this method successfully completed its tasks
  */
 bool CEnemy2DManager::Deactivate(const unsigned int iIndex)
 {
-	if (iIndex<vEnemy2D.size())
-	{
-		// Set the cEnemy2D to inactive
-		vEnemy2D[iIndex]->SetStatus(false);
-		// Return true
-		return true;
-	}
+	unsigned int uiMovedFrom;
+	if (cHandlePool.DeactivateAt(iIndex, uiMovedFrom) == false)
+		return false;
+
+	// Set the cEnemy2D to inactive, and swap it behind the active ones
+	vEnemy2D[iIndex]->SetStatus(false);
+	std::swap(vEnemy2D[iIndex], vEnemy2D[uiMovedFrom]);
+	return true;
+}
 
-	// Return false if not found
-	return false;
+/**
+ @brief Deactivate a CEnemy2D* from this class instance using its handle
+ @param sHandle A const CHandlePool::SHandle& variable containing the handle of the cEnemy2D to deactivate
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CEnemy2DManager::Deactivate(const CHandlePool::SHandle& sHandle)
+{
+	const unsigned int uiIndex = cHandlePool.GetDenseIndex(sHandle);
+	if (uiIndex == CHandlePool::UINT_INVALID)
+		return false;
+
+	return Deactivate(uiIndex);
+}
+
+/**
+ @brief Set the policy when the pool is full
+ @param ePolicy A const CHandlePool::POLICY variable containing the policy
+ */
+void CEnemy2DManager::SetPolicy(const CHandlePool::POLICY ePolicy)
+{
+	cHandlePool.SetPolicy(ePolicy);
+}
+
+/**
+ @brief Get the number of active CEnemy2Ds, which are at the front of vEnemy2D
+ @return An unsigned int variable containing the number of active CEnemy2Ds
+ */
+unsigned int CEnemy2DManager::GetNumOfActive(void) const
+{
+	return cHandlePool.GetNumOfActive();
+}
+
+/**
+ @brief Get a CEnemy2D using its handle
+ @param sHandle A const CHandlePool::SHandle& variable containing the handle of the cEnemy2D
+ @return A CEnemy2D* variable, or NULL if the handle is not valid
+ */
+CEnemy2D* CEnemy2DManager::Get(const CHandlePool::SHandle& sHandle) const
+{
+	const unsigned int uiIndex = cHandlePool.GetDenseIndex(sHandle);
+	if (uiIndex == CHandlePool::UINT_INVALID)
+		return NULL;
+
+	return vEnemy2D[uiIndex];
 }
 
 /**
@@ -110,47 +153,11 @@ bool CEnemy2DManager::Deactivate(const unsigned int iIndex)
  */
 void CEnemy2DManager::Update(const double dElapsedTime)
 {
-	uiIndexFirst = uiIndexLast + 1;
-	if (uiIndexFirst >= vEnemy2D.size())
-	{
-		uiIndexFirst = 0;
-
-		// CollisionCheck all projectiles against CSolidObject
-		// Check the oldest index until the end of 
-		for (unsigned int i = uiIndexFirst; i <= uiIndexLast; i++)
-		{
-			// If this cEnemy2D is not active, then skip it
-			if (vEnemy2D[i]->GetStatus() == false)
-				continue;
-
-			// Update a cEnemy2D
-			vEnemy2D[i]->Update(dElapsedTime);
-		}
-	}
-	else
+	// Update only the active CEnemy2Ds
+	for (unsigned int i = 0; i < cHandlePool.GetNumOfActive(); i++)
 	{
-		// CollisionCheck all projectiles against CSolidObject
-		// Check the oldest index until the end of 
-		for (unsigned int i = uiIndexFirst; i < vEnemy2D.size(); i++)
-		{
-			// If this cEnemy2D is not active, then skip it
-			if (vEnemy2D[i]->GetStatus() == false)
-				continue;
-
-			// Update a cEnemy2D
-			vEnemy2D[i]->Update(dElapsedTime);
-		}
-
-		// CollisionCheck all projectiles against CSolidObject
-		for (unsigned int i = 0; i <= uiIndexLast; i++)
-		{
-			// If this cEnemy2D is not active, then skip it
-			if (vEnemy2D[i]->GetStatus() == false)
-				continue;
-
-			// Update a cEnemy2D
-			vEnemy2D[i]->Update(dElapsedTime);
-		}
+		// Update a cEnemy2D
+		vEnemy2D[i]->Update(dElapsedTime);
 	}
 }
 
@@ -166,13 +173,9 @@ void CEnemy2DManager::PreRender(void)
  */
 void CEnemy2DManager::Render(void)
 {
-	// Render all entities
-	for (unsigned int i = 0; i < vEnemy2D.size(); i++)
+	// Render only the active CEnemy2Ds
+	for (unsigned int i = 0; i < cHandlePool.GetNumOfActive(); i++)
 	{
-		// If this cEnemy2D is not active, then skip it
-		if (vEnemy2D[i]->GetStatus() == false)
-			continue;
-
 		vEnemy2D[i]->PreRender();
 		vEnemy2D[i]->Render();
 		vEnemy2D[i]->PostRender();
@@ -194,11 +197,23 @@ void CEnemy2DManager::PrintSelf(void)
 	cout << "===============================" << endl;
 	cout << "CEnemy2DManager::PrintSelf()" << endl;
 	cout << "-------------------------------" << endl;
-	// Render all entities
-	for (unsigned int i = 0; i < vEnemy2D.size(); i++)
+	cout << "Number of active CEnemy2Ds: " << cHandlePool.GetNumOfActive() << " / " << cHandlePool.GetCapacity() << endl;
+	// Print only the active CEnemy2Ds
+	for (unsigned int i = 0; i < cHandlePool.GetNumOfActive(); i++)
 	{
 		cout << i << "\t: ";
 		vEnemy2D[i]->PrintSelf();
 	}
 	cout << "===============================" << endl;
 }
+
+/**
+ @brief Create more CEnemy2Ds if the pool had grown
+ */
+void CEnemy2DManager::Resize(void)
+{
+	while (vEnemy2D.size() < cHandlePool.GetCapacity())
+	{
+		vEnemy2D.push_back(new CEnemy2D());
+	}
+}
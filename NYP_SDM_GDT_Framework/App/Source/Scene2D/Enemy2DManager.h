@@ -11,6 +11,9 @@
 // Include Enemy2D
 #include "Enemy2D.h"
 
+// Include CHandlePool
+#include "../DesignPatterns/HandlePool.h"
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
@@ -31,9 +34,18 @@ public:
 	bool Init(void);
 
 	// Activate a CEnemy2D* to this class instance
-	virtual bool Activate(glm::vec2 vec2Position, int& uiIndex);
-	// Deactivate a CEnemy2D* from this class instance
+	virtual bool Activate(glm::vec2 vec2Position, CHandlePool::SHandle& sHandle);
+	// Deactivate a CEnemy2D* from this class instance using its index
 	virtual bool Deactivate(const unsigned int iIndex);
+	// Deactivate a CEnemy2D* from this class instance using its handle
+	virtual bool Deactivate(const CHandlePool::SHandle& sHandle);
+
+	// Set the policy when the pool is full
+	void SetPolicy(const CHandlePool::POLICY ePolicy);
+	// Get the number of active CEnemy2Ds, which are at the front of vEnemy2D
+	unsigned int GetNumOfActive(void) const;
+	// Get a CEnemy2D using its handle
+	CEnemy2D* Get(const CHandlePool::SHandle& sHandle) const;
 
 	// Update this class instance
 	virtual void Update(const double dElapsedTime);
@@ -50,7 +62,7 @@ public:
 	// PrintSelf
 	virtual void PrintSelf(void);
 
-	// List of CEnemy2D
+	// List of CEnemy2D. The active ones are at the front of this vector.
 	std::vector<CEnemy2D*> vEnemy2D;
 
 protected:
@@ -59,10 +71,11 @@ protected:
 
 	// The total number of elements to reserve for the vector
 	unsigned int uiTotalElements;
-	// The index of the first active element in the vector to activate
-	unsigned int uiIndexFirst;
-	// The index of the last active element in the vector to activate
-	unsigned int uiIndexLast;
+	// The pool which keeps the active CEnemy2Ds at the front of the vector
+	CHandlePool cHandlePool;
+
+	// Create more CEnemy2Ds if the pool had grown
+	void Resize(void);
 
 	// Default Constructor
 	CEnemy2DManager(void);
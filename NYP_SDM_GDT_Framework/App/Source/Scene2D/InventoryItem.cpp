@@ -6,8 +6,8 @@
  */
 #include "InventoryItem.h"
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 
 #include <iostream>
 
@@ -21,7 +21,7 @@ CInventoryItem::CInventoryItem(const char* imagePath)
 {
 	if (imagePath)
 	{
-		iTextureID = CImageLoader::GetInstance()->LoadTextureGetID(imagePath, true);
+		iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID(imagePath, true);
 		if (iTextureID == 0)
 		{
 			cout << "Unable to load " << imagePath << endl;
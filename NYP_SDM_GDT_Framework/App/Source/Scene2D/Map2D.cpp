@@ -30,6 +30,7 @@ CMap2D::CMap2D(void)
 	, quadMesh(NULL)
 	, TileSize(glm::vec2(25.0f, 25.0f))
 	, TileHalfSize(glm::vec2(12.5f, 12.5f))
+	, iBoundArray(-1)
 {
 }
 
@@ -58,6 +59,9 @@ CMap2D::~CMap2D(void)
 		quadMesh = NULL;
 	}
 
+	// Delete the texture arrays of the tiles
+	cMaterialTable.Exit();
+
 	// optional: de-allocate all resources once they've outlived their purpose:
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
@@ -118,79 +122,30 @@ bool CMap2D::Init(	const unsigned int uiNumLevels,
 	//quadMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), cSettings->TILE_WIDTH, cSettings->TILE_HEIGHT);
 	quadMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), 1, 1);
 
-	// Load and create textures
+	// Load and create textures. They are packed into a texture array, so that the tiles are drawn without rebinding textures.
+	// The tiles are small sprites, so they are not compressed.
+	cMaterialTable.SetCompressed(false);
 	// Load the ground texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_GroundTile.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_GroundTile.tga" << endl;
+	if (LoadTileTexture(100, "Image/Scene2D_GroundTile.tga") == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(100, iTextureID));
-	}
 	// Load the tree texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_TreeTile.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_TreeTile.tga" << endl;
+	if (LoadTileTexture(2, "Image/Scene2D_TreeTile.tga") == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(2, iTextureID));
-	}
 	// Load the Life texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_Lives.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_Lives.tga" << endl;
+	if (LoadTileTexture(10, "Image/Scene2D_Lives.tga") == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(10, iTextureID));
-	}
 	// Load the spike texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_Spikes.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_Spikes.tga" << endl;
+	if (LoadTileTexture(20, "Image/Scene2D_Spikes.tga") == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(20, iTextureID));
-	}
 	// Load the Spa texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_Spa.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_Spa.tga" << endl;
+	if (LoadTileTexture(21, "Image/Scene2D_Spa.tga") == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(21, iTextureID));
-	}
 	// Load the Exit texture
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene2D_Exit.tga", true);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Image/Scene2D_Exit.tga" << endl;
+	if (LoadTileTexture(99, "Image/Scene2D_Exit.tga") == false)
+		return false;
+	// Create the texture arrays
+	if (cMaterialTable.Build() == false)
 		return false;
-	}
-	else
-	{
-		// Store the texture ID into MapOfTextureIDs
-		MapOfTextureIDs.insert(pair<int, int>(99, iTextureID));
-	}
 
 	// Initialise the variables for AStar
 	m_weight = 1;
@@ -517,8 +472,9 @@ void CMap2D::PreRender(void)
  */
 void CMap2D::Render(void)
 {
-	// bind textures on corresponding texture units
-	glActiveTexture(GL_TEXTURE0);
+	// The texture array is bound to texture unit 0 when the first tile is rendered
+	CShaderManager::GetInstance()->activeShader->setInt("imageTextureArray", 0);
+	iBoundArray = -1;
 
 	for (unsigned int uiRow = 0; uiRow < cSettings->NUM_TILES_YAXIS; uiRow++)
 	{
@@ -546,6 +502,13 @@ void CMap2D::Render(void)
 			RenderTile(uiRow, uiCol);
 		}
 	}
+
+	// Unbind the texture array
+	if (iBoundArray >= 0)
+	{
+		cMaterialTable.Unbind(0);
+		iBoundArray = -1;
+	}
 }
 
 /**
@@ -843,16 +806,47 @@ unsigned int CMap2D::GetCurrentLevel(void) const
  */
 void CMap2D::RenderTile(const unsigned int uiRow, const unsigned int uiCol)
 {
-	if (arrMapInfo[uiCurLevel][uiRow][uiCol].value != 0)
+	const unsigned int uiTileValue = arrMapInfo[uiCurLevel][uiRow][uiCol].value;
+	if ((uiTileValue != 0) && (uiTileValue < vTileMaterials.size()) && (vTileMaterials[uiTileValue] >= 0))
 	{
-		//if (arrMapInfo[uiCurLevel][uiRow][uiCol].value < 3)
-		glBindTexture(GL_TEXTURE_2D, MapOfTextureIDs.at(arrMapInfo[uiCurLevel][uiRow][uiCol].value));
-			glBindVertexArray(VAO);
-				//CS: Render the tile
-				quadMesh->Render();
-			glBindVertexArray(0);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		const CMaterialTable::SMaterial& sMaterial = cMaterialTable.GetMaterial(vTileMaterials[uiTileValue]);
+
+		// Only bind the texture array if this tile is not in the texture array which is bound now
+		if (iBoundArray != (int)sMaterial.uiArray)
+		{
+			cMaterialTable.Bind(sMaterial.uiArray, 0);
+			iBoundArray = (int)sMaterial.uiArray;
+		}
+		CShaderManager::GetInstance()->activeShader->setFloat("fLayer", (float)sMaterial.uiLayer);
+
+		glBindVertexArray(VAO);
+			//CS: Render the tile
+			quadMesh->Render();
+		glBindVertexArray(0);
+	}
+}
+
+/**
+ @brief Load the texture of a tile value into the material table
+ @param uiTileValue A const unsigned int variable containing the tile value
+ @param sFilePath A const string& variable containing the path of the image file
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CMap2D::LoadTileTexture(const unsigned int uiTileValue, const string& sFilePath)
+{
+	const int iMaterial = cMaterialTable.Add(sFilePath, sFilePath, true);
+	if (iMaterial < 0)
+	{
+		cout << "Unable to load " << sFilePath << endl;
+		return false;
 	}
+
+	// Store the material into vTileMaterials
+	if (uiTileValue >= vTileMaterials.size())
+		vTileMaterials.resize(uiTileValue + 1, -1);
+	vTileMaterials[uiTileValue] = iMaterial;
+
+	return true;
 }
 
 
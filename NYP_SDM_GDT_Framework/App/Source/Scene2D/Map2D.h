@@ -31,6 +31,9 @@
 // Include Entity2D
 #include "Primitives/Entity2D.h"
 
+// Include CMaterialTable
+#include "../Assets/MaterialTable.h"
+
 // Include files for AStar
 #include <queue>
 #include <functional>
@@ -185,8 +188,12 @@ protected:
 	glm::vec2 TileHalfSize;
 	const glm::vec2 vec2SizeTolerance = glm::vec2(0.05f, 0.05f);
 
-	// Map containing texture IDs
-	map<int, int> MapOfTextureIDs;
+	// The material table which packs the textures of the tiles into texture arrays
+	CMaterialTable cMaterialTable;
+	// The material of each tile value, or -1 if the tile value has no texture
+	std::vector<int> vTileMaterials;
+	// The texture array which is bound now, or -1 if none is bound
+	int iBoundArray;
 
 	//CS: The quadMesh for drawing the tiles
 	CMesh* quadMesh;
@@ -200,6 +207,8 @@ protected:
 	// Destructor
 	virtual ~CMap2D(void);
 
+	// Load the texture of a tile value
+	bool LoadTileTexture(const unsigned int uiTileValue, const string& sFilePath);
 	// Render a tile
 	void RenderTile(const unsigned int uiRow, const unsigned int uiCol);
 
@@ -12,8 +12,8 @@ using namespace std;
 // Include Shader Manager
 #include "RenderControl\ShaderManager.h"
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
 
 // Include the Map2D as we will use it to check the player's movements and actions
 #include "Map2D.h"
@@ -94,7 +94,7 @@ bool CPlayer2D::Init(void)
 	glBindVertexArray(VAO);
 
 	// Load the player texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/scene2d_player.png", true);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/scene2d_player.png", true);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/scene2d_player.png" << endl;
@@ -79,7 +79,7 @@ bool CScene2D::Init(void)
 	// Create and initialise the Map 2D
 	cMap2D = CMap2D::GetInstance();
 	// Set a shader to this class
-	cMap2D->SetShader("Shader2D");
+	cMap2D->SetShader("Shader2D_TextureArray");
 	// Load Scene2DColour into ShaderManager
 	CShaderManager::GetInstance()->Use("Shader2D");
 
@@ -133,9 +133,9 @@ bool CScene2D::Init(void)
 		// Erase the value of the player in the arrMapInfo
 		cMap2D->SetMapInfo(uiRow, uiCol, 0);
 
-		int uiIndex = -1;
+		CHandlePool::SHandle sHandle;
 		if (cEnemy2DManager->Activate(glm::vec2(uiCol * cMap2D->GetTileSize().x + cMap2D->GetTileHalfSize().x,
-												uiRow * cMap2D->GetTileSize().y + cMap2D->GetTileHalfSize().y), uiIndex) == false)
+												uiRow * cMap2D->GetTileSize().y + cMap2D->GetTileHalfSize().y), sHandle) == false)
 		{
 			cout << "Unable to activate an Enemy2D at [" << uiRow << ", " << uiCol << "]" << endl;
 		}
@@ -14,6 +14,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 // Include MeshBuilder
 #include "Primitives/MeshBuilder.h"
 
@@ -57,7 +60,7 @@ bool CBloodScreen::Init(void)
 	p2DMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), 1.0f, 1.0f, false);
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Blood.tga", false);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Blood.tga", false);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/GUI/CameraEffects_Blood.tga" << endl;
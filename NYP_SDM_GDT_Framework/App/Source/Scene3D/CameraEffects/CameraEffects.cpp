@@ -17,6 +17,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 // Include MeshBuilder
 #include "Primitives/MeshBuilder.h"
 
@@ -55,7 +58,7 @@ bool CCameraEffects::Init(void)
 	p2DMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), 1, 1, false);
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Default.tga", false);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Default.tga", false);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/GUI/CameraEffects_Default.tga" << endl;
@@ -17,6 +17,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 // Include MeshBuilder
 #include "Primitives/MeshBuilder.h"
 
@@ -65,7 +68,7 @@ bool CCrossHair::Init(void)
 														fAspectRatio, 1.0f);
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_CrossHair.tga", true);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_CrossHair.tga", true);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/GUI/CameraEffects_CrossHair.tga" << endl;
@@ -17,6 +17,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 // Include MeshBuilder
 #include "Primitives/MeshBuilder.h"
 
@@ -60,7 +63,7 @@ bool CScopeScreen::Init(void)
 	p2DMesh = CMeshBuilder::GenerateQuad(glm::vec4(1, 1, 1, 1), 1.0f, 1.0f, false);
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Scoped.tga", true);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/GUI/CameraEffects_Scoped.tga", true);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/GUI/CameraEffects_Scoped.tga" << endl;
@@ -14,6 +14,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CSpatialPartition
+#include "../SpatialPartition/SpatialPartition.h"
+
 #include <iostream>
 using namespace std;
 
@@ -108,8 +111,7 @@ CEnemy3D::~CEnemy3D(void)
 		cCamera = NULL;
 	}
 
-	// Delete the rendering objects in the graphics card
-	glDeleteVertexArrays(1, &VAO);
+	// The VAO is shared by all the CEnemy3D, so it is released by CSolidObject instead of deleted here
 }
 
 /**
@@ -127,14 +129,15 @@ bool CEnemy3D::Init(void)
 	// Initialise the cPlayer3D
 	cPlayer3D = CPlayer3D::GetInstance();
 
-	// Generate and bind the VAO
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	p3DMesh = CMeshBuilder::GenerateBox(glm::vec4(1, 1, 1, 1));
+	// Acquire the box and the texture which are shared by all the CEnemy3D.
+	// They are only created by the first CEnemy3D.
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	vSharedMeshes.push_back(cAssetRegistry->AcquireBox(glm::vec4(1, 1, 1, 1)));
+	VAO = vSharedMeshes.back()->uiVAO;
+	p3DMesh = vSharedMeshes.back()->p3DMesh;
 
-	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Enemy_01.tga", false);
+	vSharedTextures.push_back(cAssetRegistry->AcquireTexture("Image/Scene3D_Enemy_01.tga", false));
+	iTextureID = vSharedTextures.back()->uiTextureID;
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/Scene3D_Enemy_01.tga" << endl;
@@ -507,6 +510,15 @@ void CEnemy3D::Constraint(void)
 {
 	// Get the new height
 	float fNewYValue = cTerrainManager->GetHeight(vec3Position.x, vec3Position.z) + fHeightOffset;
+
+	// If there is a structure below this enemy which is higher than the terrain, then stand on it instead
+	float t;
+	CSolidObject* cSupport = NULL;
+	if ((CSpatialPartition::GetInstance()->RaycastDown(vec3Position, FLT_MAX, t, this, &cSupport) == true) &&
+		(t > 0.0f) && (cSupport->GetType() == CSolidObject::TYPE::STRUCTURE))
+	{
+		fNewYValue = glm::max(fNewYValue, vec3Position.y - t + fHeightOffset);
+	}
 	// Smooth out the change in height
 	vec3Position.y += (fNewYValue - vec3Position.y) * 0.05f;
 }
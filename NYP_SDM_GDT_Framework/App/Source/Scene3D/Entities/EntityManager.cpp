@@ -6,6 +6,9 @@
 
 #include "EntityManager.h"
 
+// Include CJobSystem
+#include "../../JobSystem/JobSystem.h"
+
 #include <iostream>
 using namespace std;
 
@@ -109,14 +112,18 @@ bool CEntityManager::Erase(CEntity3D* cEntity3D)
  */
 bool CEntityManager::Update(const double dElapsedTime)
 {
-	std::list<CEntity3D*>::iterator it, end;
+	// Copy the CEntity3D into an array, so that they can be split into ranges for the jobs
+	vUpdateEntity3D.assign(lEntity3D.begin(), lEntity3D.end());
 
-	// Update all CEntity3D
-	end = lEntity3D.end();
-	for (it = lEntity3D.begin(); it != end; ++it)
+	// Update all CEntity3D on the worker threads. Each CEntity3D only updates its own data.
+	CJobSystem::GetInstance()->ParallelFor((unsigned int)vUpdateEntity3D.size(), 1,
+		[this, dElapsedTime](const unsigned int uiBegin, const unsigned int uiEnd)
 	{
-		(*it)->Update(dElapsedTime);
-	}
+		for (unsigned int i = uiBegin; i < uiEnd; i++)
+		{
+			vUpdateEntity3D[i]->Update(dElapsedTime);
+		}
+	});
 
 	return true;
 }
@@ -18,6 +18,8 @@
 
 // Include list
 #include <list>
+// Include vector
+#include <vector>
 
 class CEntityManager : public CSingletonTemplate<CEntityManager>
 {
@@ -53,6 +55,8 @@ protected:
 
 	// List of CEntity3D
 	std::list<CEntity3D*> lEntity3D;
+	// The CEntity3D to update in this frame, stored as an array for the jobs
+	std::vector<CEntity3D*> vUpdateEntity3D;
 
 	// Default Constructor
 	CEntityManager(void);
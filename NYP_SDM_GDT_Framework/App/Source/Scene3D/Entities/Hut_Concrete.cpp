@@ -8,12 +8,6 @@
 // Include ShaderManager
 #include "RenderControl/ShaderManager.h"
 
- // Include LoadOBJ
-#include "System/LoadOBJ.h"
-
-// Include ImageLoader
-#include "System\ImageLoader.h"
-
 // Include CPlayer3D
 #include "../Entities/Player3D.h"
 
@@ -64,7 +58,7 @@ bool CHut_Concrete::Init(void)
 	{
 		if (LoadModelAndTexture("Models/Hut_Concrete/Hut_Concrete_H.obj", 
 								"Models/Hut_Concrete/Hut_Concrete_H.tga",
-								VAO, iTextureID, iIndicesSize) == false)
+								VAO, iTextureID, iIndicesSize, eIndexType) == false)
 		{
 			cout << "Unable to load model and texture" << endl;
 		}
@@ -73,19 +67,19 @@ bool CHut_Concrete::Init(void)
 	{
 		if (LoadModelAndTexture("Models/Hut_Concrete/Hut_Concrete_H.obj",
 								"Models/Hut_Concrete/Hut_Concrete_H.tga",
-								arrVAO[0], arriTextureID[0], arrIndicesSize[0]) == false)
+								arrVAO[0], arriTextureID[0], arrIndicesSize[0], arrIndexType[0]) == false)
 		{
 			cout << "Unable to load high LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Hut_Concrete/Hut_Concrete_M.obj",
 								"Models/Hut_Concrete/Hut_Concrete_M.tga",
-								arrVAO[1], arriTextureID[1], arrIndicesSize[1]) == false)
+								arrVAO[1], arriTextureID[1], arrIndicesSize[1], arrIndexType[1]) == false)
 		{
 			cout << "Unable to load mid LOD model and texture" << endl;
 		}
 		if (LoadModelAndTexture("Models/Hut_Concrete/Hut_Concrete_L.obj",
 								"Models/Hut_Concrete/Hut_Concrete_L.tga",
-								arrVAO[2], arriTextureID[2], arrIndicesSize[2]) == false)
+								arrVAO[2], arriTextureID[2], arrIndicesSize[2], arrIndexType[2]) == false)
 		{
 			cout << "Unable to load low LOD model and texture" << endl;
 		}
@@ -95,59 +89,42 @@ bool CHut_Concrete::Init(void)
 }
 
 /**
- @brief Load a model and texture
+ @brief Acquire a shared model and texture from the CAssetRegistry. They are loaded on the worker threads
+		by the first CHut_Concrete, and the VAO, iTextureID, iIndicesSize and eIndexType are set when they are uploaded.
  @param filenameModel A const char* variable containing the filename for the model
  @param filenameTexture A const char* variable containing the filename for the texture
  @param VAO A GLuint& variable containing the VAO to be returned
  @param iTextureID A GLuint& variable containing the iTextureID to be returned
  @param iIndicesSize A GLuint& variable containing the iIndicesSize to be returned
+ @param eIndexType A GLenum& variable containing the type of the indices to be returned
  @return A bool variable to indicate this method successfully completed its tasks
  */
 bool CHut_Concrete::LoadModelAndTexture(const char* filenameModel,
 										const char* filenameTexture,
 										GLuint& VAO,
 										GLuint& iTextureID,
-										GLuint& iIndicesSize)
+										GLuint& iIndicesSize,
+										GLenum& eIndexType)
 {
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> normals;
-	std::vector<ModelVertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-
-	std::string file_path = filenameModel;
-	bool success = CLoadOBJ::LoadOBJ(file_path.c_str(), vertices, uvs, normals, true);
-	if (!success)
+	GLuint* pVAO = &VAO;
+	GLuint* pTextureID = &iTextureID;
+	GLuint* pIndicesSize = &iIndicesSize;
+	GLenum* pIndexType = &eIndexType;
+
+	// Acquire the model and the texture which are shared by all the CHut_Concrete.
+	// They are only loaded by the first CHut_Concrete, and the callbacks are called when they are uploaded.
+	// This CHut_Concrete owns the callbacks, so they are removed if it releases the assets before that.
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	vSharedMeshes.push_back(cAssetRegistry->AcquireModel(filenameModel, this, [pVAO, pIndicesSize, pIndexType](const CAssetRegistry::SMesh& sMesh)
 	{
-		cout << "Unable to load " << filenameModel << endl;
-		return false;
-	}
-
-	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
-
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &IBO);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(ModelVertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-	iIndicesSize = index_buffer_data.size();
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID(filenameTexture, false);
-	if (iTextureID == 0)
+		*pVAO = sMesh.uiVAO;
+		*pIndicesSize = sMesh.uiNumOfIndices;
+		*pIndexType = sMesh.eIndexType;
+	}));
+	vSharedTextures.push_back(cAssetRegistry->AcquireTexture(filenameTexture, false, this, [pTextureID](const CAssetRegistry::STexture& sTexture)
 	{
-		cout << "Unable to load " << filenameTexture << endl;
-		return false;
-	}
+		*pTextureID = sTexture.uiTextureID;
+	}));
 
 	return true;
 }
@@ -16,6 +16,9 @@
 // Include Camera
 #include "../Camera.h"
 
+// Include CAssetRegistry
+#include "../../Assets/AssetRegistry.h"
+
 #include <string>
 using namespace std;
 
@@ -41,7 +44,8 @@ public:
 								const char* filenameTexture, 
 								GLuint& VAO, 
 								GLuint& iTextureID,
-								GLuint& iIndicesSize);
+								GLuint& iIndicesSize,
+								GLenum& eIndexType);
 
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
@@ -11,12 +11,18 @@
 // Include ImageLoader
 #include "System/ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 //For allowing creating of Mesh 
 #include "Primitives/MeshBuilder.h"
 
 // Include CSolidObjectManager
 #include "SolidObjectManager.h"
 
+// Include CSpatialPartition
+#include "../SpatialPartition/SpatialPartition.h"
+
 // Include this for glm::to_string() function
 #define GLM_ENABLE_EXPERIMENTAL
 #include <includes/gtx/string_cast.hpp>
@@ -136,7 +142,7 @@ bool CPlayer3D::Init(void)
 		1.0f, 1.0f, 1.0f);
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Player.tga", false);
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Player.tga", false);
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/Scene3D_Player.tga" << endl;
@@ -419,11 +425,12 @@ bool CPlayer3D::Update(const double dElapsedTime)
 			// If the player is below the terrain, then snap to the terrain height
 			if (vec3Position.y - fCheckHeight > 0.1f)
 			{
+				// Check only the entities in the player's grid for a surface to stand on
 				float param_t;
-				glm::vec3 rayDirection = glm::vec3(0.0f, -1.0f, 0.0f);
-				if (CSolidObjectManager::GetInstance()->CheckForCollision(	vec3Position, 
-																			rayDirection,
- 																			param_t) == true)
+				if (CSpatialPartition::GetInstance()->RaycastDown(	vec3Position,
+																	FLT_MAX,
+																	param_t,
+																	this) == true)
 				{
 					if (param_t > fHeightOffset)
 						cPhysics3D.SetStatus(CPhysics3D::STATUS::FALL);
@@ -4,10 +4,6 @@
  Date: Apr 2020
  */
 #include "Rock3D.h"
-#include "System/LoadOBJ.h"
-
- // Include ImageLoader
-#include "System\ImageLoader.h"
 
 // Include ShaderManager
 #include "RenderControl/ShaderManager.h"
@@ -15,6 +11,12 @@
 // Include CTerrainManager
 #include "../Terrain/TerrainManager.h"
 
+// Include CMeshSimplifier
+#include "../../Assets/MeshSimplifier.h"
+
+// Include CSpatialPartition
+#include "../SpatialPartition/SpatialPartition.h"
+
 #include <iostream>
 using namespace std;
 
@@ -26,7 +28,17 @@ CRock3D::CRock3D(void)
 	, iNumOfInstance(10)
 	, fSpreadDistance(5.0f)
 	, iIndicesSize(0)
+	, eIndexType(GL_UNSIGNED_INT)
+	, uiNumOfLODs(1)
 {
+	for (unsigned int i = 0; i < CInstanceBatch::uiMaxNumOfLODs; i++)
+	{
+		arrLODVAO[i] = 0;
+		arrLODIBO[i] = 0;
+		arrLODIndicesSize[i] = 0;
+		arrLODIndexType[i] = GL_UNSIGNED_INT;
+	}
+
 	// Set the default position to the origin
 	vec3Position = glm::vec3(0.0f, 0.0f, 0.0f);
 }
@@ -36,6 +48,8 @@ CRock3D::CRock3D(void)
  */
 CRock3D::~CRock3D(void)
 {
+	// Delete the VAOs and IBOs of the lower LODs. The first LOD is the VAO and IBO of the mesh.
+	CMeshSimplifier::DeleteLODs(CInstanceBatch::uiMaxNumOfLODs, arrLODVAO, arrLODIBO);
 }
 
 /**
@@ -50,21 +64,30 @@ bool CRock3D::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::OTHERS);
 
-	// Prepare to load the OBJ
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> normals;
-	
-	std::string file_path = "Models/rock/rock.obj";
-	bool success = CLoadOBJ::LoadOBJ(file_path.c_str(), vertices, uvs, normals, true);
-	if (!success)
+	// Load the OBJ and the texture on the worker threads.
+	// The mesh is uploaded to the graphics card on the main thread in InitMesh.
+	CAssetLoader* cAssetLoader = CAssetLoader::GetInstance();
+	cAssetLoader->LoadMesh("Models/rock/rock.obj", [this](const CAssetLoader::SMeshData& sMeshData)
+	{
+		InitMesh(sMeshData);
+	});
+	cAssetLoader->LoadTexture("Models/rock/rock.png", false, [this](const GLuint uiTextureID)
+	{
+		iTextureID = uiTextureID;
+	});
+
+	return true;
+}
+
+/**
+ @brief Upload the mesh to the graphics card. This is called on the main thread when the OBJ is loaded.
+ @param sMeshData A const CAssetLoader::SMeshData& variable containing the vertices and indices of the mesh
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CRock3D::InitMesh(const CAssetLoader::SMeshData& sMeshData)
+{
+	if ((sMeshData.bSuccess == false) || (sMeshData.uiNumOfIndices == 0))
 		return false;
-	
-	// Load the vertices and indices
-	std::vector<ModelVertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
-	iIndicesSize = index_buffer_data.size();
 
 	// Load the data to the graphics card
 	glGenVertexArrays(1, &VAO);
@@ -73,10 +96,11 @@ bool CRock3D::Init(void)
 	glGenBuffers(1, &IBO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(ModelVertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, sMeshData.GetVertexBufferSize(), sMeshData.pVertices, GL_STATIC_DRAW);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-	iIndicesSize = index_buffer_data.size();
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sMeshData.GetIndexBufferSize(), sMeshData.pIndices, GL_STATIC_DRAW);
+	iIndicesSize = sMeshData.uiNumOfIndices;
+	eIndexType = sMeshData.eIndexType;
 
 	// Load the details to the shader program in the graphics card
 	// We can customised for instanced rendering or normal rendering here.
@@ -102,31 +126,30 @@ bool CRock3D::Init(void)
 		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
-	// Load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Models/rock/rock.png", false);
-	if (iTextureID == 0)
-	{
-		cout << "Unable to load Models/rock/rock.png" << endl;
-		return false;
-	}
-
 	if (bInstancedRendering)
 	{
 		// Generate the list of transformation matrices which 
 		// indicates where each instance will be at, and its orientation
-		glm::mat4* modelMatrices = new glm::mat4[iNumOfInstance];
+		vector<glm::mat4> modelMatrices(iNumOfInstance);
 
 		// Initialize random seed
 		srand((unsigned int)glfwGetTime());
 
+		// 1. Randomly disperse the rocks in a rectangular area, and get the heights of the terrain under all of them at once
+		vector<float> vX(iNumOfInstance), vY(iNumOfInstance), vZ(iNumOfInstance);
+		for (unsigned int i = 0; i < iNumOfInstance; i++)
+		{
+			vX[i] = vec3Position.x + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
+			vZ[i] = vec3Position.z + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
+		}
+		if (iNumOfInstance > 0)
+			CTerrainManager::GetInstance()->GetHeights(&vX[0], &vZ[0], &vY[0], iNumOfInstance);
+
 		for (unsigned int i = 0; i < iNumOfInstance; i++)
 		{
 			glm::mat4 model = glm::mat4(1.0f);
-			// 1. Use Translation to randomly disperse the rocks in a rectangular area
-			float x = vec3Position.x + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
-			float z = vec3Position.z + (rand() % 100) * fSpreadDistance * 0.01f - fSpreadDistance * 0.5f;
-			float y = CTerrainManager::GetInstance()->GetHeight(x, z);
-			model = glm::translate(model, glm::vec3(x, y, z));
+			// Use Translation to move the rocks to their positions on the terrain
+			model = glm::translate(model, glm::vec3(vX[i], vY[i], vZ[i]));
 
 			// 2. Use scaling to create rocks of various sizes
 			float scale = (rand() % 100) * 0.0005f + 0.01f;
@@ -142,38 +165,28 @@ bool CRock3D::Init(void)
 			modelMatrices[i] = model;
 		}
 
+		// Create the lower LODs, which use the VBO of the mesh with their own simplified indices
+		arrLODVAO[0] = VAO;
+		arrLODIBO[0] = IBO;
+		arrLODIndicesSize[0] = iIndicesSize;
+		arrLODIndexType[0] = eIndexType;
+		const unsigned int uiNumOfCreatedLODs = CMeshSimplifier::CreateLODs(sMeshData, VBO,
+			(uiNumOfLODs < CInstanceBatch::uiMaxNumOfLODs ? uiNumOfLODs : CInstanceBatch::uiMaxNumOfLODs),
+			arrLODVAO, arrLODIBO, arrLODIndicesSize, arrLODIndexType);
+
 		// configure instanced array
 		// -------------------------
-		unsigned int buffer;
-		glGenBuffers(1, &buffer);
-		glBindBuffer(GL_ARRAY_BUFFER, buffer);
-		glBufferData(GL_ARRAY_BUFFER, iNumOfInstance * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
-		// Delete the array of modelMatrices since we had already uploaded it to the graphics card
-		delete[] modelMatrices;
-
-		// Set transformation matrices as an instance vertex attribute (with divisor 1)
-		// We simplify our codes by loading the VAO as well
-		// Use the loop for multiple VAOs for this rendering pass
-		for (unsigned int i = 0; i < 1; i++)
-		{
-			glBindVertexArray(VAO);
-			// set attribute pointers for matrix (4 times vec4)
-			glEnableVertexAttribArray(3);
-			glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)0);
-			glEnableVertexAttribArray(4);
-			glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4)));
-			glEnableVertexAttribArray(5);
-			glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(2 * sizeof(glm::vec4)));
-			glEnableVertexAttribArray(6);
-			glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(3 * sizeof(glm::vec4)));
-
-			glVertexAttribDivisor(3, 1);
-			glVertexAttribDivisor(4, 1);
-			glVertexAttribDivisor(5, 1);
-			glVertexAttribDivisor(6, 1);
-
-			glBindVertexArray(0);
-		}
+		// The model matrices of the instances which are visible in each Render are uploaded to the
+		// buffers of cInstanceBatch, one for each LOD, which are set as the instance vertex attributes
+		// (with divisor 1) of the VAO of that LOD
+		// The instances are sorted into chunks which are aligned with the CGrids of the CSpatialPartition,
+		// so that the instances of a chunk which is outside of the frustum are culled together
+		CSpatialPartition* cSpatialPartition = CSpatialPartition::GetInstance();
+		cInstanceBatch.SetChunks(	cSpatialPartition->GetBottomLeft(), cSpatialPartition->GetGridSize(),
+									cSpatialPartition->GetNumOfGrids().x, cSpatialPartition->GetNumOfGrids().z);
+		cInstanceBatch.Init(modelMatrices, sMeshData.vec3BoundsMin, sMeshData.vec3BoundsMax, uiNumOfCreatedLODs);
+		for (unsigned int i = 0; i < cInstanceBatch.GetNumOfLODs(); i++)
+			cInstanceBatch.SetupVertexArray(arrLODVAO[i], 3, i);
 	}
 
 	return true;
@@ -206,6 +219,25 @@ void CRock3D::SetSpreadDistance(const float fSpreadDistance)
 	this->fSpreadDistance = fSpreadDistance;
 }
 
+/**
+ @brief Set the number of LODs of the instances. The lower LODs are simplified from the mesh when it is loaded.
+ @param uiNumOfLODs A const unsigned int containing the number of LODs, from 1 to CInstanceBatch::uiMaxNumOfLODs
+ */
+void CRock3D::SetNumOfLODs(const unsigned int uiNumOfLODs)
+{
+	this->uiNumOfLODs = uiNumOfLODs;
+}
+
+/**
+ @brief Set the distances to the camera from which the instances use the mid and the low LOD
+ @param fMidDistance A const float containing the distance from which the instances use the mid LOD
+ @param fLowDistance A const float containing the distance from which the instances use the low LOD
+ */
+void CRock3D::SetLODDistances(const float fMidDistance, const float fLowDistance)
+{
+	cInstanceBatch.SetLODDistances(fMidDistance, fLowDistance);
+}
+
 /**
  @brief Update the elapsed time
  @param dt A const double variable containing the elapsed time since the last frame
@@ -249,16 +281,24 @@ void CRock3D::Render(void)
 		CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
 		CShaderManager::GetInstance()->activeShader->setMat4("view", view);
 
+		// Cull the instances against the frustum of this view and projection, so that the minimap
+		// and the main view only draw the instances which they can see
+		cInstanceBatch.Cull(view, projection);
+
 		// draw rocks
 		CShaderManager::GetInstance()->activeShader->setInt("texture_diffuse1", 0);
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, iTextureID); // note: we also made the textures_loaded vector public (instead of private) from the model class.
 		
-		// We instanced render the rock. if you have multiple VAOs, then you can render them using this loop
-		for (unsigned int i = 0; i < 1; i++)
+		// We instanced render the rock with one draw for each LOD, which uses the VAO and the instance buffer of that LOD
+		for (unsigned int i = 0; i < cInstanceBatch.GetNumOfLODs(); i++)
 		{
-			glBindVertexArray(VAO);
-			glDrawElementsInstanced(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0, iNumOfInstance);
+			const unsigned int uiNumOfVisibleInstances = cInstanceBatch.GetNumOfVisibleInstances(i);
+			if (uiNumOfVisibleInstances == 0)
+				continue;
+
+			glBindVertexArray(arrLODVAO[i]);
+			glDrawElementsInstanced(GL_TRIANGLES, arrLODIndicesSize[i], arrLODIndexType[i], 0, uiNumOfVisibleInstances);
 			glBindVertexArray(0);
 		}
 		glBindTexture(GL_TEXTURE_2D, 0);
@@ -276,7 +316,7 @@ void CRock3D::Render(void)
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, iTextureID);
 			glBindVertexArray(VAO);
-				glDrawElements(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0);
+				glDrawElements(GL_TRIANGLES, iIndicesSize, eIndexType, 0);
 			glBindVertexArray(0);
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
@@ -290,6 +330,15 @@ void CRock3D::PostRender(void)
 	glDepthFunc(GL_LESS); // set depth function back to default
 }
 
+/**
+ @brief Get the number of instances which were drawn in the last Render
+ @return A unsigned int variable
+ */
+unsigned int CRock3D::GetNumOfVisibleInstances(void) const
+{
+	return cInstanceBatch.GetNumOfVisibleInstances();
+}
+
 /**
  @brief Print Self
  */
@@ -297,4 +346,5 @@ void CRock3D::PrintSelf(void)
 {
 	cout << "CRock3D::PrintSelf()" << endl;
 	cout << "========================" << endl;
+	cInstanceBatch.PrintSelf();
 }
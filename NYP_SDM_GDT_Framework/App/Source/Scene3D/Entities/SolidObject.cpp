@@ -24,6 +24,10 @@ CSolidObject::CSolidObject(void)
 {
 	// Set iIndicesSize to 0
 	iIndicesSize = 0;
+	// Set the types of the indices
+	eIndexType = GL_UNSIGNED_INT;
+	for (unsigned int i = 0; i < 3; i++)
+		arrIndexType[i] = GL_UNSIGNED_INT;
 
 	// Set the default position to the origin
 	vec3Position = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -37,6 +41,11 @@ CSolidObject::CSolidObject(void)
 CSolidObject::CSolidObject(	const glm::vec3 vec3Position,
 							const glm::vec3 vec3Front)
 {
+	// Set the types of the indices
+	eIndexType = GL_UNSIGNED_INT;
+	for (unsigned int i = 0; i < 3; i++)
+		arrIndexType[i] = GL_UNSIGNED_INT;
+
 	// Set the default position to the origin
 	this->vec3Position = vec3Position;
 	this->vec3Front = vec3Front;
@@ -47,6 +56,7 @@ CSolidObject::CSolidObject(	const glm::vec3 vec3Position,
  */
 CSolidObject::~CSolidObject(void)
 {
+	ReleaseSharedAssets();
 }
 
 /**
@@ -122,7 +132,7 @@ void CSolidObject::Render(void)
 		if (p3DMesh)
 			p3DMesh->Render();
 		else
-			glDrawElements(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, iIndicesSize, eIndexType, 0);
 		glBindVertexArray(0);
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
@@ -134,7 +144,7 @@ void CSolidObject::Render(void)
 		glBindTexture(GL_TEXTURE_2D, arriTextureID[eDetailLevel]);
 		// Render the p3DMesh
 		glBindVertexArray(arrVAO[eDetailLevel]);
-			glDrawElements(GL_TRIANGLES, arrIndicesSize[eDetailLevel], GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, arrIndicesSize[eDetailLevel], arrIndexType[eDetailLevel], 0);
 		glBindVertexArray(0);
 		glBindTexture(GL_TEXTURE_2D, 0);
 	}
@@ -167,3 +177,30 @@ void CSolidObject::PrintSelf(void)
 	cout << "CSolidObject::PrintSelf()" << endl;
 	cout << "========================" << endl;
 }
+
+/**
+ @brief Release the shared meshes and textures. The VAOs, meshes and textures of this object
+		are cleared too, so that they are not deleted again when this object is destroyed.
+ */
+void CSolidObject::ReleaseSharedAssets(void)
+{
+	if ((vSharedMeshes.empty() == true) && (vSharedTextures.empty() == true))
+		return;
+
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	for (unsigned int i = 0; i < vSharedMeshes.size(); i++)
+		cAssetRegistry->Release(vSharedMeshes[i], this);
+	vSharedMeshes.clear();
+	for (unsigned int i = 0; i < vSharedTextures.size(); i++)
+		cAssetRegistry->Release(vSharedTextures[i], this);
+	vSharedTextures.clear();
+
+	VAO = 0;
+	p3DMesh = NULL;
+	iTextureID = 0;
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		arrVAO[i] = 0;
+		arriTextureID[i] = 0;
+	}
+}
@@ -14,12 +14,16 @@
 // Include LevelOfDetails
 #include "Primitives/LevelOfDetails.h"
 
+// Include CAssetRegistry
+#include "../../Assets/AssetRegistry.h"
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
 #include <string>
+#include <vector>
 using namespace std;
 
 // An abstract camera class that processes input and calculates the corresponding Euler Angles, Vectors and Matrices for use in OpenGL
@@ -58,4 +62,15 @@ public:
 	virtual void PrintSelf(void);
 
 protected:
+	// The type of the indices, which is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	GLenum eIndexType;
+	// The type of the indices for each level of detail
+	GLenum arrIndexType[3];
+
+	// The shared meshes and textures which this object acquired from the CAssetRegistry
+	std::vector<CAssetRegistry::SMesh*> vSharedMeshes;
+	std::vector<CAssetRegistry::STexture*> vSharedTextures;
+
+	// Release the shared meshes and textures
+	void ReleaseSharedAssets(void);
 };
@@ -15,6 +15,9 @@
 // Include CPlayer3D
 #include "Player3D.h"
 
+// Include CSpatialPartition
+#include "../SpatialPartition/SpatialPartition.h"
+
 #include <limits>
 #include <algorithm>
 
@@ -243,82 +246,89 @@ bool CSolidObjectManager::CheckForCollision(void)
 	//	}
 	//}
 
-	// Check for collisions between entities and projectiles
-	end = lSolidObject.end();
-	for (it = lSolidObject.begin(); it != end; ++it)
+	// Check for collisions between entities and projectiles.
+	// Only the active projectiles are checked, since they are packed at the front of the pool.
+	unsigned int i = 0;
+	while (i < cProjectileManager->GetNumOfActive())
 	{
-		// If the entity is not active, then skip it
-		if ((*it)->GetStatus() == false)
-			continue;
-
-		for (unsigned int i = 0; i < cProjectileManager->vProjectile.size(); i++)
+		// Get the grids which the projectile had passed through in this frame
+		CSpatialPartition::GetInstance()->GetGridsAlongSegment(cProjectileManager->GetPreviousPosition(i),
+																cProjectileManager->GetPosition(i),
+																vGridsAlongSegment);
+
+		// Collect the active entities in these grids only
+		vCheckedSolidObjects.clear();
+		setCheckedSolidObjects.clear();
+		sBoxBatch.Clear();
+		for (unsigned int j = 0; j < vGridsAlongSegment.size(); j++)
 		{
-			// If the entity is not active, then skip it
-			if ((cProjectileManager->vProjectile[i])->GetStatus() == false)
-				continue;
-
-			// Use ray tracing to check for collisions between the 2 entities
-			if (CCollisionManager::RayBoxCollision((*it)->GetPosition() + (*it)->boxMin,
-				(*it)->GetPosition() + (*it)->boxMax,
-				(cProjectileManager->vProjectile[i])->GetPreviousPosition(),
-				(cProjectileManager->vProjectile[i])->GetPosition()))
+			std::map<unsigned int, CSolidObject*>::iterator it_grid, end_grid;
+			end_grid = vGridsAlongSegment[j]->SolidObjectMap.end();
+			for (it_grid = vGridsAlongSegment[j]->SolidObjectMap.begin(); it_grid != end_grid; ++it_grid)
 			{
-				if ((*it)->GetType() == CSolidObject::TYPE::PLAYER)
-				{
-					// If this projectile is fired by the player, then skip it
-					if ((cProjectileManager->vProjectile[i])->GetSource() == (*it))
-						continue;
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** RayBoxCollision between Player and Projectile ***" << endl;
-					bResult = true;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::NPC)
-				{
-					// If this projectile is fired by the NPC, then skip it
-					if ((cProjectileManager->vProjectile[i])->GetSource() == (*it))
-						continue;
-					(*it)->SetStatus(false);
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** RayBoxCollision between NPC and Projectile ***" << endl;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::STRUCTURE)
-				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** RayBoxCollision between Structure and Projectile ***" << endl;
-					break;
-				}
+				// If the entity is not active, then skip it
+				if (it_grid->second->GetStatus() == false)
+					continue;
+
+				// An entity may be in several grids, so only check it once
+				if (setCheckedSolidObjects.insert(it_grid->second).second == false)
+					continue;
+				vCheckedSolidObjects.push_back(it_grid->second);
+				sBoxBatch.Add(it_grid->second->GetPosition() + it_grid->second->boxMin,
+								it_grid->second->GetPosition() + it_grid->second->boxMax);
 			}
+		}
 
-			// Check for collisions between the 2 entities
-			if (CCollisionManager::BoxBoxCollision((*it)->GetPosition() + (*it)->boxMin,
-				(*it)->GetPosition() + (*it)->boxMax,
-				(cProjectileManager->vProjectile[i])->GetPosition() + (cProjectileManager->vProjectile[i])->boxMin,
-				(cProjectileManager->vProjectile[i])->GetPosition() + (cProjectileManager->vProjectile[i])->boxMax) == true)
+		if (vCheckedSolidObjects.empty())
+		{
+			i++;
+			continue;
+		}
+
+		// Use ray tracing to check the projectile's segment in this frame against all the entities at once
+		vRayT.resize(vCheckedSolidObjects.size());
+		CCollisionBatch::RayBoxBatch(	cProjectileManager->GetPreviousPosition(i),
+										cProjectileManager->GetPosition(i) - cProjectileManager->GetPreviousPosition(i),
+										1.0f,
+										sBoxBatch,
+										&vRayT[0]);
+
+		// Resolve the entities which the segment hits, starting from the nearest one.
+		// An entity is skipped if it fired this projectile, so try the next nearest entity.
+		bool bHit = false;
+		while (bHit == false)
+		{
+			unsigned int uiNearest = (unsigned int)vCheckedSolidObjects.size();
+			float fNearestT = FLT_MAX;
+			for (unsigned int j = 0; j < vCheckedSolidObjects.size(); j++)
 			{
-				if ((*it)->GetType() == CSolidObject::TYPE::PLAYER)
+				// A t of less than 0 means that the entity had been resolved
+				if ((vRayT[j] >= 0.0f) && (vRayT[j] < fNearestT))
 				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** BoxBoxCollision between Player and Projectile ***" << endl;
-					bResult = true;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::NPC)
-				{
-					(*it)->SetStatus(false);
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** BoxBoxCollision between NPC and Projectile ***" << endl;
-					break;
-				}
-				else if ((*it)->GetType() == CSolidObject::TYPE::STRUCTURE)
-				{
-					(cProjectileManager->vProjectile[i])->SetStatus(false);
-					cout << "** BoxBoxCollision between Structure and Projectile ***" << endl;
-					break;
+					fNearestT = vRayT[j];
+					uiNearest = j;
 				}
 			}
+			if (uiNearest == vCheckedSolidObjects.size())
+				break;
+
+			bHit = CheckForCollision(vCheckedSolidObjects[uiNearest], i, true, bResult);
+			// This entity had been resolved, so do not check it again
+			vRayT[uiNearest] = -1.0f;
+		}
+
+		// If the segment did not hit anything, then check if the projectile is overlapping an entity
+		// which the segment had missed
+		for (unsigned int j = 0; (bHit == false) && (j < vCheckedSolidObjects.size()); j++)
+		{
+			if (vRayT[j] == FLT_MAX)
+				bHit = CheckForCollision(vCheckedSolidObjects[j], i, false, bResult);
 		}
+
+		// If the projectile was deactivated, then the last projectile was moved into this index,
+		// so check this index again
+		if (bHit == false)
+			i++;
 	}
 	
 	if (bResult == true)
@@ -329,6 +339,82 @@ bool CSolidObjectManager::CheckForCollision(void)
 	return true;
 }
 
+/**
+ @brief Collision Check for an entity and a projectile
+ @param cSolidObject A CSolidObject* variable storing the entity
+ @param uiProjectile A const unsigned int variable containing the index of the projectile in the CProjectileManager
+ @param bRayHit A const bool variable which is true if the projectile's segment in this frame hits the entity
+ @param bResult A bool& variable which is set to true if the player was hit
+ @return A bool variable to indicate if there is a collision. The projectile is deactivated if this is true.
+ */
+bool CSolidObjectManager::CheckForCollision(CSolidObject* cSolidObject, const unsigned int uiProjectile, const bool bRayHit, bool& bResult)
+{
+	// If the entity is not active, then skip it
+	if (cSolidObject->GetStatus() == false)
+		return false;
+
+	// Use the result of the batch ray test between the 2 entities
+	if (bRayHit)
+	{
+		if (cSolidObject->GetType() == CSolidObject::TYPE::PLAYER)
+		{
+			// If this projectile is fired by the player, then skip it
+			if (cProjectileManager->GetSource(uiProjectile) == cSolidObject)
+				return false;
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** RayBoxCollision between Player and Projectile ***" << endl;
+			bResult = true;
+			return true;
+		}
+		else if (cSolidObject->GetType() == CSolidObject::TYPE::NPC)
+		{
+			// If this projectile is fired by the NPC, then skip it
+			if (cProjectileManager->GetSource(uiProjectile) == cSolidObject)
+				return false;
+			cSolidObject->SetStatus(false);
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** RayBoxCollision between NPC and Projectile ***" << endl;
+			return true;
+		}
+		else if (cSolidObject->GetType() == CSolidObject::TYPE::STRUCTURE)
+		{
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** RayBoxCollision between Structure and Projectile ***" << endl;
+			return true;
+		}
+	}
+
+	// Check for collisions between the 2 entities
+	if (CCollisionManager::BoxBoxCollision(cSolidObject->GetPosition() + cSolidObject->boxMin,
+		cSolidObject->GetPosition() + cSolidObject->boxMax,
+		cProjectileManager->GetPosition(uiProjectile) + cProjectileManager->GetBoxMin(),
+		cProjectileManager->GetPosition(uiProjectile) + cProjectileManager->GetBoxMax()) == true)
+	{
+		if (cSolidObject->GetType() == CSolidObject::TYPE::PLAYER)
+		{
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** BoxBoxCollision between Player and Projectile ***" << endl;
+			bResult = true;
+			return true;
+		}
+		else if (cSolidObject->GetType() == CSolidObject::TYPE::NPC)
+		{
+			cSolidObject->SetStatus(false);
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** BoxBoxCollision between NPC and Projectile ***" << endl;
+			return true;
+		}
+		else if (cSolidObject->GetType() == CSolidObject::TYPE::STRUCTURE)
+		{
+			cProjectileManager->Deactivate(uiProjectile);
+			cout << "** BoxBoxCollision between Structure and Projectile ***" << endl;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /**
  @brief Collision Check for a ray from the player against all solid objects
  @param rayOrigin A const glm::vec3 which stores the ray origin
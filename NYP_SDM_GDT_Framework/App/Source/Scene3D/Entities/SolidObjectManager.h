@@ -9,6 +9,9 @@
 // Include CProjectileManager
 #include "../WeaponInfo/ProjectileManager.h"
 
+// Include CCollisionBatch
+#include "../SpatialPartition/CollisionBatch.h"
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
@@ -16,6 +19,12 @@
 
 // Include list
 #include <list>
+// Include vector
+#include <vector>
+// Include unordered_set
+#include <unordered_set>
+
+class CGrid;
 
 class CSolidObjectManager : public CSingletonTemplate<CSolidObjectManager>
 {
@@ -70,6 +79,20 @@ protected:
 	// Handler to the CProjectileManager
 	CProjectileManager* cProjectileManager;
 
+	// The grids which a projectile had passed through
+	std::vector<CGrid*> vGridsAlongSegment;
+	// The entities which had been checked against a projectile
+	std::vector<CSolidObject*> vCheckedSolidObjects;
+	// The same entities as vCheckedSolidObjects, to find the entities which are in several grids
+	std::unordered_set<CSolidObject*> setCheckedSolidObjects;
+	// The bounding boxes of vCheckedSolidObjects, for the batch ray test
+	CCollisionBatch::SBoxBatch sBoxBatch;
+	// The t of the projectile's segment for each box in sBoxBatch
+	std::vector<float> vRayT;
+
+	// Collision Check for an entity and a projectile
+	bool CheckForCollision(CSolidObject* cSolidObject, const unsigned int uiProjectile, const bool bRayHit, bool& bResult);
+
 	// Default Constructor
 	CSolidObjectManager(void);
 	// Destructor
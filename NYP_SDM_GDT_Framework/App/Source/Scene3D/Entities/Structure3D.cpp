@@ -59,14 +59,15 @@ bool CStructure3D::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::STRUCTURE);
 
-	// Generate and bind the VAO
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	p3DMesh = CMeshBuilder::GenerateBox(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
-
-	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Structure_01.tga", false);
+	// Acquire the box and the texture which are shared by all the CStructure3D.
+	// They are only created by the first CStructure3D.
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	vSharedMeshes.push_back(cAssetRegistry->AcquireBox(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)));
+	VAO = vSharedMeshes.back()->uiVAO;
+	p3DMesh = vSharedMeshes.back()->p3DMesh;
+
+	vSharedTextures.push_back(cAssetRegistry->AcquireTexture("Image/Scene3D_Structure_01.tga", false));
+	iTextureID = vSharedTextures.back()->uiTextureID;
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/Scene3D_Structure_01.tga" << endl;
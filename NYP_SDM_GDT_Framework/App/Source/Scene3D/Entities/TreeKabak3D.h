@@ -16,6 +16,12 @@
 // Include Camera
 #include "../Camera.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
+// Include CInstanceBatch
+#include "../SpatialPartition/InstanceBatch.h"
+
 #include <string>
 using namespace std;
 
@@ -44,6 +50,10 @@ public:
 	virtual void SetNumOfInstance(const unsigned int iNumOfInstance);
 	// Set the spread distance
 	virtual void SetSpreadDistance(const float fSpreadDistance);
+	// Set the number of LODs of the instances
+	virtual void SetNumOfLODs(const unsigned int uiNumOfLODs);
+	// Set the distances to the camera from which the instances use the mid and the low LOD
+	virtual void SetLODDistances(const float fMidDistance, const float fLowDistance);
 
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
@@ -58,6 +68,9 @@ public:
 	// Get the bInstancedRendering
 	bool IsInstancedRendering(void) { return bInstancedRendering; }
 
+	// Get the number of instances which were drawn in the last Render
+	unsigned int GetNumOfVisibleInstances(void) const;
+
 	// Print Self
 	virtual void PrintSelf(void);
 
@@ -66,8 +79,25 @@ protected:
 	unsigned int iNumOfInstance;
 	float fSpreadDistance;
 	unsigned int iIndicesSize;
+	// The type of the indices, which is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	GLenum eIndexType;
 
 	// Bool flag to indicate if you want to use Instanced Rendering, or use normal rendering for debugging purpose.
 	// true == Instanced Rendering, false == normal rendering.
 	bool bInstancedRendering;
+
+	// The instances, which are culled against the frustum of each Render
+	CInstanceBatch cInstanceBatch;
+
+	// The number of LODs of the instances
+	unsigned int uiNumOfLODs;
+	// The VAOs, IBOs and indices of the LODs. The first LOD is the mesh, and the lower LODs are
+	// simplified from it. They use the VBO of the mesh with their own indices.
+	GLuint arrLODVAO[CInstanceBatch::uiMaxNumOfLODs];
+	GLuint arrLODIBO[CInstanceBatch::uiMaxNumOfLODs];
+	unsigned int arrLODIndicesSize[CInstanceBatch::uiMaxNumOfLODs];
+	GLenum arrLODIndexType[CInstanceBatch::uiMaxNumOfLODs];
+
+	// Upload the mesh to the graphics card
+	bool InitMesh(const CAssetLoader::SMeshData& sMeshData);
 };
@@ -304,6 +304,36 @@ bool CGUI_Scene3D::Update(const double dElapsedTime)
 	return true;
 }
 
+/**
+ @brief Update the loading screen, which shows the fraction of the assets which are loaded
+ @param fProgress A const float variable containing the fraction of the assets which are loaded, from 0.0 to 1.0
+ */
+bool CGUI_Scene3D::UpdateLoading(const float fProgress)
+{
+	// Calculate the relative scale to our default windows width
+	const float relativeScale_x = cSettings->iWindowWidth / 800.0f;
+	const float relativeScale_y = cSettings->iWindowHeight / 600.0f;
+
+	// Start the Dear ImGui frame
+	ImGui_ImplOpenGL3_NewFrame();
+	ImGui_ImplGlfw_NewFrame();
+	ImGui::NewFrame();
+
+	// Create an invisible window which covers the entire OpenGL window
+	ImGui::Begin("Invisible window", NULL, window_flags);
+	ImGui::SetWindowPos(ImVec2(0.0f, 0.0f));
+	ImGui::SetWindowSize(ImVec2((float)cSettings->iWindowWidth, (float)cSettings->iWindowHeight));
+	ImGui::SetWindowFontScale(1.5f * relativeScale_y);
+
+	// Display the progress in the middle of the screen
+	ImGui::SetCursorPos(ImVec2(cSettings->iWindowWidth * 0.3f, cSettings->iWindowHeight * 0.45f));
+	ImGui::TextColored(ImVec4(1, 1, 0, 1), "Loading... %d%%", (int)(fProgress * 100.0f));
+	ImGui::SetCursorPosX(cSettings->iWindowWidth * 0.3f);
+	ImGui::ProgressBar(fProgress, ImVec2(cSettings->iWindowWidth * 0.4f, 20.0f * relativeScale_y));
+	ImGui::End();
+
+	return true;
+}
 
 /**
  @brief Set up the OpenGL display environment before rendering
@@ -347,6 +377,16 @@ void CGUI_Scene3D::Render(void)
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 }
 
+/**
+ @brief Render the loading screen
+ */
+void CGUI_Scene3D::RenderLoading(void)
+{
+	// Rendering
+	ImGui::Render();
+	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+}
+
 /**
  @brief PostRender Set up the OpenGL display environment after rendering.
  */
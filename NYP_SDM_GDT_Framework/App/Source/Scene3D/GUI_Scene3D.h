@@ -60,12 +60,16 @@ public:
 
 	// Update
 	bool Update(const double dElapsedTime);
+	// Update the loading screen, which shows the fraction of the assets which are loaded
+	bool UpdateLoading(const float fProgress);
 
 	// PreRender
 	virtual void PreRender(void);
 
 	// Render
 	virtual void Render(void);
+	// Render the loading screen
+	void RenderLoading(void);
 
 	// PostRender
 	virtual void PostRender(void);
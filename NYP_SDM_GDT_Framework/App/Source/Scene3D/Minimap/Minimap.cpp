@@ -11,6 +11,9 @@
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 #include <iostream>
 using namespace std;
 
@@ -150,7 +153,7 @@ bool CMinimap::Init(void)
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(7 * sizeof(float)));
 
 	// load and create a texture 
-	iArrowTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Minimap_Arrow.png", true);
+	iArrowTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/Minimap_Arrow.png", true);
 	if (iArrowTextureID == 0)
 	{
 		cout << "Unable to load Image/Minimap_Arrow.png" << endl;
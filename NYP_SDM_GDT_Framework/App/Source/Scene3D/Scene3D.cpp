@@ -49,12 +49,25 @@ CScene3D::CScene3D(void)
 	, cMouseController(NULL)
 	, cFPSCounter(NULL)
 	, cGUI_Scene3D(NULL)
+	, cEntityManager(NULL)
+	, cRock3D(NULL)
+	, cTreeKabak3D(NULL)
 	, cSolidObjectManager(NULL)
 	, cPlayer3D(NULL)
 	, cCamera(NULL)
 	, cSkyBox(NULL)
 	, cTerrainManager(NULL)
 	, cSpatialPartition(NULL)
+	, cJobSystem(NULL)
+	, cAssetLoader(NULL)
+	, bLoading(false)
+	, dAssetUploadBudget(4.0)
+	, cAssetRegistry(NULL)
+#ifdef _DEBUG
+	, bDebugKeys(true)
+#else
+	, bDebugKeys(false)
+#endif
 {
 }
 
@@ -63,6 +76,20 @@ CScene3D::CScene3D(void)
  */
 CScene3D::~CScene3D(void)
 {
+	// Destroy the cAssetLoader before the cJobSystem, since it waits for its jobs
+	if (cAssetLoader)
+	{
+		cAssetLoader->Destroy();
+		cAssetLoader = NULL;
+	}
+
+	// Destroy the cJobSystem
+	if (cJobSystem)
+	{
+		cJobSystem->Destroy();
+		cJobSystem = NULL;
+	}
+
 	// Destroy the Spatial Partition
 	if (cSpatialPartition)
 	{
@@ -97,6 +124,9 @@ CScene3D::~CScene3D(void)
 		cEntityManager->Destroy();
 		cEntityManager = NULL;
 	}
+	// The cRock3D and cTreeKabak3D were deleted by the cEntityManager
+	cRock3D = NULL;
+	cTreeKabak3D = NULL;
 
 	// Destroy the cProjectileManager
 	if (cProjectileManager)
@@ -127,6 +157,13 @@ CScene3D::~CScene3D(void)
 		cGUI_Scene3D = NULL;
 	}
 
+	// Destroy the cAssetRegistry after all the entities, since they release their assets to it
+	if (cAssetRegistry)
+	{
+		cAssetRegistry->Destroy();
+		cAssetRegistry = NULL;
+	}
+
 	// We won't delete this since it was created elsewhere
 	cFPSCounter = NULL;
 
@@ -166,6 +203,20 @@ bool CScene3D::Init(void)
 	// Store the CFPSCounter singleton instance here
 	cFPSCounter = CFPSCounter::GetInstance();
 
+	// Start the worker threads of the CJobSystem
+	cJobSystem = CJobSystem::GetInstance();
+	cJobSystem->Init();
+
+	// Start the CAssetLoader. The models and textures are loaded in the background from here on,
+	// and the scene is in the loading state until all of them are uploaded.
+	cAssetLoader = CAssetLoader::GetInstance();
+	cAssetLoader->Init();
+	bLoading = true;
+
+	// Start the CAssetRegistry, which shares the meshes and textures between the entities
+	cAssetRegistry = CAssetRegistry::GetInstance();
+	cAssetRegistry->Init();
+
 	// Load the Environment Entities
 	// Load the SkyBox
 	cSkyBox = CSkyBox::GetInstance();
@@ -214,12 +265,13 @@ bool CScene3D::Init(void)
 	cTerrainManager->Add("Shader3D_Terrain",
 						"Image/Terrain/World/terrain.bmp",
 						100.0f, 5.0f, 100.0f);
-	//cTerrainManager->Add("Shader3D_Terrain",
-	//					"Image/Terrain/World/terrain1.bmp",
-	//					100.0f, 5.0f, 100.0f);
-	//cTerrainManager->Add("Shader3D_Terrain",
-	//					"Image/Terrain/World/terrain2.bmp",
-	//					100.0f, 5.0f, 100.0f);
+	// The other terrains are only loaded when they are selected
+	cTerrainManager->Add("Shader3D_Terrain",
+						"Image/Terrain/World/terrain1.bmp",
+						100.0f, 5.0f, 100.0f);
+	cTerrainManager->Add("Shader3D_Terrain",
+						"Image/Terrain/World/terrain2.bmp",
+						100.0f, 5.0f, 100.0f);
 
 	// Load the movable Entities
 	// Initialise the CSolidObjectManager
@@ -240,7 +292,7 @@ bool CScene3D::Init(void)
 	// Initialise the projectile manager
 	cProjectileManager = CProjectileManager::GetInstance();
 	cProjectileManager->Init();
-	cProjectileManager->SetShader("Shader3D");
+	cProjectileManager->SetShader("Shader3D_Instancing");
 
 	// Assign a cPistol to the cPlayer3D
 	CPistol* cPistol = new CPistol();
@@ -297,13 +349,15 @@ bool CScene3D::Init(void)
 	cEntityManager->Init();
 
 	// Initialise the CRock3D
-	CRock3D* cRock3D = new CRock3D();
+	cRock3D = new CRock3D();
 	cRock3D->SetInstancingMode(true);
 	if (cRock3D->IsInstancedRendering() == true)
 	{
 		cRock3D->SetScale(glm::vec3(5.0f));
 		cRock3D->SetNumOfInstance(1000);
 		cRock3D->SetSpreadDistance(100.0f);
+		cRock3D->SetNumOfLODs(3);
+		cRock3D->SetLODDistances(15.0f, 30.0f);
 
 		cRock3D->SetShader("Shader3D_Instancing");	// FOR INSTANCED RENDERING
 	}
@@ -321,16 +375,19 @@ bool CScene3D::Init(void)
 	else
 	{
 		delete cRock3D;
+		cRock3D = NULL;
 	}
 
 	// Initialise the CTreeKabak3D
-	CTreeKabak3D* cTreeKabak3D = new CTreeKabak3D(glm::vec3(0.0f, 0.0f, 0.0f));
+	cTreeKabak3D = new CTreeKabak3D(glm::vec3(0.0f, 0.0f, 0.0f));
 	cTreeKabak3D->SetInstancingMode(true);
 	if (cTreeKabak3D->IsInstancedRendering() == true)
 	{
 		cTreeKabak3D->SetScale(glm::vec3(1.0f));
 		cTreeKabak3D->SetNumOfInstance(1000);
 		cTreeKabak3D->SetSpreadDistance(100.0f);
+		cTreeKabak3D->SetNumOfLODs(3);
+		cTreeKabak3D->SetLODDistances(20.0f, 40.0f);
 
 		cTreeKabak3D->SetShader("Shader3D_Instancing");	// FOR INSTANCED RENDERING
 	}
@@ -341,6 +398,7 @@ bool CScene3D::Init(void)
 	else
 	{
 		delete cTreeKabak3D;
+		cTreeKabak3D = NULL;
 	}
 
 	// Initialise a CSpinTower
@@ -374,6 +432,23 @@ bool CScene3D::Init(void)
 */
 bool CScene3D::Update(const double dElapsedTime)
 {
+	// Upload the assets which were loaded in the background, within a time budget for this frame
+	cAssetLoader->Update(dAssetUploadBudget);
+
+	// Don't update the scene until all the assets are loaded
+	if (bLoading == true)
+	{
+		if (cAssetLoader->IsIdle() == false)
+		{
+			// Show the fraction of the assets which are loaded
+			cGUI_Scene3D->UpdateLoading(cAssetLoader->GetProgress());
+			return true;
+		}
+
+		bLoading = false;
+		cout << "CScene3D: All the assets are loaded." << endl;
+	}
+
 	// Store the current position, if rollback is needed.
 	cPlayer3D->StorePositionForRollback();
 	
@@ -445,6 +520,83 @@ bool CScene3D::Update(const double dElapsedTime)
 	{
 		cPlayer3D->SetCurrentWeapon(1);
 	}
+	if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_F1))
+	{
+		// Toggle the debug keys, which change how the scene is partitioned and drawn, and deform the terrain
+		bDebugKeys = !bDebugKeys;
+		cout << "Debug keys are " << (bDebugKeys ? "enabled" : "disabled") << endl;
+
+		// Reset the key so that it will not repeat until the key is released and pressed again
+		CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_F1);
+	}
+	if (bDebugKeys == true)
+	{
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_7))
+		{
+			// Toggle between the grid and the sweep-and-prune broadphases
+			if (cSpatialPartition->GetBroadphase() == CSpatialPartition::BROADPHASE::GRID)
+				cSpatialPartition->SetBroadphase(CSpatialPartition::BROADPHASE::SWEEPANDPRUNE);
+			else
+				cSpatialPartition->SetBroadphase(CSpatialPartition::BROADPHASE::GRID);
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_7);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_3))
+		{
+			// Toggle between drawing the terrain with levels of detail and at full detail
+			cTerrainManager->SetLODEnabled(!cTerrainManager->IsLODEnabled());
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_3);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_G))
+		{
+			// Toggle between displacing one grid patch by the height texture and storing every terrain vertex
+			cTerrainManager->SetGPUDisplacementEnabled(!cTerrainManager->IsGPUDisplacementEnabled());
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_G);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_C))
+		{
+			// Make a crater in the terrain around the player
+			glm::vec3 vec3PlayerPosition = cPlayer3D->GetPosition();
+			cTerrainManager->Deform(CTerrain::DEFORMATION::LOWER, vec3PlayerPosition.x, vec3PlayerPosition.z, 3.0f, 0.5f);
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_C);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_4))
+		{
+			// Print the number of terrain vertices which were drawn in the last frame, against the full detail,
+			// and the number of rocks and trees which were drawn in the last frame, against all their instances
+			cTerrainManager->PrintSelf();
+			if (cRock3D)
+				cRock3D->PrintSelf();
+			if (cTreeKabak3D)
+				cTreeKabak3D->PrintSelf();
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_4);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_5))
+		{
+			// Print the shared meshes and textures, and the memory which they use
+			cAssetRegistry->PrintSelf();
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_5);
+		}
+		if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_6))
+		{
+			// Toggle between testing the CGrids for collisions on the worker threads and on this thread
+			cSpatialPartition->SetParallelNarrowphase(!cSpatialPartition->GetParallelNarrowphase());
+
+			// Reset the key so that it will not repeat until the key is released and pressed again
+			CKeyboardController::GetInstance()->ResetKey(GLFW_KEY_6);
+		}
+	}
 	if (CKeyboardController::GetInstance()->IsKeyPressed(GLFW_KEY_8))
 	{
 		bool bStatus = CCameraEffectsManager::GetInstance()->Get("CameraShake")->GetStatus();
@@ -468,13 +620,14 @@ bool CScene3D::Update(const double dElapsedTime)
 
 	if (CKeyboardController::GetInstance()->IsKeyReleased(GLFW_KEY_LEFT_BRACKET))
 	{
-		cSkyBox->SetIndex(cSkyBox->GetIndex() - 1);
-		cTerrainManager->SetIndex(cTerrainManager->GetIndex() - 1);
+		// Only change the skybox if the terrain could be selected, so that they stay in step
+		if (cTerrainManager->SetIndex(cTerrainManager->GetIndex() - 1) == true)
+			cSkyBox->SetIndex(cSkyBox->GetIndex() - 1);
 	}
 	else if (CKeyboardController::GetInstance()->IsKeyReleased(GLFW_KEY_RIGHT_BRACKET))
 	{
-		cSkyBox->SetIndex(cSkyBox->GetIndex() + 1);
-		cTerrainManager->SetIndex(cTerrainManager->GetIndex() + 1);
+		if (cTerrainManager->SetIndex(cTerrainManager->GetIndex() + 1) == true)
+			cSkyBox->SetIndex(cSkyBox->GetIndex() + 1);
 	}
 
 	// Get mouse button updates
@@ -495,26 +648,32 @@ bool CScene3D::Update(const double dElapsedTime)
 		CCameraEffectsManager::GetInstance()->Get("ScopeScreen")->SetStatus(false);
 	}
 
-	// Update the Solid Objects
+	// Update the entities as a job, since they do not depend on the other stages below
+	CJobSystem::SCounter sEntityCounter;
+	cJobSystem->Run([this, dElapsedTime]() { cEntityManager->Update(dElapsedTime); }, &sEntityCounter);
+
+	// Update the Solid Objects on this thread, since they fire projectiles and raycast into the Spatial Partition
 	cSolidObjectManager->Update(dElapsedTime);
 
-	// Update the projectiles
+	// Update the projectiles. They are integrated on the worker threads.
 	cProjectileManager->Update(dElapsedTime);
 
-	// Update the entities
-	cEntityManager->Update(dElapsedTime);
+	// Sync point: the entities must be updated before the Spatial Partition is rebuilt
+	cJobSystem->Wait(sEntityCounter);
 
 	// Reset the Spatial Partition and 
 	// Add the CSolidObjects back into the Spatial Partition
 	cSpatialPartition->Reset(cSolidObjectManager);
 
-	// Update the Spatial Partition
+	// Update the Spatial Partition. The LOD of the grids is selected on the worker threads.
 	cSpatialPartition->Update(dElapsedTime);
 
 	// Check for collisions among Entities and also with Projectiles
 	// Check for collisions between Entities and Projectiles
 	cSolidObjectManager->CheckForCollision();
 
+	// All the jobs of this frame are done at this point, so the rendering can read their results
+
 	// Call the cGUI_Scene3D's update method
 	cGUI_Scene3D->Update(dElapsedTime);
 
@@ -542,6 +701,13 @@ void CScene3D::PreRender(void)
  */
 void CScene3D::Render(void)
 {
+	// Only the loading screen is shown until all the assets are loaded
+	if (bLoading == true)
+	{
+		cGUI_Scene3D->RenderLoading();
+		return;
+	}
+
 	// Part 1: Render for the minimap by binding to framebuffer and render to colour texture
 	//         But the camera is move to top-view of the scene
 
@@ -51,7 +51,18 @@
 // Include CSpatialPartition
 #include "SpatialPartition\SpatialPartition.h"
 
+// Include CJobSystem
+#include "../JobSystem/JobSystem.h"
+
+// Include CAssetLoader
+#include "../Assets/AssetLoader.h"
+
+// Include CAssetRegistry
+#include "../Assets/AssetRegistry.h"
+
 class CSettings;
+class CRock3D;
+class CTreeKabak3D;
 
 class CScene3D : public CSingletonTemplate<CScene3D>
 {
@@ -110,10 +121,29 @@ protected:
 
 	// Handler to the EntityManager class
 	CEntityManager* cEntityManager;
+	// Handlers to the instanced CRock3D and CTreeKabak3D. They are owned by the cEntityManager.
+	CRock3D* cRock3D;
+	CTreeKabak3D* cTreeKabak3D;
 
 	// Handler to the CSpatialPartition instance
 	CSpatialPartition* cSpatialPartition;
 
+	// Handler to the CJobSystem instance
+	CJobSystem* cJobSystem;
+
+	// Handler to the CAssetLoader instance
+	CAssetLoader* cAssetLoader;
+	// Boolean flag to indicate if the scene is waiting for the assets to be loaded
+	bool bLoading;
+	// The time in milliseconds which can be used to upload the assets in each frame
+	double dAssetUploadBudget;
+
+	// Handler to the CAssetRegistry instance
+	CAssetRegistry* cAssetRegistry;
+
+	// Boolean flag to indicate if the debug keys are enabled. F1 toggles it.
+	bool bDebugKeys;
+
 	// Constructor
 	CScene3D(void);
 	// Destructor
@@ -41,6 +41,8 @@ CSceneNode::CSceneNode(void)
 	, updateRotateMtx(glm::mat4(1.0f))
 	, updateScaleMtx(glm::mat4(1.0f))
 	, bContinuousUpdate(false)
+	, pSharedMesh(NULL)
+	, pSharedTexture(NULL)
 {
 }
 
@@ -64,6 +66,8 @@ CSceneNode::CSceneNode(const int snID)
 	, updateRotateMtx(glm::mat4(1.0f))
 	, updateScaleMtx(glm::mat4(1.0f))
 	, bContinuousUpdate(false)
+	, pSharedMesh(NULL)
+	, pSharedTexture(NULL)
 {
 	this->snID = snID;
 }
@@ -78,6 +82,16 @@ CSceneNode::~CSceneNode(void)
 
 	// Reset the pointers for this node
 	cParentNode = NULL;
+
+	// Release the shared mesh and texture, and clear them so that they are not deleted again
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	cAssetRegistry->Release(pSharedMesh);
+	pSharedMesh = NULL;
+	cAssetRegistry->Release(pSharedTexture);
+	pSharedTexture = NULL;
+	VAO = 0;
+	p3DMesh = NULL;
+	iTextureID = 0;
 }
 
 /**
@@ -92,14 +106,15 @@ bool CSceneNode::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::OTHERS);
 
-	// Generate and bind the VAO
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-
-	p3DMesh = CMeshBuilder::GenerateBox(glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
+	// Acquire the box and the texture which are shared by all the CSceneNode.
+	// They are only created by the first CSceneNode.
+	CAssetRegistry* cAssetRegistry = CAssetRegistry::GetInstance();
+	pSharedMesh = cAssetRegistry->AcquireBox(glm::vec4(1.0f, 0.0f, 1.0f, 1.0f));
+	VAO = pSharedMesh->uiVAO;
+	p3DMesh = pSharedMesh->p3DMesh;
 
-	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Structure_01.tga", false);
+	pSharedTexture = cAssetRegistry->AcquireTexture("Image/Scene3D_Structure_01.tga", false);
+	iTextureID = pSharedTexture->uiTextureID;
 	if (iTextureID == 0)
 	{
 		cout << "Unable to load Image/Scene3D_Structure_01.tga" << endl;
@@ -13,6 +13,9 @@
 #include <includes/gtc/matrix_transform.hpp>
 #include <includes/gtc/type_ptr.hpp>
 
+// Include CAssetRegistry
+#include "../../Assets/AssetRegistry.h"
+
 #include <vector>
 using namespace std;
 
@@ -130,4 +133,8 @@ protected:
 	glm::mat4	updateRotateMtx;
 	// The update transformation: the update to the scale for every update
 	glm::mat4	updateScaleMtx;
+
+	// The shared mesh and texture which this node acquired from the CAssetRegistry
+	CAssetRegistry::SMesh* pSharedMesh;
+	CAssetRegistry::STexture* pSharedTexture;
 };
@@ -7,8 +7,8 @@
 
 #include <includes\gtc\matrix_transform.hpp>
 
-// Include ImageLoader
-#include "System\ImageLoader.h"
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
 
 #include "RenderControl/ShaderManager.h"
 
@@ -261,25 +261,27 @@ GLuint CSkyBox::LoadSkyBoxTextures(void)
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, 0);
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, 5);
 
-	// Get the image loader
-	CImageLoader* cImageLoader = CImageLoader::GetInstance();
-
-	// Load each of the textures as a single texture ID
-	int width, height, nrChannels;
+	// Load each of the textures on the worker threads, as compressed textures if they can be cooked.
+	// Each face is uploaded into this cubemap on the main thread when it is loaded.
+	CAssetLoader* cAssetLoader = CAssetLoader::GetInstance();
 	for (unsigned int i = 0; i < skyboxTexture.size(); i++)
 	{
-		unsigned char *data = cImageLoader->Load(skyboxTexture[i].c_str(), width, height, nrChannels, false);
-		if (data)
-		{
-			std::cout << skyboxTexture[i] << " successfully loaded. " << std::endl;
-			glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else
+		cAssetLoader->LoadImageData(skyboxTexture[i], false, [textureID, i](const CAssetLoader::SImageData& sImageData)
 		{
-			std::cout << "Cubemap texture failed to load at path: " << skyboxTexture[i] << std::endl;
-		}
-		// Free up the memory of the file data read in
-		free(data);
+			if (sImageData.bSuccess == true)
+			{
+				std::cout << sImageData.sFilePath << " successfully loaded. " << std::endl;
+				glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
+				if (sImageData.pCompressed)
+					CTextureCache::Upload(*sImageData.pCompressed, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+				else
+					glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, sImageData.iWidth, sImageData.iHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, sImageData.pData);
+			}
+			else
+			{
+				std::cout << "Cubemap texture failed to load at path: " << sImageData.sFilePath << std::endl;
+			}
+		}, true);
 	}
 	//glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -0,0 +1,473 @@
+/**
+ CCollisionBatch
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "CollisionBatch.h"
+
+#if defined(COLLISIONBATCH_AVX2)
+	#include <immintrin.h>
+#elif defined(COLLISIONBATCH_SSE2)
+	#include <emmintrin.h>
+#endif
+
+#include <cfloat>
+
+/**
+ @brief Remove all the boxes
+ */
+void CCollisionBatch::SBoxBatch::Clear(void)
+{
+	vMinX.clear();
+	vMinY.clear();
+	vMinZ.clear();
+	vMaxX.clear();
+	vMaxY.clear();
+	vMaxZ.clear();
+}
+
+/**
+ @brief Reserve memory for a number of boxes
+ @param uiSize A const unsigned int variable containing the number of boxes
+ */
+void CCollisionBatch::SBoxBatch::Reserve(const unsigned int uiSize)
+{
+	vMinX.reserve(uiSize);
+	vMinY.reserve(uiSize);
+	vMinZ.reserve(uiSize);
+	vMaxX.reserve(uiSize);
+	vMaxY.reserve(uiSize);
+	vMaxZ.reserve(uiSize);
+}
+
+/**
+ @brief Add a box
+ @param vec3BoxMin A const glm::vec3& variable containing the minimum corner of the box
+ @param vec3BoxMax A const glm::vec3& variable containing the maximum corner of the box
+ */
+void CCollisionBatch::SBoxBatch::Add(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax)
+{
+	vMinX.push_back(vec3BoxMin.x);
+	vMinY.push_back(vec3BoxMin.y);
+	vMinZ.push_back(vec3BoxMin.z);
+	vMaxX.push_back(vec3BoxMax.x);
+	vMaxY.push_back(vec3BoxMax.y);
+	vMaxZ.push_back(vec3BoxMax.z);
+}
+
+/**
+ @brief Get the number of boxes
+ @return An unsigned int variable containing the number of boxes
+ */
+unsigned int CCollisionBatch::SBoxBatch::GetSize(void) const
+{
+	return (unsigned int)vMinX.size();
+}
+
+/**
+ @brief Remove all the rays
+ */
+void CCollisionBatch::SRayBatch::Clear(void)
+{
+	vOriginX.clear();
+	vOriginY.clear();
+	vOriginZ.clear();
+	vInvDirectionX.clear();
+	vInvDirectionY.clear();
+	vInvDirectionZ.clear();
+	vMaxT.clear();
+}
+
+/**
+ @brief Reserve memory for a number of rays
+ @param uiSize A const unsigned int variable containing the number of rays
+ */
+void CCollisionBatch::SRayBatch::Reserve(const unsigned int uiSize)
+{
+	vOriginX.reserve(uiSize);
+	vOriginY.reserve(uiSize);
+	vOriginZ.reserve(uiSize);
+	vInvDirectionX.reserve(uiSize);
+	vInvDirectionY.reserve(uiSize);
+	vInvDirectionZ.reserve(uiSize);
+	vMaxT.reserve(uiSize);
+}
+
+/**
+ @brief Add a ray
+ @param vec3Origin A const glm::vec3& variable containing the origin of the ray
+ @param vec3Direction A const glm::vec3& variable containing the direction of the ray
+ @param fMaxT A const float variable containing the maximum value of t to test up to
+ */
+void CCollisionBatch::SRayBatch::Add(const glm::vec3& vec3Origin, const glm::vec3& vec3Direction, const float fMaxT)
+{
+	vOriginX.push_back(vec3Origin.x);
+	vOriginY.push_back(vec3Origin.y);
+	vOriginZ.push_back(vec3Origin.z);
+	vInvDirectionX.push_back(GetInverse(vec3Direction.x));
+	vInvDirectionY.push_back(GetInverse(vec3Direction.y));
+	vInvDirectionZ.push_back(GetInverse(vec3Direction.z));
+	vMaxT.push_back(fMaxT);
+}
+
+/**
+ @brief Add a line segment, which is a ray from vec3Start to vec3End with fMaxT = 1
+ @param vec3Start A const glm::vec3& variable containing the start of the line segment
+ @param vec3End A const glm::vec3& variable containing the end of the line segment
+ */
+void CCollisionBatch::SRayBatch::AddSegment(const glm::vec3& vec3Start, const glm::vec3& vec3End)
+{
+	Add(vec3Start, vec3End - vec3Start, 1.0f);
+}
+
+/**
+ @brief Get the number of rays
+ @return An unsigned int variable containing the number of rays
+ */
+unsigned int CCollisionBatch::SRayBatch::GetSize(void) const
+{
+	return (unsigned int)vOriginX.size();
+}
+
+/**
+ @brief Test a ray against a batch of boxes
+ @param vec3Origin A const glm::vec3& variable containing the origin of the ray
+ @param vec3Direction A const glm::vec3& variable containing the direction of the ray. It does not need to be normalised.
+ @param fMaxT A const float variable containing the maximum value of t to test up to
+ @param sBoxBatch A const SBoxBatch& variable containing the boxes
+ @param pfT A float* variable to store the t of each box. It is FLT_MAX if the box is not hit. It must have space for all the boxes.
+ @return An int variable containing the number of boxes which are hit
+ */
+int CCollisionBatch::RayBoxBatch(	const glm::vec3& vec3Origin,
+									const glm::vec3& vec3Direction,
+									const float fMaxT,
+									const SBoxBatch& sBoxBatch,
+									float* pfT)
+{
+	const unsigned int uiSize = sBoxBatch.GetSize();
+	const float fInvDirectionX = GetInverse(vec3Direction.x);
+	const float fInvDirectionY = GetInverse(vec3Direction.y);
+	const float fInvDirectionZ = GetInverse(vec3Direction.z);
+
+	int iNumOfHits = 0;
+	unsigned int i = 0;
+
+#if defined(COLLISIONBATCH_AVX2)
+	const __m256 m256OriginX = _mm256_set1_ps(vec3Origin.x);
+	const __m256 m256OriginY = _mm256_set1_ps(vec3Origin.y);
+	const __m256 m256OriginZ = _mm256_set1_ps(vec3Origin.z);
+	const __m256 m256InvDirectionX = _mm256_set1_ps(fInvDirectionX);
+	const __m256 m256InvDirectionY = _mm256_set1_ps(fInvDirectionY);
+	const __m256 m256InvDirectionZ = _mm256_set1_ps(fInvDirectionZ);
+	const __m256 m256Zero = _mm256_setzero_ps();
+	const __m256 m256MaxT = _mm256_set1_ps(fMaxT);
+	const __m256 m256Miss = _mm256_set1_ps(FLT_MAX);
+	for (; i + 8 <= uiSize; i += 8)
+	{
+		// Calculate the distances to the 2 slabs in each axis
+		__m256 m256T1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMinX[i]), m256OriginX), m256InvDirectionX);
+		__m256 m256T2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMaxX[i]), m256OriginX), m256InvDirectionX);
+		__m256 m256Near = _mm256_max_ps(m256Zero, _mm256_min_ps(m256T1, m256T2));
+		__m256 m256Far = _mm256_min_ps(m256MaxT, _mm256_max_ps(m256T1, m256T2));
+
+		m256T1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMinY[i]), m256OriginY), m256InvDirectionY);
+		m256T2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMaxY[i]), m256OriginY), m256InvDirectionY);
+		m256Near = _mm256_max_ps(m256Near, _mm256_min_ps(m256T1, m256T2));
+		m256Far = _mm256_min_ps(m256Far, _mm256_max_ps(m256T1, m256T2));
+
+		m256T1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMinZ[i]), m256OriginZ), m256InvDirectionZ);
+		m256T2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(&sBoxBatch.vMaxZ[i]), m256OriginZ), m256InvDirectionZ);
+		m256Near = _mm256_max_ps(m256Near, _mm256_min_ps(m256T1, m256T2));
+		m256Far = _mm256_min_ps(m256Far, _mm256_max_ps(m256T1, m256T2));
+
+		// The box is hit if the ray enters all the slabs before it leaves any of them
+		const __m256 m256Hit = _mm256_cmp_ps(m256Near, m256Far, _CMP_LE_OQ);
+		_mm256_storeu_ps(&pfT[i], _mm256_blendv_ps(m256Miss, m256Near, m256Hit));
+		iNumOfHits += CountBits(_mm256_movemask_ps(m256Hit));
+	}
+#elif defined(COLLISIONBATCH_SSE2)
+	const __m128 m128OriginX = _mm_set1_ps(vec3Origin.x);
+	const __m128 m128OriginY = _mm_set1_ps(vec3Origin.y);
+	const __m128 m128OriginZ = _mm_set1_ps(vec3Origin.z);
+	const __m128 m128InvDirectionX = _mm_set1_ps(fInvDirectionX);
+	const __m128 m128InvDirectionY = _mm_set1_ps(fInvDirectionY);
+	const __m128 m128InvDirectionZ = _mm_set1_ps(fInvDirectionZ);
+	const __m128 m128Zero = _mm_setzero_ps();
+	const __m128 m128MaxT = _mm_set1_ps(fMaxT);
+	const __m128 m128Miss = _mm_set1_ps(FLT_MAX);
+	for (; i + 4 <= uiSize; i += 4)
+	{
+		// Calculate the distances to the 2 slabs in each axis
+		__m128 m128T1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMinX[i]), m128OriginX), m128InvDirectionX);
+		__m128 m128T2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMaxX[i]), m128OriginX), m128InvDirectionX);
+		__m128 m128Near = _mm_max_ps(m128Zero, _mm_min_ps(m128T1, m128T2));
+		__m128 m128Far = _mm_min_ps(m128MaxT, _mm_max_ps(m128T1, m128T2));
+
+		m128T1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMinY[i]), m128OriginY), m128InvDirectionY);
+		m128T2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMaxY[i]), m128OriginY), m128InvDirectionY);
+		m128Near = _mm_max_ps(m128Near, _mm_min_ps(m128T1, m128T2));
+		m128Far = _mm_min_ps(m128Far, _mm_max_ps(m128T1, m128T2));
+
+		m128T1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMinZ[i]), m128OriginZ), m128InvDirectionZ);
+		m128T2 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&sBoxBatch.vMaxZ[i]), m128OriginZ), m128InvDirectionZ);
+		m128Near = _mm_max_ps(m128Near, _mm_min_ps(m128T1, m128T2));
+		m128Far = _mm_min_ps(m128Far, _mm_max_ps(m128T1, m128T2));
+
+		// The box is hit if the ray enters all the slabs before it leaves any of them
+		const __m128 m128Hit = _mm_cmple_ps(m128Near, m128Far);
+		_mm_storeu_ps(&pfT[i], _mm_or_ps(_mm_and_ps(m128Hit, m128Near), _mm_andnot_ps(m128Hit, m128Miss)));
+		iNumOfHits += CountBits(_mm_movemask_ps(m128Hit));
+	}
+#endif
+
+	// Test the remaining boxes with the scalar instructions
+	for (; i < uiSize; i++)
+	{
+		if (RayBoxScalar(	vec3Origin.x, vec3Origin.y, vec3Origin.z,
+							fInvDirectionX, fInvDirectionY, fInvDirectionZ,
+							fMaxT,
+							sBoxBatch.vMinX[i], sBoxBatch.vMinY[i], sBoxBatch.vMinZ[i],
+							sBoxBatch.vMaxX[i], sBoxBatch.vMaxY[i], sBoxBatch.vMaxZ[i],
+							pfT[i]))
+			iNumOfHits++;
+	}
+
+	return iNumOfHits;
+}
+
+/**
+ @brief Test a batch of rays against a box
+ @param sRayBatch A const SRayBatch& variable containing the rays
+ @param vec3BoxMin A const glm::vec3& variable containing the minimum corner of the box
+ @param vec3BoxMax A const glm::vec3& variable containing the maximum corner of the box
+ @param pfT A float* variable to store the t of each ray. It is FLT_MAX if the ray does not hit. It must have space for all the rays.
+ @return An int variable containing the number of rays which hit the box
+ */
+int CCollisionBatch::RayBatchBox(	const SRayBatch& sRayBatch,
+									const glm::vec3& vec3BoxMin,
+									const glm::vec3& vec3BoxMax,
+									float* pfT)
+{
+	const unsigned int uiSize = sRayBatch.GetSize();
+
+	int iNumOfHits = 0;
+	unsigned int i = 0;
+
+#if defined(COLLISIONBATCH_AVX2)
+	const __m256 m256MinX = _mm256_set1_ps(vec3BoxMin.x);
+	const __m256 m256MinY = _mm256_set1_ps(vec3BoxMin.y);
+	const __m256 m256MinZ = _mm256_set1_ps(vec3BoxMin.z);
+	const __m256 m256MaxX = _mm256_set1_ps(vec3BoxMax.x);
+	const __m256 m256MaxY = _mm256_set1_ps(vec3BoxMax.y);
+	const __m256 m256MaxZ = _mm256_set1_ps(vec3BoxMax.z);
+	const __m256 m256Zero = _mm256_setzero_ps();
+	const __m256 m256Miss = _mm256_set1_ps(FLT_MAX);
+	for (; i + 8 <= uiSize; i += 8)
+	{
+		// Calculate the distances to the 2 slabs in each axis
+		__m256 m256Origin = _mm256_loadu_ps(&sRayBatch.vOriginX[i]);
+		__m256 m256InvDirection = _mm256_loadu_ps(&sRayBatch.vInvDirectionX[i]);
+		__m256 m256T1 = _mm256_mul_ps(_mm256_sub_ps(m256MinX, m256Origin), m256InvDirection);
+		__m256 m256T2 = _mm256_mul_ps(_mm256_sub_ps(m256MaxX, m256Origin), m256InvDirection);
+		__m256 m256Near = _mm256_max_ps(m256Zero, _mm256_min_ps(m256T1, m256T2));
+		__m256 m256Far = _mm256_min_ps(_mm256_loadu_ps(&sRayBatch.vMaxT[i]), _mm256_max_ps(m256T1, m256T2));
+
+		m256Origin = _mm256_loadu_ps(&sRayBatch.vOriginY[i]);
+		m256InvDirection = _mm256_loadu_ps(&sRayBatch.vInvDirectionY[i]);
+		m256T1 = _mm256_mul_ps(_mm256_sub_ps(m256MinY, m256Origin), m256InvDirection);
+		m256T2 = _mm256_mul_ps(_mm256_sub_ps(m256MaxY, m256Origin), m256InvDirection);
+		m256Near = _mm256_max_ps(m256Near, _mm256_min_ps(m256T1, m256T2));
+		m256Far = _mm256_min_ps(m256Far, _mm256_max_ps(m256T1, m256T2));
+
+		m256Origin = _mm256_loadu_ps(&sRayBatch.vOriginZ[i]);
+		m256InvDirection = _mm256_loadu_ps(&sRayBatch.vInvDirectionZ[i]);
+		m256T1 = _mm256_mul_ps(_mm256_sub_ps(m256MinZ, m256Origin), m256InvDirection);
+		m256T2 = _mm256_mul_ps(_mm256_sub_ps(m256MaxZ, m256Origin), m256InvDirection);
+		m256Near = _mm256_max_ps(m256Near, _mm256_min_ps(m256T1, m256T2));
+		m256Far = _mm256_min_ps(m256Far, _mm256_max_ps(m256T1, m256T2));
+
+		// The box is hit if the ray enters all the slabs before it leaves any of them
+		const __m256 m256Hit = _mm256_cmp_ps(m256Near, m256Far, _CMP_LE_OQ);
+		_mm256_storeu_ps(&pfT[i], _mm256_blendv_ps(m256Miss, m256Near, m256Hit));
+		iNumOfHits += CountBits(_mm256_movemask_ps(m256Hit));
+	}
+#elif defined(COLLISIONBATCH_SSE2)
+	const __m128 m128MinX = _mm_set1_ps(vec3BoxMin.x);
+	const __m128 m128MinY = _mm_set1_ps(vec3BoxMin.y);
+	const __m128 m128MinZ = _mm_set1_ps(vec3BoxMin.z);
+	const __m128 m128MaxX = _mm_set1_ps(vec3BoxMax.x);
+	const __m128 m128MaxY = _mm_set1_ps(vec3BoxMax.y);
+	const __m128 m128MaxZ = _mm_set1_ps(vec3BoxMax.z);
+	const __m128 m128Zero = _mm_setzero_ps();
+	const __m128 m128Miss = _mm_set1_ps(FLT_MAX);
+	for (; i + 4 <= uiSize; i += 4)
+	{
+		// Calculate the distances to the 2 slabs in each axis
+		__m128 m128Origin = _mm_loadu_ps(&sRayBatch.vOriginX[i]);
+		__m128 m128InvDirection = _mm_loadu_ps(&sRayBatch.vInvDirectionX[i]);
+		__m128 m128T1 = _mm_mul_ps(_mm_sub_ps(m128MinX, m128Origin), m128InvDirection);
+		__m128 m128T2 = _mm_mul_ps(_mm_sub_ps(m128MaxX, m128Origin), m128InvDirection);
+		__m128 m128Near = _mm_max_ps(m128Zero, _mm_min_ps(m128T1, m128T2));
+		__m128 m128Far = _mm_min_ps(_mm_loadu_ps(&sRayBatch.vMaxT[i]), _mm_max_ps(m128T1, m128T2));
+
+		m128Origin = _mm_loadu_ps(&sRayBatch.vOriginY[i]);
+		m128InvDirection = _mm_loadu_ps(&sRayBatch.vInvDirectionY[i]);
+		m128T1 = _mm_mul_ps(_mm_sub_ps(m128MinY, m128Origin), m128InvDirection);
+		m128T2 = _mm_mul_ps(_mm_sub_ps(m128MaxY, m128Origin), m128InvDirection);
+		m128Near = _mm_max_ps(m128Near, _mm_min_ps(m128T1, m128T2));
+		m128Far = _mm_min_ps(m128Far, _mm_max_ps(m128T1, m128T2));
+
+		m128Origin = _mm_loadu_ps(&sRayBatch.vOriginZ[i]);
+		m128InvDirection = _mm_loadu_ps(&sRayBatch.vInvDirectionZ[i]);
+		m128T1 = _mm_mul_ps(_mm_sub_ps(m128MinZ, m128Origin), m128InvDirection);
+		m128T2 = _mm_mul_ps(_mm_sub_ps(m128MaxZ, m128Origin), m128InvDirection);
+		m128Near = _mm_max_ps(m128Near, _mm_min_ps(m128T1, m128T2));
+		m128Far = _mm_min_ps(m128Far, _mm_max_ps(m128T1, m128T2));
+
+		// The box is hit if the ray enters all the slabs before it leaves any of them
+		const __m128 m128Hit = _mm_cmple_ps(m128Near, m128Far);
+		_mm_storeu_ps(&pfT[i], _mm_or_ps(_mm_and_ps(m128Hit, m128Near), _mm_andnot_ps(m128Hit, m128Miss)));
+		iNumOfHits += CountBits(_mm_movemask_ps(m128Hit));
+	}
+#endif
+
+	// Test the remaining rays with the scalar instructions
+	for (; i < uiSize; i++)
+	{
+		if (RayBoxScalar(	sRayBatch.vOriginX[i], sRayBatch.vOriginY[i], sRayBatch.vOriginZ[i],
+							sRayBatch.vInvDirectionX[i], sRayBatch.vInvDirectionY[i], sRayBatch.vInvDirectionZ[i],
+							sRayBatch.vMaxT[i],
+							vec3BoxMin.x, vec3BoxMin.y, vec3BoxMin.z,
+							vec3BoxMax.x, vec3BoxMax.y, vec3BoxMax.z,
+							pfT[i]))
+			iNumOfHits++;
+	}
+
+	return iNumOfHits;
+}
+
+/**
+ @brief Find the nearest box in a batch which a ray hits
+ @param vec3Origin A const glm::vec3& variable containing the origin of the ray
+ @param vec3Direction A const glm::vec3& variable containing the direction of the ray. It does not need to be normalised.
+ @param fMaxT A const float variable containing the maximum value of t to test up to
+ @param sBoxBatch A const SBoxBatch& variable containing the boxes
+ @param t A float& variable to store the t of the nearest box
+ @return An int variable containing the index of the nearest box, or -1 if no box is hit
+ */
+int CCollisionBatch::RayBoxBatchNearest(const glm::vec3& vec3Origin,
+										const glm::vec3& vec3Direction,
+										const float fMaxT,
+										const SBoxBatch& sBoxBatch,
+										float& t)
+{
+	t = FLT_MAX;
+
+	const unsigned int uiSize = sBoxBatch.GetSize();
+	if (uiSize == 0)
+		return -1;
+
+	// Use a thread-local buffer, so that this can be called from several threads
+	static thread_local std::vector<float> vT;
+	vT.resize(uiSize);
+
+	if (RayBoxBatch(vec3Origin, vec3Direction, fMaxT, sBoxBatch, &vT[0]) == 0)
+		return -1;
+
+	int iNearest = -1;
+	for (unsigned int i = 0; i < uiSize; i++)
+	{
+		if (vT[i] < t)
+		{
+			t = vT[i];
+			iNearest = (int)i;
+		}
+	}
+	return iNearest;
+}
+
+/**
+ @brief Get the name of the instruction set used
+ @return A const char* variable containing the name of the instruction set
+ */
+const char* CCollisionBatch::GetInstructionSet(void)
+{
+#if defined(COLLISIONBATCH_AVX2)
+	return "AVX2";
+#elif defined(COLLISIONBATCH_SSE2)
+	return "SSE2";
+#else
+	return "Scalar";
+#endif
+}
+
+/**
+ @brief Test a ray against a box, using the scalar instructions
+ @param fOriginX, fOriginY, fOriginZ The origin of the ray
+ @param fInvDirectionX, fInvDirectionY, fInvDirectionZ The inverse of the direction of the ray
+ @param fMaxT A const float variable containing the maximum value of t to test up to
+ @param fMinX, fMinY, fMinZ The minimum corner of the box
+ @param fMaxX, fMaxY, fMaxZ The maximum corner of the box
+ @param t A float& variable to store the t where the ray enters the box, or FLT_MAX if it does not hit
+ @return A bool variable which is true if the ray hits the box
+ */
+bool CCollisionBatch::RayBoxScalar(	const float fOriginX, const float fOriginY, const float fOriginZ,
+									const float fInvDirectionX, const float fInvDirectionY, const float fInvDirectionZ,
+									const float fMaxT,
+									const float fMinX, const float fMinY, const float fMinZ,
+									const float fMaxX, const float fMaxY, const float fMaxZ,
+									float& t)
+{
+	// Same operand order as _mm_min_ps and _mm_max_ps, so that the results match the SIMD paths
+	float fT1 = (fMinX - fOriginX) * fInvDirectionX;
+	float fT2 = (fMaxX - fOriginX) * fInvDirectionX;
+	float fNear = glm::max(0.0f, (fT1 < fT2) ? fT1 : fT2);
+	float fFar = glm::min(fMaxT, (fT1 > fT2) ? fT1 : fT2);
+
+	fT1 = (fMinY - fOriginY) * fInvDirectionY;
+	fT2 = (fMaxY - fOriginY) * fInvDirectionY;
+	fNear = glm::max(fNear, (fT1 < fT2) ? fT1 : fT2);
+	fFar = glm::min(fFar, (fT1 > fT2) ? fT1 : fT2);
+
+	fT1 = (fMinZ - fOriginZ) * fInvDirectionZ;
+	fT2 = (fMaxZ - fOriginZ) * fInvDirectionZ;
+	fNear = glm::max(fNear, (fT1 < fT2) ? fT1 : fT2);
+	fFar = glm::min(fFar, (fT1 > fT2) ? fT1 : fT2);
+
+	if (fNear <= fFar)
+	{
+		t = fNear;
+		return true;
+	}
+	t = FLT_MAX;
+	return false;
+}
+
+/**
+ @brief Count the number of bits set in a mask from a SIMD comparison
+ @param iMask An int variable containing the mask
+ @return An int variable containing the number of bits set
+ */
+int CCollisionBatch::CountBits(int iMask)
+{
+	int iCount = 0;
+	while (iMask)
+	{
+		iMask &= (iMask - 1);
+		iCount++;
+	}
+	return iCount;
+}
+
+/**
+ @brief Get the inverse of a direction. A zero direction is replaced by a very large value,
+		so that the slabs in that axis either contain the ray or are never reached.
+ @param fValue A const float variable containing the direction
+ @return A float variable containing the inverse of the direction
+ */
+float CCollisionBatch::GetInverse(const float fValue)
+{
+	if (fValue == 0.0f)
+		return FLT_MAX;
+	return 1.0f / fValue;
+}
@@ -0,0 +1,97 @@
+/**
+ CCollisionBatch
+ @brief This class tests rays against many axis-aligned bounding boxes at once.
+		The boxes and rays are stored as arrays of floats (SoA), so that SSE or AVX2
+		can test 4 or 8 of them per instruction. A scalar fallback is used otherwise.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+#include <vector>
+using namespace std;
+
+// Select the widest SIMD instruction set which the compiler is targeting
+#if defined(__AVX2__)
+	#define COLLISIONBATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define COLLISIONBATCH_SSE2
+#endif
+
+class CCollisionBatch
+{
+public:
+	// A batch of axis-aligned bounding boxes, stored as arrays of floats
+	struct SBoxBatch
+	{
+		std::vector<float> vMinX, vMinY, vMinZ;
+		std::vector<float> vMaxX, vMaxY, vMaxZ;
+
+		// Remove all the boxes
+		void Clear(void);
+		// Reserve memory for a number of boxes
+		void Reserve(const unsigned int uiSize);
+		// Add a box
+		void Add(const glm::vec3& vec3BoxMin, const glm::vec3& vec3BoxMax);
+		// Get the number of boxes
+		unsigned int GetSize(void) const;
+	};
+
+	// A batch of rays, stored as arrays of floats. Each ray is tested from t=0 to t=fMaxT.
+	struct SRayBatch
+	{
+		std::vector<float> vOriginX, vOriginY, vOriginZ;
+		std::vector<float> vInvDirectionX, vInvDirectionY, vInvDirectionZ;
+		std::vector<float> vMaxT;
+
+		// Remove all the rays
+		void Clear(void);
+		// Reserve memory for a number of rays
+		void Reserve(const unsigned int uiSize);
+		// Add a ray
+		void Add(const glm::vec3& vec3Origin, const glm::vec3& vec3Direction, const float fMaxT);
+		// Add a line segment, which is a ray from vec3Start to vec3End with fMaxT = 1
+		void AddSegment(const glm::vec3& vec3Start, const glm::vec3& vec3End);
+		// Get the number of rays
+		unsigned int GetSize(void) const;
+	};
+
+	// Test a ray against a batch of boxes
+	static int RayBoxBatch(	const glm::vec3& vec3Origin,
+							const glm::vec3& vec3Direction,
+							const float fMaxT,
+							const SBoxBatch& sBoxBatch,
+							float* pfT);
+
+	// Test a batch of rays against a box
+	static int RayBatchBox(	const SRayBatch& sRayBatch,
+							const glm::vec3& vec3BoxMin,
+							const glm::vec3& vec3BoxMax,
+							float* pfT);
+
+	// Find the nearest box in a batch which a ray hits
+	static int RayBoxBatchNearest(	const glm::vec3& vec3Origin,
+									const glm::vec3& vec3Direction,
+									const float fMaxT,
+									const SBoxBatch& sBoxBatch,
+									float& t);
+
+	// Get the name of the instruction set used
+	static const char* GetInstructionSet(void);
+
+protected:
+	// Test a ray against a box, using the scalar instructions
+	static bool RayBoxScalar(	const float fOriginX, const float fOriginY, const float fOriginZ,
+								const float fInvDirectionX, const float fInvDirectionY, const float fInvDirectionZ,
+								const float fMaxT,
+								const float fMinX, const float fMinY, const float fMinZ,
+								const float fMaxX, const float fMaxY, const float fMaxZ,
+								float& t);
+	// Count the number of bits set in a mask from a SIMD comparison
+	static int CountBits(int iMask);
+	// Get the inverse of a direction
+	static float GetInverse(const float fValue);
+};
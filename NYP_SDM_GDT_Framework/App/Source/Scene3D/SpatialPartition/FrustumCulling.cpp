@@ -218,6 +218,29 @@ void CFrustumCulling::PostRender(void)
 	glLineWidth(fPreviousLineWidth);
 }
 
+/**
+@brief Update the Frustum values from the view and projection, without updating the rendering details.
+		This is used when the Frustum is only used for culling, so Init is not called.
+*/
+void CFrustumCulling::UpdatePlanes(void)
+{
+	UpdateFrustum();
+}
+
+/**
+@brief Get the 6 planes of this Frustum. They are scaled so that the dot product with a point is its
+		distance to the plane, which is positive on the inside. This is used to test bounding spheres.
+@param pvec4Planes A glm::vec4* variable to store the 6 planes
+*/
+void CFrustumCulling::GetPlanes(glm::vec4* pvec4Planes) const
+{
+	for (int i = 0; i < Count; i++)
+	{
+		float fLength = glm::length(glm::vec3(m_planes[i]));
+		pvec4Planes[i] = (fLength > 0.0f) ? m_planes[i] / fLength : m_planes[i];
+	}
+}
+
 // Check if a bounding box is visible, a.k.a, it is within this Frustum
 bool CFrustumCulling::IsBoxVisible(const glm::vec3& minp, const glm::vec3& maxp) const
 {
@@ -33,12 +33,18 @@ public:
 	// PostRender
 	virtual void PostRender(void);
 
+	// Update the Frustum values from the view and projection, without updating the rendering details
+	void UpdatePlanes(void);
+
 	// Check if a bounding box is visible, a.k.a, it is within this Frustum
 	bool IsBoxVisible(const glm::vec3& minp, const glm::vec3& maxp) const;
 
 	// Check if a point is within this Frustum
 	bool IsPointWithin(const glm::vec3& vec3Point) const;
 
+	// Get the 6 planes of this Frustum, scaled so that the dot product with a point is its distance to the plane
+	void GetPlanes(glm::vec4* pvec4Planes) const;
+
 	// PrintSelf
 	void PrintSelf(void);
 
@@ -3,15 +3,6 @@
 // Include ShaderManager
 #include "RenderControl/ShaderManager.h"
 
-// Include CCollisionManager
-#include "Primitives/CollisionManager.h"
-
-// Include CPlayer3D
-#include "../Entities/Player3D.h"
-
-// Include CCameraEffectsManager
-#include "../CameraEffects/CameraEffectsManager.h"
-
 #include <iostream>
 using namespace std;
 
@@ -116,19 +107,68 @@ void CGrid::Init(glm::vec3 vec3TopRight, glm::vec3 vec3BottomLeft, float fTopLef
 	glEnableVertexAttribArray(1);
 }
 
+/**
+@brief Set the heights of the corners after the terrain was changed
+@param fBottomLeftHeight A const float variable storing the height at (-x, y, -z) position of the grid
+@param fTopRightHeight A const float variable storing the height at (+x, y, +z) position of the grid
+@param fTopLeftHeight A const float variable storing the height at (-x, y, +z) position of the grid
+@param fBottomRightHeight A const float variable storing the height at (+x, y, -z) position of the grid
+*/
+void CGrid::SetHeights(const float fBottomLeftHeight, const float fTopRightHeight, const float fTopLeftHeight, const float fBottomRightHeight)
+{
+	vec3BottomLeft.y = fBottomLeftHeight;
+	vec3TopRight.y = fTopRightHeight;
+
+	// Replace the vertices which were created by Init
+	float vertices[] = {
+		vec3BottomLeft.x, vec3BottomLeft.y, vec3BottomLeft.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+		vec3TopRight.x, fBottomRightHeight, vec3BottomLeft.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+		vec3TopRight.x, vec3TopRight.y, vec3TopRight.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+		vec3TopRight.x, vec3TopRight.y, vec3TopRight.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+		vec3BottomLeft.x, fTopLeftHeight, vec3TopRight.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+		vec3BottomLeft.x, vec3BottomLeft.y, vec3BottomLeft.z, vec4Colour.x, vec4Colour.y, vec4Colour.z,
+	};
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 /**
 @brief Update this class instance
 @param dElapsedTime A const double containing the elapsed time since the last frame
 */
 bool CGrid::Update(const double dElapsedTime)
 {
-	std::map<unsigned int, CSolidObject*>::iterator it, it_other, end;
-	glm::vec3 lowerBoxMin, lowerBoxMax, upperBoxMin, upperBoxMax;
-	
-	// Boolean variable to check if the player has collided with another CSolidObject
-	bool bResult = false;
+	// If this grid is visible...
+	if (bVisible)
+	{
+		// Update the LOD of all CSolidObject in this Grid
+		std::map<unsigned int, CSolidObject*>::iterator it, end;
+		end = SolidObjectMap.end();
+		for (it = SolidObjectMap.begin(); it != end; ++it)
+		{
+			// If this CSolidObject has LOD, then assign a new LOD value to it
+			if ((it->second)->GetLODStatus()==true)
+				(it->second)->SetDetailLevel(cCurrentLOD.GetDetailLevel());
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+/**
+@brief Add the pairs of active CSolidObjects in this grid to a CNarrowphase
+@param cNarrowphase A CNarrowphase* variable storing the CNarrowphase which tests the pairs
+@return An int variable containing the number of pairs which were found in this grid
+*/
+int CGrid::CollectPairs(CNarrowphase* cNarrowphase)
+{
+	int iNumOfPairs = 0;
 
-	// Check for collisions between CSolidObjects within this grid
+	std::map<unsigned int, CSolidObject*>::iterator it, it_other, end;
 	end = SolidObjectMap.end();
 	for (it = SolidObjectMap.begin(); it != end; ++it)
 	{
@@ -136,111 +176,58 @@ bool CGrid::Update(const double dElapsedTime)
 		if ((it->second)->GetStatus() == false)
 			continue;
 
-		for (it_other = it; it_other != end; ++it_other)
+		// Start from the next entity, so that each pair is only added once from this grid
+		it_other = it;
+		for (++it_other; it_other != end; ++it_other)
 		{
 			// If the entity is not active, then skip it
 			if ((it_other->second)->GetStatus() == false)
 				continue;
 
-			// If the 2 entities to check are the same, then skip this iteration
-			if (it_other->second == it->second)
-				continue;
-
-			//// Prepare the 2 bounding boxes for calculation 
-			//// with consideration for their heights
-			//if ((*it)->GetPosition().y < (*it_other)->GetPosition().y)
-			//{
-			lowerBoxMin = (it->second)->GetPosition() + (it->second)->boxMin;
-			lowerBoxMax = (it->second)->GetPosition() + (it->second)->boxMax;
-			upperBoxMin = (it_other->second)->GetPosition() + (it_other->second)->boxMin;
-			upperBoxMax = (it_other->second)->GetPosition() + (it_other->second)->boxMax;
-			//}
-			//else
-			//{
-			//	lowerBoxMin = (*it_other)->GetPosition() + (*it_other)->boxMin;
-			//	lowerBoxMax = (*it_other)->GetPosition() + (*it_other)->boxMax;
-			//	upperBoxMin = (*it)->GetPosition() + (*it)->boxMin;
-			//	upperBoxMax = (*it)->GetPosition() + (*it)->boxMax;
-			//}
-
-			// Check for collisions between the 2 entities
-			if (CCollisionManager::BoxBoxCollision(lowerBoxMin, lowerBoxMax,
-				upperBoxMin, upperBoxMax) == true)
-			{
-				// Check if a movable entity collides with another movable entity
-				if (
-					((it->second)->GetType() == CSolidObject::TYPE::PLAYER)
-					&&
-					(((it_other->second)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((it_other->second)->GetType() <= CSolidObject::TYPE::OTHERS))
-					)
-				{
-					(it->second)->RollbackPosition();
-					(it_other->second)->RollbackPosition();
-					bResult = true;
-					cout << "** Collision between Player and an Entity ***" << endl;
-					break;
-				}
-				else if (
-					(((it->second)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((it->second)->GetType() <= CSolidObject::TYPE::OTHERS))
-					&&
-					(((it_other->second)->GetType() >= CSolidObject::TYPE::NPC) &&
-						((it_other->second)->GetType() <= CSolidObject::TYPE::OTHERS))
-					)
-				{
-					(it->second)->RollbackPosition();
-					(it_other->second)->RollbackPosition();
-					cout << "** Collision between 2 Entities ***" << endl;
-					break;
-				}
-				// Check if a movable entity collides with a non-movable entity
-				if (
-					(((it->second)->GetType() >= CSolidObject::TYPE::PLAYER) &&
-						((it->second)->GetType() <= CSolidObject::TYPE::OTHERS))
-					&&
-					((it_other->second)->GetType() == CSolidObject::TYPE::STRUCTURE)
-					)
-				{
-					(it->second)->RollbackPosition();
-					if (((it->second)->GetType() == CSolidObject::TYPE::PLAYER))
-					{
-						cout << "Player collide with structure: " << (it->second)->GetPosition().y << endl;
-						//((CPlayer3D*)(*it))->SetPosition(glm::vec3((*it)->GetPosition().x, (*it)->GetPosition().y + 0.01f, (*it)->GetPosition().z));
-						((CPlayer3D*)(it->second))->SetToIdle();
-
-						// Check if the collision is in top-bottom direction
-						bResult = true;
-					}
-					cout << "** Collision between Entity and Structure ***" << endl;
-					break;
-				}
-			}
+			// A pair may also be in other grids, so the CNarrowphase will remove the duplicates
+			cNarrowphase->AddPair(it->second, it_other->second);
+			iNumOfPairs++;
 		}
 	}
 
-	// If the player had collided with another CSolidObject, then set the bloodscreen to true
-	if (bResult == true)
-	{
-		CCameraEffectsManager::GetInstance()->Get("BloodScreen")->SetStatus(true);
-	}
+	return iNumOfPairs;
+}
 
-	// If this grid is visible...
-	if (bVisible)
+/**
+@brief Test the pairs of active CSolidObjects in this grid on a worker thread.
+		The pairs are visited in the same order as CollectPairs, and the contacts are stored
+		in the buffer of the calling thread in the CNarrowphase.
+@param cNarrowphase A CNarrowphase* variable storing the CNarrowphase which stores the contacts
+@param uiGridOrder A const unsigned int variable containing the order of this grid in the serial path
+@param uiThreadIndex A const unsigned int variable containing the index of the calling thread
+@return An int variable containing the number of pairs which were found in this grid
+*/
+int CGrid::TestPairs(CNarrowphase* cNarrowphase, const unsigned int uiGridOrder, const unsigned int uiThreadIndex)
+{
+	int iNumOfPairs = 0;
+
+	std::map<unsigned int, CSolidObject*>::iterator it, it_other, end;
+	end = SolidObjectMap.end();
+	for (it = SolidObjectMap.begin(); it != end; ++it)
 	{
-		// Update the LOD of all CSolidObject in this Grid
-		end = SolidObjectMap.end();
-		for (it = SolidObjectMap.begin(); it != end; ++it)
+		// If the entity is not active, then skip it
+		if ((it->second)->GetStatus() == false)
+			continue;
+
+		// Start from the next entity, so that each pair is only tested once in this grid
+		it_other = it;
+		for (++it_other; it_other != end; ++it_other)
 		{
-			// If this CSolidObject has LOD, then assign a new LOD value to it
-			if ((it->second)->GetLODStatus()==true)
-				(it->second)->SetDetailLevel(cCurrentLOD.GetDetailLevel());
-		}
+			// If the entity is not active, then skip it
+			if ((it_other->second)->GetStatus() == false)
+				continue;
 
-		return true;
+			cNarrowphase->TestPairInThread(it->second, it_other->second, uiThreadIndex, uiGridOrder, iNumOfPairs);
+			iNumOfPairs++;
+		}
 	}
 
-	return false;
+	return iNumOfPairs;
 }
 
 /**
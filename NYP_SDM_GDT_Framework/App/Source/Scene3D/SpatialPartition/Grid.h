@@ -11,6 +11,9 @@
 //#include "../SceneGraph/SceneNode.h"
 #include "../Entities/SolidObject.h"
 
+// Include CNarrowphase
+#include "Narrowphase.h"
+
 // Include CLevelOfDetails
 #include "Primitives/LevelOfDetails.h"
 
@@ -30,10 +33,17 @@ public:
 	void Init(glm::vec3 vec3TopRight, glm::vec3 vec3BottomLeft);
 	// Init
 	void Init(glm::vec3 vec3TopRight, glm::vec3 vec3BottomLeft, float fTopLeftHeight, float fBottomRightHeight);
+	// Set the heights of the corners after the terrain was changed
+	void SetHeights(const float fBottomLeftHeight, const float fTopRightHeight, const float fTopLeftHeight, const float fBottomRightHeight);
 
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
 
+	// Add the pairs of active CSolidObjects in this grid to a CNarrowphase
+	int CollectPairs(CNarrowphase* cNarrowphase);
+	// Test the pairs of active CSolidObjects in this grid on a worker thread
+	int TestPairs(CNarrowphase* cNarrowphase, const unsigned int uiGridOrder, const unsigned int uiThreadIndex);
+
 	// PreRender
 	virtual void PreRender(void);
 	// Render
@@ -0,0 +1,586 @@
+/**
+ CInstanceBatch
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "InstanceBatch.h"
+
+#if defined(INSTANCEBATCH_AVX2)
+	#include <immintrin.h>
+#elif defined(INSTANCEBATCH_SSE2)
+	#include <emmintrin.h>
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CInstanceBatch::CInstanceBatch(void)
+	: uiNumOfLODs(1)
+	, fMidDistance(20.0f)
+	, fLowDistance(40.0f)
+	, uiNumOfVisibleInstances(0)
+	, vec3ChunkBottomLeft(glm::vec3(0.0f))
+	, vec3ChunkSize(glm::vec3(1.0f))
+	, iNumOfChunksX(1)
+	, iNumOfChunksZ(1)
+	, uiNumOfVisibleChunks(0)
+{
+	for (unsigned int i = 0; i < uiMaxNumOfLODs; i++)
+	{
+		arrNumOfVisibleInstances[i] = 0;
+		arrInstanceBuffers[i] = 0;
+	}
+}
+
+/**
+ @brief Destructor
+ */
+CInstanceBatch::~CInstanceBatch(void)
+{
+	Exit();
+}
+
+/**
+ @brief Set the model matrices of the instances, and create the buffers of the visible instances of each LOD.
+		The bounding sphere of each instance encloses the bounds of the mesh after its model matrix.
+		The instances are sorted into the chunks which were set by SetChunks.
+ @param vModelMatrices A const std::vector<glm::mat4>& variable containing the model matrices of the instances
+ @param vec3BoundsMin A const glm::vec3& variable containing the minimum corner of the bounds of the mesh
+ @param vec3BoundsMax A const glm::vec3& variable containing the maximum corner of the bounds of the mesh
+ @param uiNumOfLODs A const unsigned int variable containing the number of LODs, from 1 to uiMaxNumOfLODs
+ */
+void CInstanceBatch::Init(	const std::vector<glm::mat4>& vModelMatrices, const glm::vec3& vec3BoundsMin, const glm::vec3& vec3BoundsMax,
+							const unsigned int uiNumOfLODs)
+{
+	Exit();
+
+	this->uiNumOfLODs = uiNumOfLODs;
+	if (this->uiNumOfLODs < 1)
+		this->uiNumOfLODs = 1;
+	else if (this->uiNumOfLODs > uiMaxNumOfLODs)
+		this->uiNumOfLODs = uiMaxNumOfLODs;
+
+	this->vModelMatrices = vModelMatrices;
+	const unsigned int uiNumOfInstances = (unsigned int)vModelMatrices.size();
+
+	const glm::vec4 vec4MeshCentre = glm::vec4((vec3BoundsMin + vec3BoundsMax) * 0.5f, 1.0f);
+	const float fMeshRadius = glm::length(vec3BoundsMax - vec3BoundsMin) * 0.5f;
+	vCentreX.resize(uiNumOfInstances);
+	vCentreY.resize(uiNumOfInstances);
+	vCentreZ.resize(uiNumOfInstances);
+	vRadius.resize(uiNumOfInstances);
+	for (unsigned int i = 0; i < uiNumOfInstances; i++)
+	{
+		const glm::mat4& model = vModelMatrices[i];
+		const glm::vec4 vec4Centre = model * vec4MeshCentre;
+		vCentreX[i] = vec4Centre.x;
+		vCentreY[i] = vec4Centre.y;
+		vCentreZ[i] = vec4Centre.z;
+
+		// The radius is scaled by the largest scale of the model matrix
+		float fScale = glm::length(glm::vec3(model[0]));
+		float fScaleY = glm::length(glm::vec3(model[1]));
+		float fScaleZ = glm::length(glm::vec3(model[2]));
+		if (fScaleY > fScale)
+			fScale = fScaleY;
+		if (fScaleZ > fScale)
+			fScale = fScaleZ;
+		vRadius[i] = fMeshRadius * fScale;
+	}
+
+	// Sort the instances into the chunks, so that each chunk owns a contiguous range of the instances
+	BuildChunks();
+
+	// Each LOD can have all the instances, when the camera is far away from or near to all of them
+	glGenBuffers(this->uiNumOfLODs, arrInstanceBuffers);
+	for (unsigned int i = 0; i < this->uiNumOfLODs; i++)
+	{
+		arrVisibleModelMatrices[i].resize(uiNumOfInstances);
+		arrNumOfVisibleInstances[i] = 0;
+
+		glBindBuffer(GL_ARRAY_BUFFER, arrInstanceBuffers[i]);
+		glBufferData(GL_ARRAY_BUFFER, uiNumOfInstances * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	uiNumOfVisibleInstances = 0;
+}
+
+/**
+ @brief Delete the buffers of the visible instances
+ */
+void CInstanceBatch::Exit(void)
+{
+	for (unsigned int i = 0; i < uiMaxNumOfLODs; i++)
+	{
+		if (arrInstanceBuffers[i] != 0)
+		{
+			glDeleteBuffers(1, &arrInstanceBuffers[i]);
+			arrInstanceBuffers[i] = 0;
+		}
+		arrVisibleModelMatrices[i].clear();
+		arrNumOfVisibleInstances[i] = 0;
+	}
+	vModelMatrices.clear();
+	vCentreX.clear();
+	vCentreY.clear();
+	vCentreZ.clear();
+	vRadius.clear();
+	uiNumOfVisibleInstances = 0;
+	vChunks.clear();
+	uiNumOfVisibleChunks = 0;
+}
+
+/**
+ @brief Set the chunks which the instances are sorted into by Init. The chunks should be aligned with the
+		CGrids of the CSpatialPartition. Each chunk is a column along the Y-axis, so it has no Y position or size.
+ @param vec3BottomLeft A const glm::vec3& variable containing the bottom left corner of the chunks
+ @param vec3ChunkSize A const glm::vec3& variable containing the size of each chunk
+ @param iNumOfChunksX A const int variable containing the number of chunks in the X-axis
+ @param iNumOfChunksZ A const int variable containing the number of chunks in the Z-axis
+ */
+void CInstanceBatch::SetChunks(const glm::vec3& vec3BottomLeft, const glm::vec3& vec3ChunkSize, const int iNumOfChunksX, const int iNumOfChunksZ)
+{
+	// Use 1 chunk for all the instances if the chunks are not valid
+	if ((vec3ChunkSize.x <= 0.0f) || (vec3ChunkSize.z <= 0.0f) || (iNumOfChunksX < 1) || (iNumOfChunksZ < 1))
+	{
+		this->vec3ChunkBottomLeft = glm::vec3(0.0f);
+		this->vec3ChunkSize = glm::vec3(1.0f);
+		this->iNumOfChunksX = 1;
+		this->iNumOfChunksZ = 1;
+		return;
+	}
+
+	this->vec3ChunkBottomLeft = vec3BottomLeft;
+	this->vec3ChunkSize = vec3ChunkSize;
+	this->iNumOfChunksX = iNumOfChunksX;
+	this->iNumOfChunksZ = iNumOfChunksZ;
+}
+
+/**
+ @brief Set the distances to the camera from which the instances use the mid and the low LOD
+ @param fMidDistance A const float variable containing the distance from which the instances use the mid LOD
+ @param fLowDistance A const float variable containing the distance from which the instances use the low LOD
+ */
+void CInstanceBatch::SetLODDistances(const float fMidDistance, const float fLowDistance)
+{
+	this->fMidDistance = fMidDistance;
+	this->fLowDistance = fLowDistance;
+}
+
+/**
+ @brief Set the buffer of the visible instances of a LOD as the model matrix attributes of a VAO.
+		The model matrix uses 4 attributes from uiFirstAttribute, one for each column, with a divisor of 1.
+ @param uiVAO A const GLuint variable containing the VAO
+ @param uiFirstAttribute A const GLuint variable containing the first attribute of the model matrix
+ @param uiLOD A const unsigned int variable containing the LOD, where 0 is the highest detail
+ */
+void CInstanceBatch::SetupVertexArray(const GLuint uiVAO, const GLuint uiFirstAttribute, const unsigned int uiLOD) const
+{
+	if (uiLOD >= uiNumOfLODs)
+		return;
+
+	glBindVertexArray(uiVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, arrInstanceBuffers[uiLOD]);
+	for (GLuint i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(uiFirstAttribute + i);
+		glVertexAttribPointer(uiFirstAttribute + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+		glVertexAttribDivisor(uiFirstAttribute + i, 1);
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ @brief Cull the instances against the frustum of a view and projection, and upload the model matrices
+		of the visible instances of each LOD. A chunk is culled if its bounding box is outside of any plane,
+		and an instance is culled if its bounding sphere is outside of any plane. A visible instance uses
+		the LOD for the distance from the camera to its centre.
+ @param view A const glm::mat4& variable containing the view of the pass which draws the instances
+ @param projection A const glm::mat4& variable containing the projection of the pass which draws the instances
+ @return The number of visible instances of all the LODs
+ */
+unsigned int CInstanceBatch::Cull(const glm::mat4& view, const glm::mat4& projection)
+{
+	const unsigned int uiNumOfInstances = (unsigned int)vModelMatrices.size();
+	for (unsigned int i = 0; i < uiMaxNumOfLODs; i++)
+		arrNumOfVisibleInstances[i] = 0;
+	uiNumOfVisibleInstances = 0;
+	uiNumOfVisibleChunks = 0;
+	if (uiNumOfInstances == 0)
+		return 0;
+
+	cFrustumCulling.SetView(view);
+	cFrustumCulling.SetProjection(projection);
+	cFrustumCulling.UpdatePlanes();
+	glm::vec4 vec4Planes[6];
+	cFrustumCulling.GetPlanes(vec4Planes);
+
+	// The position of the camera is the translation of the inverse of the view
+	const glm::vec3 vec3Camera = glm::vec3(glm::inverse(view)[3]);
+	// The distances are compared squared, so that no square root is needed
+	const float fMidDistanceSquared = fMidDistance * fMidDistance;
+	const float fLowDistanceSquared = fLowDistance * fLowDistance;
+
+	for (unsigned int i = 0; i < vChunks.size(); i++)
+	{
+		const SChunk& sChunk = vChunks[i];
+
+		// Test the corners of the bounding box which are the furthest along and against the normal of each plane.
+		// The chunk is outside if the furthest corner is outside of a plane, and it is inside if the nearest
+		// corners are inside of all the planes.
+		bool bOutside = false;
+		bool bInside = true;
+		for (int j = 0; j < 6; j++)
+		{
+			const glm::vec4& vec4Plane = vec4Planes[j];
+			const float fFurthest = vec4Plane.x * (vec4Plane.x >= 0.0f ? sChunk.vec3Max.x : sChunk.vec3Min.x)
+								  + vec4Plane.y * (vec4Plane.y >= 0.0f ? sChunk.vec3Max.y : sChunk.vec3Min.y)
+								  + vec4Plane.z * (vec4Plane.z >= 0.0f ? sChunk.vec3Max.z : sChunk.vec3Min.z) + vec4Plane.w;
+			if (fFurthest < 0.0f)
+			{
+				bOutside = true;
+				break;
+			}
+			const float fNearest = vec4Plane.x * (vec4Plane.x >= 0.0f ? sChunk.vec3Min.x : sChunk.vec3Max.x)
+								 + vec4Plane.y * (vec4Plane.y >= 0.0f ? sChunk.vec3Min.y : sChunk.vec3Max.y)
+								 + vec4Plane.z * (vec4Plane.z >= 0.0f ? sChunk.vec3Min.z : sChunk.vec3Max.z) + vec4Plane.w;
+			if (fNearest < 0.0f)
+				bInside = false;
+		}
+		if (bOutside)
+			continue;
+		uiNumOfVisibleChunks++;
+
+		// Calculate the squared distances from the camera to the nearest and the furthest points of the bounding box
+		float fNearestSquared = 0.0f, fFurthestSquared = 0.0f;
+		for (int j = 0; j < 3; j++)
+		{
+			const float fToMin = vec3Camera[j] - sChunk.vec3Min[j];
+			const float fToMax = sChunk.vec3Max[j] - vec3Camera[j];
+			if (fToMin < 0.0f)
+				fNearestSquared += fToMin * fToMin;
+			else if (fToMax < 0.0f)
+				fNearestSquared += fToMax * fToMax;
+			const float fFurthest = (fToMin > fToMax ? fToMin : fToMax);
+			fFurthestSquared += fFurthest * fFurthest;
+		}
+		const unsigned int uiNearestLOD = (fNearestSquared >= fMidDistanceSquared ? 1 : 0) + (fNearestSquared >= fLowDistanceSquared ? 1 : 0);
+		const unsigned int uiFurthestLOD = (fFurthestSquared >= fMidDistanceSquared ? 1 : 0) + (fFurthestSquared >= fLowDistanceSquared ? 1 : 0);
+
+		// Add the whole range if all its instances are visible and use the same LOD.
+		// Otherwise, the planes are only tested if the chunk is not inside of all of them.
+		if (bInside && (uiNearestLOD == uiFurthestLOD))
+			AddVisibleRange(sChunk.uiFirst, sChunk.uiNumOfInstances, uiNearestLOD);
+		else
+			CullRange(	sChunk.uiFirst, sChunk.uiFirst + sChunk.uiNumOfInstances,
+						vec4Planes, bInside ? 0 : 6,
+						vec3Camera, fMidDistanceSquared, fLowDistanceSquared);
+	}
+
+	// Orphan the buffers before writing to them, so that the draws of the previous view do not have to finish first
+	for (unsigned int j = 0; j < uiNumOfLODs; j++)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, arrInstanceBuffers[j]);
+		glBufferData(GL_ARRAY_BUFFER, uiNumOfInstances * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+		if (arrNumOfVisibleInstances[j] > 0)
+			glBufferSubData(GL_ARRAY_BUFFER, 0, arrNumOfVisibleInstances[j] * sizeof(glm::mat4), &arrVisibleModelMatrices[j][0]);
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return uiNumOfVisibleInstances;
+}
+
+/**
+ @brief Get the number of instances
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfInstances(void) const
+{
+	return (unsigned int)vModelMatrices.size();
+}
+
+/**
+ @brief Get the number of LODs
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfLODs(void) const
+{
+	return uiNumOfLODs;
+}
+
+/**
+ @brief Get the number of chunks which have instances
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfChunks(void) const
+{
+	return (unsigned int)vChunks.size();
+}
+
+/**
+ @brief Get the number of chunks which were not culled in the last Cull
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfVisibleChunks(void) const
+{
+	return uiNumOfVisibleChunks;
+}
+
+/**
+ @brief Get the number of instances which were visible in the last Cull
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfVisibleInstances(void) const
+{
+	return uiNumOfVisibleInstances;
+}
+
+/**
+ @brief Get the number of instances of a LOD which were visible in the last Cull
+ @param uiLOD A const unsigned int variable containing the LOD, where 0 is the highest detail
+ @return A unsigned int variable
+ */
+unsigned int CInstanceBatch::GetNumOfVisibleInstances(const unsigned int uiLOD) const
+{
+	if (uiLOD >= uiNumOfLODs)
+		return 0;
+	return arrNumOfVisibleInstances[uiLOD];
+}
+
+/**
+ @brief PrintSelf
+ */
+void CInstanceBatch::PrintSelf(void) const
+{
+	cout << "Instances: " << uiNumOfVisibleInstances << " drawn out of " << vModelMatrices.size() << endl;
+	cout << "Chunks: " << uiNumOfVisibleChunks << " visible out of " << vChunks.size() << endl;
+	for (unsigned int i = 0; i < uiNumOfLODs; i++)
+		cout << "\tLOD " << i << ": " << arrNumOfVisibleInstances[i] << endl;
+}
+
+/**
+ @brief Add a visible instance to the model matrices of a LOD. The instances which are further than
+		the lowest LOD of this batch use the lowest LOD.
+ @param uiInstance A const unsigned int variable containing the index of the instance
+ @param uiLOD A const unsigned int variable containing the LOD, where 0 is the highest detail
+ */
+void CInstanceBatch::AddVisibleInstance(const unsigned int uiInstance, const unsigned int uiLOD)
+{
+	const unsigned int uiBucket = (uiLOD < uiNumOfLODs ? uiLOD : uiNumOfLODs - 1);
+	arrVisibleModelMatrices[uiBucket][arrNumOfVisibleInstances[uiBucket]++] = vModelMatrices[uiInstance];
+	uiNumOfVisibleInstances++;
+}
+
+/**
+ @brief Add a range of visible instances to the model matrices of a LOD
+ @param uiFirst A const unsigned int variable containing the first instance of the range
+ @param uiNumOfInstances A const unsigned int variable containing the number of instances in the range
+ @param uiLOD A const unsigned int variable containing the LOD, where 0 is the highest detail
+ */
+void CInstanceBatch::AddVisibleRange(const unsigned int uiFirst, const unsigned int uiNumOfInstances, const unsigned int uiLOD)
+{
+	const unsigned int uiBucket = (uiLOD < uiNumOfLODs ? uiLOD : uiNumOfLODs - 1);
+	std::copy(	vModelMatrices.begin() + uiFirst, vModelMatrices.begin() + uiFirst + uiNumOfInstances,
+				arrVisibleModelMatrices[uiBucket].begin() + arrNumOfVisibleInstances[uiBucket]);
+	arrNumOfVisibleInstances[uiBucket] += uiNumOfInstances;
+	uiNumOfVisibleInstances += uiNumOfInstances;
+}
+
+/**
+ @brief Sort the instances into the chunks, and calculate the bounds of the chunks. The chunk of an
+		instance is found from the centre of its bounding sphere, and the instances which are outside
+		of the chunks are put into the nearest chunk. The instances are sorted with a counting sort,
+		so the instances in a chunk keep their order.
+ */
+void CInstanceBatch::BuildChunks(void)
+{
+	vChunks.clear();
+	const unsigned int uiNumOfInstances = (unsigned int)vModelMatrices.size();
+	if (uiNumOfInstances == 0)
+		return;
+
+	// Count the instances in each chunk
+	const unsigned int uiNumOfCells = (unsigned int)(iNumOfChunksX * iNumOfChunksZ);
+	vector<unsigned int> vCellOfInstance(uiNumOfInstances);
+	vector<unsigned int> vFirstOfCell(uiNumOfCells + 1, 0);
+	for (unsigned int i = 0; i < uiNumOfInstances; i++)
+	{
+		int iChunkX = (int)floor((vCentreX[i] - vec3ChunkBottomLeft.x) / vec3ChunkSize.x);
+		int iChunkZ = (int)floor((vCentreZ[i] - vec3ChunkBottomLeft.z) / vec3ChunkSize.z);
+		if (iChunkX < 0)
+			iChunkX = 0;
+		else if (iChunkX >= iNumOfChunksX)
+			iChunkX = iNumOfChunksX - 1;
+		if (iChunkZ < 0)
+			iChunkZ = 0;
+		else if (iChunkZ >= iNumOfChunksZ)
+			iChunkZ = iNumOfChunksZ - 1;
+
+		// The chunks are in the same order as the CGrids, which are stored by rows of X and then columns of Z
+		vCellOfInstance[i] = (unsigned int)(iChunkX * iNumOfChunksZ + iChunkZ);
+		vFirstOfCell[vCellOfInstance[i] + 1]++;
+	}
+	for (unsigned int i = 0; i < uiNumOfCells; i++)
+		vFirstOfCell[i + 1] += vFirstOfCell[i];
+
+	// Move the instances to their ranges
+	const vector<glm::mat4> vUnsortedModelMatrices = vModelMatrices;
+	const vector<float> vUnsortedCentreX = vCentreX, vUnsortedCentreY = vCentreY, vUnsortedCentreZ = vCentreZ, vUnsortedRadius = vRadius;
+	vector<unsigned int> vNextOfCell(vFirstOfCell.begin(), vFirstOfCell.end() - 1);
+	for (unsigned int i = 0; i < uiNumOfInstances; i++)
+	{
+		const unsigned int uiSorted = vNextOfCell[vCellOfInstance[i]]++;
+		vModelMatrices[uiSorted] = vUnsortedModelMatrices[i];
+		vCentreX[uiSorted] = vUnsortedCentreX[i];
+		vCentreY[uiSorted] = vUnsortedCentreY[i];
+		vCentreZ[uiSorted] = vUnsortedCentreZ[i];
+		vRadius[uiSorted] = vUnsortedRadius[i];
+	}
+
+	// Create the chunks which have instances, with the bounding boxes of the bounding spheres of their instances
+	for (unsigned int i = 0; i < uiNumOfCells; i++)
+	{
+		if (vFirstOfCell[i + 1] == vFirstOfCell[i])
+			continue;
+
+		SChunk sChunk;
+		sChunk.uiFirst = vFirstOfCell[i];
+		sChunk.uiNumOfInstances = vFirstOfCell[i + 1] - vFirstOfCell[i];
+		for (unsigned int j = sChunk.uiFirst; j < vFirstOfCell[i + 1]; j++)
+		{
+			const glm::vec3 vec3Min = glm::vec3(vCentreX[j], vCentreY[j], vCentreZ[j]) - glm::vec3(vRadius[j]);
+			const glm::vec3 vec3Max = glm::vec3(vCentreX[j], vCentreY[j], vCentreZ[j]) + glm::vec3(vRadius[j]);
+			for (int k = 0; k < 3; k++)
+			{
+				if ((j == sChunk.uiFirst) || (vec3Min[k] < sChunk.vec3Min[k]))
+					sChunk.vec3Min[k] = vec3Min[k];
+				if ((j == sChunk.uiFirst) || (vec3Max[k] > sChunk.vec3Max[k]))
+					sChunk.vec3Max[k] = vec3Max[k];
+			}
+		}
+		vChunks.push_back(sChunk);
+	}
+}
+
+/**
+ @brief Cull a range of instances against some planes, and add the visible instances to their LODs
+ @param uiFirst A const unsigned int variable containing the first instance of the range
+ @param uiLast A const unsigned int variable containing the instance after the last instance of the range
+ @param pvec4Planes A const glm::vec4* variable containing the planes of the frustum
+ @param iNumOfPlanes A const int variable containing the number of planes to test, which is 0 if the range is inside of all of them
+ @param vec3Camera A const glm::vec3& variable containing the position of the camera
+ @param fMidDistanceSquared A const float variable containing the squared distance from which the instances use the mid LOD
+ @param fLowDistanceSquared A const float variable containing the squared distance from which the instances use the low LOD
+ */
+void CInstanceBatch::CullRange(	const unsigned int uiFirst, const unsigned int uiLast,
+								const glm::vec4* pvec4Planes, const int iNumOfPlanes,
+								const glm::vec3& vec3Camera, const float fMidDistanceSquared, const float fLowDistanceSquared)
+{
+	unsigned int i = uiFirst;
+
+#if defined(INSTANCEBATCH_AVX2)
+	for (; i + 8 <= uiLast; i += 8)
+	{
+		const __m256 m256CentreX = _mm256_loadu_ps(&vCentreX[i]);
+		const __m256 m256CentreY = _mm256_loadu_ps(&vCentreY[i]);
+		const __m256 m256CentreZ = _mm256_loadu_ps(&vCentreZ[i]);
+		// The negative radii, which the distances to the planes are compared against
+		const __m256 m256NegRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&vRadius[i]));
+
+		__m256 m256Visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (int j = 0; j < iNumOfPlanes; j++)
+		{
+			__m256 m256Distance = _mm256_add_ps(_mm256_mul_ps(m256CentreX, _mm256_set1_ps(pvec4Planes[j].x)),
+												_mm256_mul_ps(m256CentreY, _mm256_set1_ps(pvec4Planes[j].y)));
+			m256Distance = _mm256_add_ps(m256Distance, _mm256_mul_ps(m256CentreZ, _mm256_set1_ps(pvec4Planes[j].z)));
+			m256Distance = _mm256_add_ps(m256Distance, _mm256_set1_ps(pvec4Planes[j].w));
+			m256Visible = _mm256_and_ps(m256Visible, _mm256_cmp_ps(m256Distance, m256NegRadius, _CMP_GE_OQ));
+		}
+		const int iMask = _mm256_movemask_ps(m256Visible);
+		if (iMask == 0)
+			continue;
+
+		// Calculate the squared distances to the camera, and compare them against the LOD distances
+		const __m256 m256DeltaX = _mm256_sub_ps(m256CentreX, _mm256_set1_ps(vec3Camera.x));
+		const __m256 m256DeltaY = _mm256_sub_ps(m256CentreY, _mm256_set1_ps(vec3Camera.y));
+		const __m256 m256DeltaZ = _mm256_sub_ps(m256CentreZ, _mm256_set1_ps(vec3Camera.z));
+		const __m256 m256DistanceSquared = _mm256_add_ps(_mm256_add_ps(	_mm256_mul_ps(m256DeltaX, m256DeltaX),
+																		_mm256_mul_ps(m256DeltaY, m256DeltaY)),
+																		_mm256_mul_ps(m256DeltaZ, m256DeltaZ));
+		const int iMidMask = _mm256_movemask_ps(_mm256_cmp_ps(m256DistanceSquared, _mm256_set1_ps(fMidDistanceSquared), _CMP_GE_OQ));
+		const int iLowMask = _mm256_movemask_ps(_mm256_cmp_ps(m256DistanceSquared, _mm256_set1_ps(fLowDistanceSquared), _CMP_GE_OQ));
+
+		// Compact the model matrices of the visible instances into their LODs
+		for (unsigned int k = 0; k < 8; k++)
+		{
+			if (iMask & (1 << k))
+				AddVisibleInstance(i + k, ((iMidMask >> k) & 1) + ((iLowMask >> k) & 1));
+		}
+	}
+#elif defined(INSTANCEBATCH_SSE2)
+	for (; i + 4 <= uiLast; i += 4)
+	{
+		const __m128 m128CentreX = _mm_loadu_ps(&vCentreX[i]);
+		const __m128 m128CentreY = _mm_loadu_ps(&vCentreY[i]);
+		const __m128 m128CentreZ = _mm_loadu_ps(&vCentreZ[i]);
+		// The negative radii, which the distances to the planes are compared against
+		const __m128 m128NegRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&vRadius[i]));
+
+		__m128 m128Visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (int j = 0; j < iNumOfPlanes; j++)
+		{
+			__m128 m128Distance = _mm_add_ps(_mm_mul_ps(m128CentreX, _mm_set1_ps(pvec4Planes[j].x)),
+											 _mm_mul_ps(m128CentreY, _mm_set1_ps(pvec4Planes[j].y)));
+			m128Distance = _mm_add_ps(m128Distance, _mm_mul_ps(m128CentreZ, _mm_set1_ps(pvec4Planes[j].z)));
+			m128Distance = _mm_add_ps(m128Distance, _mm_set1_ps(pvec4Planes[j].w));
+			m128Visible = _mm_and_ps(m128Visible, _mm_cmpge_ps(m128Distance, m128NegRadius));
+		}
+		const int iMask = _mm_movemask_ps(m128Visible);
+		if (iMask == 0)
+			continue;
+
+		// Calculate the squared distances to the camera, and compare them against the LOD distances
+		const __m128 m128DeltaX = _mm_sub_ps(m128CentreX, _mm_set1_ps(vec3Camera.x));
+		const __m128 m128DeltaY = _mm_sub_ps(m128CentreY, _mm_set1_ps(vec3Camera.y));
+		const __m128 m128DeltaZ = _mm_sub_ps(m128CentreZ, _mm_set1_ps(vec3Camera.z));
+		const __m128 m128DistanceSquared = _mm_add_ps(_mm_add_ps(	_mm_mul_ps(m128DeltaX, m128DeltaX),
+																	_mm_mul_ps(m128DeltaY, m128DeltaY)),
+																	_mm_mul_ps(m128DeltaZ, m128DeltaZ));
+		const int iMidMask = _mm_movemask_ps(_mm_cmpge_ps(m128DistanceSquared, _mm_set1_ps(fMidDistanceSquared)));
+		const int iLowMask = _mm_movemask_ps(_mm_cmpge_ps(m128DistanceSquared, _mm_set1_ps(fLowDistanceSquared)));
+
+		// Compact the model matrices of the visible instances into their LODs
+		for (unsigned int k = 0; k < 4; k++)
+		{
+			if (iMask & (1 << k))
+				AddVisibleInstance(i + k, ((iMidMask >> k) & 1) + ((iLowMask >> k) & 1));
+		}
+	}
+#endif
+
+	// Test the remaining instances with the scalar instructions
+	for (; i < uiLast; i++)
+	{
+		bool bVisible = true;
+		for (int j = 0; (j < iNumOfPlanes) && bVisible; j++)
+		{
+			const float fDistance = vCentreX[i] * pvec4Planes[j].x + vCentreY[i] * pvec4Planes[j].y + vCentreZ[i] * pvec4Planes[j].z + pvec4Planes[j].w;
+			bVisible = (fDistance >= -vRadius[i]);
+		}
+		if (bVisible == false)
+			continue;
+
+		const float fDeltaX = vCentreX[i] - vec3Camera.x;
+		const float fDeltaY = vCentreY[i] - vec3Camera.y;
+		const float fDeltaZ = vCentreZ[i] - vec3Camera.z;
+		const float fDistanceSquared = fDeltaX * fDeltaX + fDeltaY * fDeltaY + fDeltaZ * fDeltaZ;
+		AddVisibleInstance(i, (fDistanceSquared >= fMidDistanceSquared ? 1 : 0) + (fDistanceSquared >= fLowDistanceSquared ? 1 : 0));
+	}
+}
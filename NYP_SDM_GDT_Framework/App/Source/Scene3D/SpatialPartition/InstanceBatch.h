@@ -0,0 +1,128 @@
+/**
+ CInstanceBatch
+ @brief This class culls the instances of an instanced mesh against the frustum of each view.
+		Each instance has a bounding sphere, and the spheres are stored as arrays of floats (SoA),
+		so that SSE or AVX2 can test 4 or 8 of them per instruction. The instances are sorted into
+		chunks, which are aligned with the CGrids of the CSpatialPartition, so that each chunk owns a
+		contiguous range of instances. A chunk which is outside of the frustum skips its whole range,
+		and a chunk which is inside of it skips the tests of its instances. The visible instances are
+		bucketed into the levels of detail (LOD) by their distance to the camera, and the model
+		matrices of each LOD are compacted into its own buffer. Each LOD is drawn with one
+		glDrawElementsInstanced, with a VAO which uses the mesh of that LOD and its buffer.
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLEW
+#include <GL/glew.h>
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include FrustumCulling
+#include "FrustumCulling.h"
+
+#include <vector>
+using namespace std;
+
+// Select the widest SIMD instruction set which the compiler is targeting
+#if defined(__AVX2__)
+	#define INSTANCEBATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define INSTANCEBATCH_SSE2
+#endif
+
+class CInstanceBatch
+{
+public:
+	// Constructor
+	CInstanceBatch(void);
+	// Destructor
+	~CInstanceBatch(void);
+
+	// The maximum number of LODs, which is the same as the number of LODs of a CSolidObject
+	static const unsigned int uiMaxNumOfLODs = 3;
+
+	// Set the model matrices of the instances, and create the buffers of the visible instances of each LOD
+	void Init(	const std::vector<glm::mat4>& vModelMatrices, const glm::vec3& vec3BoundsMin, const glm::vec3& vec3BoundsMax,
+				const unsigned int uiNumOfLODs = 1);
+	// Delete the buffers of the visible instances
+	void Exit(void);
+
+	// Set the chunks which the instances are sorted into by Init. Each chunk is a column along the Y-axis.
+	void SetChunks(const glm::vec3& vec3BottomLeft, const glm::vec3& vec3ChunkSize, const int iNumOfChunksX, const int iNumOfChunksZ);
+
+	// Set the distances to the camera from which the instances use the mid and the low LOD
+	void SetLODDistances(const float fMidDistance, const float fLowDistance);
+
+	// Set the buffer of the visible instances of a LOD as the model matrix attributes of a VAO
+	void SetupVertexArray(const GLuint uiVAO, const GLuint uiFirstAttribute, const unsigned int uiLOD = 0) const;
+
+	// Cull the instances against the frustum of a view and projection, and upload the model matrices of the visible instances of each LOD
+	unsigned int Cull(const glm::mat4& view, const glm::mat4& projection);
+
+	// Get the number of instances
+	unsigned int GetNumOfInstances(void) const;
+	// Get the number of LODs
+	unsigned int GetNumOfLODs(void) const;
+	// Get the number of chunks which have instances
+	unsigned int GetNumOfChunks(void) const;
+	// Get the number of chunks which were not culled in the last Cull
+	unsigned int GetNumOfVisibleChunks(void) const;
+	// Get the number of instances which were visible in the last Cull
+	unsigned int GetNumOfVisibleInstances(void) const;
+	// Get the number of instances of a LOD which were visible in the last Cull
+	unsigned int GetNumOfVisibleInstances(const unsigned int uiLOD) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// A chunk, which owns a contiguous range of the instances
+	struct SChunk
+	{
+		// The first instance and the number of instances
+		unsigned int uiFirst;
+		unsigned int uiNumOfInstances;
+		// The bounding box of the bounding spheres of the instances
+		glm::vec3 vec3Min, vec3Max;
+	};
+
+	// The model matrices of all the instances, sorted by their chunks
+	std::vector<glm::mat4> vModelMatrices;
+	// The bounding spheres of the instances, in world space
+	std::vector<float> vCentreX, vCentreY, vCentreZ, vRadius;
+	// The number of LODs, and the distances to the camera from which the instances use the mid and the low LOD
+	unsigned int uiNumOfLODs;
+	float fMidDistance, fLowDistance;
+
+	// The model matrices of the visible instances of each LOD, which are uploaded to arrInstanceBuffers
+	std::vector<glm::mat4> arrVisibleModelMatrices[uiMaxNumOfLODs];
+	unsigned int arrNumOfVisibleInstances[uiMaxNumOfLODs];
+	unsigned int uiNumOfVisibleInstances;
+
+	// The buffers of the model matrices of the visible instances of each LOD
+	GLuint arrInstanceBuffers[uiMaxNumOfLODs];
+
+	// The bottom left corner and the size of the chunks, and the number of chunks in X-, Z-axes
+	glm::vec3 vec3ChunkBottomLeft, vec3ChunkSize;
+	int iNumOfChunksX, iNumOfChunksZ;
+	// The chunks which have instances
+	std::vector<SChunk> vChunks;
+	unsigned int uiNumOfVisibleChunks;
+
+	// Sort the instances into the chunks, and calculate the bounds of the chunks
+	void BuildChunks(void);
+	// Cull a range of instances against some planes, and add the visible instances to their LODs
+	void CullRange(	const unsigned int uiFirst, const unsigned int uiLast,
+					const glm::vec4* pvec4Planes, const int iNumOfPlanes,
+					const glm::vec3& vec3Camera, const float fMidDistanceSquared, const float fLowDistanceSquared);
+	// Add a visible instance to the model matrices of a LOD
+	void AddVisibleInstance(const unsigned int uiInstance, const unsigned int uiLOD);
+	// Add a range of visible instances to the model matrices of a LOD
+	void AddVisibleRange(const unsigned int uiFirst, const unsigned int uiNumOfInstances, const unsigned int uiLOD);
+
+	// The frustum which the instances are culled against. It is updated with the view and projection of each Cull.
+	CFrustumCulling cFrustumCulling;
+};
@@ -0,0 +1,406 @@
+/**
+ CNarrowphase
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "Narrowphase.h"
+
+// Include CCollisionManager
+#include "Primitives/CollisionManager.h"
+
+// Include CPlayer3D
+#include "../Entities/Player3D.h"
+
+#include <algorithm>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CNarrowphase::CNarrowphase(void)
+	: iNumOfThreadPairs(0)
+	, iNumOfDuplicates(0)
+	, bLogging(false)
+{
+	// Set the default responses
+	arrCallbacks[(unsigned int)PAIRTYPE::PLAYER_NPC] = PlayerNPCResponse;
+	arrCallbacks[(unsigned int)PAIRTYPE::NPC_NPC] = NPCNPCResponse;
+	arrCallbacks[(unsigned int)PAIRTYPE::ENTITY_STRUCTURE] = EntityStructureResponse;
+}
+
+/**
+ @brief Destructor
+ */
+CNarrowphase::~CNarrowphase(void)
+{
+	// We won't delete the CSolidObjects since they were created elsewhere
+	Reset();
+}
+
+/**
+ @brief Clear the pairs and contacts from the previous frame
+ */
+void CNarrowphase::Reset(void)
+{
+	setPairKeys.clear();
+	vPairs.clear();
+	vContacts.clear();
+	for (unsigned int i = 0; i < vThreadCandidates.size(); i++)
+	{
+		vThreadCandidates[i].clear();
+		vThreadNumOfPairs[i] = 0;
+	}
+	vMergedCandidates.clear();
+	iNumOfThreadPairs = 0;
+	iNumOfDuplicates = 0;
+}
+
+/**
+ @brief Add a pair of CSolidObjects from the broadphase.
+		A pair which is found in several CGrids is only added once.
+ @param cSolidObjectA A CSolidObject* variable storing the first CSolidObject
+ @param cSolidObjectB A CSolidObject* variable storing the second CSolidObject
+ @return A bool variable which is true if this pair was added, or false if it was already added
+ */
+bool CNarrowphase::AddPair(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB)
+{
+	if ((cSolidObjectA == NULL) || (cSolidObjectB == NULL) || (cSolidObjectA == cSolidObjectB))
+		return false;
+
+	if (setPairKeys.insert(GetPairKey(cSolidObjectA, cSolidObjectB)).second == false)
+	{
+		iNumOfDuplicates++;
+		return false;
+	}
+
+	SPair sPair;
+	sPair.cSolidObjectA = cSolidObjectA;
+	sPair.cSolidObjectB = cSolidObjectB;
+	vPairs.push_back(sPair);
+	return true;
+}
+
+/**
+ @brief Test the pairs, store the contacts and call the callbacks.
+		All the pairs are tested before any callback is called, so the contacts do not depend
+		on the responses, and the parallel path finds the same contacts.
+ @return A bool variable which is true if the player had collided with another CSolidObject
+ */
+bool CNarrowphase::Resolve(void)
+{
+	SContact sContact;
+	for (unsigned int i = 0; i < vPairs.size(); i++)
+	{
+		if (TestPair(vPairs[i].cSolidObjectA, vPairs[i].cSolidObjectB, sContact) == true)
+			vContacts.push_back(sContact);
+	}
+
+	return Respond();
+}
+
+/**
+ @brief Prepare one buffer of candidate contacts for each thread, for the parallel path
+ @param uiNumOfThreads A const unsigned int variable containing the number of threads
+ */
+void CNarrowphase::PrepareThreadBuffers(const unsigned int uiNumOfThreads)
+{
+	if (vThreadCandidates.size() < uiNumOfThreads)
+	{
+		vThreadCandidates.resize(uiNumOfThreads);
+		vThreadNumOfPairs.resize(uiNumOfThreads, 0);
+	}
+}
+
+/**
+ @brief Test a pair on a worker thread, and store the contact in the buffer of that thread.
+		Each thread only writes to its own buffer, so no locking is needed.
+ @param cSolidObjectA A CSolidObject* variable storing the first CSolidObject
+ @param cSolidObjectB A CSolidObject* variable storing the second CSolidObject
+ @param uiThreadIndex A const unsigned int variable containing the index of the calling thread
+ @param uiGridOrder A const unsigned int variable containing the order of the CGrid which has this pair
+ @param uiPairOrder A const unsigned int variable containing the order of this pair in the CGrid
+ @return A bool variable which is true if the 2 CSolidObjects collide
+ */
+bool CNarrowphase::TestPairInThread(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB,
+									const unsigned int uiThreadIndex,
+									const unsigned int uiGridOrder, const unsigned int uiPairOrder)
+{
+	if ((cSolidObjectA == NULL) || (cSolidObjectB == NULL) || (cSolidObjectA == cSolidObjectB))
+		return false;
+
+	vThreadNumOfPairs[uiThreadIndex]++;
+
+	SCandidate sCandidate;
+	if (TestPair(cSolidObjectA, cSolidObjectB, sCandidate.sContact) == false)
+		return false;
+
+	sCandidate.ullPairKey = GetPairKey(cSolidObjectA, cSolidObjectB);
+	sCandidate.uiGridOrder = uiGridOrder;
+	sCandidate.uiPairOrder = uiPairOrder;
+	vThreadCandidates[uiThreadIndex].push_back(sCandidate);
+	return true;
+}
+
+/**
+ @brief Merge the buffers of all the threads, then call the callbacks.
+		The candidates are sorted in the order which the serial path adds the pairs in,
+		and a pair which was found in several CGrids is only kept the first time,
+		so the contacts and the responses are the same as the serial path.
+ @return A bool variable which is true if the player had collided with another CSolidObject
+ */
+bool CNarrowphase::ResolveThreadBuffers(void)
+{
+	for (unsigned int i = 0; i < vThreadCandidates.size(); i++)
+	{
+		vMergedCandidates.insert(vMergedCandidates.end(), vThreadCandidates[i].begin(), vThreadCandidates[i].end());
+		iNumOfThreadPairs += vThreadNumOfPairs[i];
+	}
+
+	std::sort(vMergedCandidates.begin(), vMergedCandidates.end(), [](const SCandidate& a, const SCandidate& b)
+	{
+		if (a.uiGridOrder != b.uiGridOrder)
+			return (a.uiGridOrder < b.uiGridOrder);
+		return (a.uiPairOrder < b.uiPairOrder);
+	});
+
+	for (unsigned int i = 0; i < vMergedCandidates.size(); i++)
+	{
+		if (setPairKeys.insert(vMergedCandidates[i].ullPairKey).second == false)
+		{
+			iNumOfDuplicates++;
+			continue;
+		}
+		vContacts.push_back(vMergedCandidates[i].sContact);
+	}
+
+	return Respond();
+}
+
+/**
+ @brief Set the callback for a type of pair
+ @param ePairType A const PAIRTYPE variable containing the type of pair
+ @param cCollisionCallback A CollisionCallback variable containing the new callback. Set to nullptr to disable the response.
+ */
+void CNarrowphase::SetCallback(const PAIRTYPE ePairType, CollisionCallback cCollisionCallback)
+{
+	if (ePairType >= PAIRTYPE::NUM_PAIRTYPE)
+		return;
+
+	arrCallbacks[(unsigned int)ePairType] = cCollisionCallback;
+}
+
+/**
+ @brief Get the contacts found in this frame
+ @return A const std::vector<SContact>& variable containing the contacts
+ */
+const std::vector<CNarrowphase::SContact>& CNarrowphase::GetContacts(void) const
+{
+	return vContacts;
+}
+
+/**
+ @brief Get the number of unique pairs added in this frame.
+		In the parallel path, it is the number of pairs tested by the threads, which includes the pairs found in several CGrids.
+ @return An int variable containing the number of pairs
+ */
+int CNarrowphase::GetNumOfPairs(void) const
+{
+	return (int)vPairs.size() + iNumOfThreadPairs;
+}
+
+/**
+ @brief Get the number of duplicated pairs which were skipped in this frame
+ @return An int variable containing the number of duplicated pairs
+ */
+int CNarrowphase::GetNumOfDuplicates(void) const
+{
+	return iNumOfDuplicates;
+}
+
+/**
+ @brief Set the logging of contacts
+ @param bLogging A const bool variable which is true if contacts are to be printed to the console
+ */
+void CNarrowphase::SetLogging(const bool bLogging)
+{
+	this->bLogging = bLogging;
+}
+
+/**
+ @brief Get the logging of contacts
+ @return A bool variable which is true if contacts are printed to the console
+ */
+bool CNarrowphase::GetLogging(void) const
+{
+	return bLogging;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CNarrowphase::PrintSelf(void) const
+{
+	cout << "CNarrowphase::PrintSelf()" << endl;
+	cout << "\tNumber of pairs: " << GetNumOfPairs() << endl;
+	cout << "\tNumber of duplicated pairs: " << iNumOfDuplicates << endl;
+	cout << "\tNumber of contacts: " << vContacts.size() << endl;
+}
+
+/**
+ @brief Calculate a key which is the same regardless of the order of the 2 CSolidObjects
+ @param cSolidObjectA A CSolidObject* variable storing the first CSolidObject
+ @param cSolidObjectB A CSolidObject* variable storing the second CSolidObject
+ @return An unsigned long long variable containing the key
+ */
+unsigned long long CNarrowphase::GetPairKey(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB)
+{
+	unsigned long long ullIDA = (unsigned int)cSolidObjectA->GetID();
+	unsigned long long ullIDB = (unsigned int)cSolidObjectB->GetID();
+	return (ullIDA < ullIDB) ? ((ullIDA << 32) | ullIDB) : ((ullIDB << 32) | ullIDA);
+}
+
+/**
+ @brief Test a pair and fill in the contact if they collide. It does not change any CSolidObject,
+		so it can be called by several threads at the same time.
+ @param cSolidObjectA A CSolidObject* variable storing the first CSolidObject
+ @param cSolidObjectB A CSolidObject* variable storing the second CSolidObject
+ @param sContact A SContact& variable to store the contact
+ @return A bool variable which is true if the 2 CSolidObjects collide and have a collision response
+ */
+bool CNarrowphase::TestPair(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB, SContact& sContact) const
+{
+	// If either entity is not active, then skip this pair
+	if ((cSolidObjectA->GetStatus() == false) || (cSolidObjectB->GetStatus() == false))
+		return false;
+
+	// If this pair has no collision response, then skip it
+	PAIRTYPE ePairType;
+	if (GetPairType(cSolidObjectA, cSolidObjectB, ePairType) == false)
+		return false;
+
+	// Check for collisions between the 2 entities
+	if (CCollisionManager::BoxBoxCollision(
+			cSolidObjectA->GetPosition() + cSolidObjectA->boxMin,
+			cSolidObjectA->GetPosition() + cSolidObjectA->boxMax,
+			cSolidObjectB->GetPosition() + cSolidObjectB->boxMin,
+			cSolidObjectB->GetPosition() + cSolidObjectB->boxMax) == false)
+		return false;
+
+	sContact.cSolidObjectA = cSolidObjectA;
+	sContact.cSolidObjectB = cSolidObjectB;
+	sContact.ePairType = ePairType;
+	return true;
+}
+
+/**
+ @brief Call the callbacks for the contacts in vContacts, in order
+ @return A bool variable which is true if the player had collided with another CSolidObject
+ */
+bool CNarrowphase::Respond(void)
+{
+	// Boolean variable to check if the player has collided with another CSolidObject
+	bool bResult = false;
+
+	for (unsigned int i = 0; i < vContacts.size(); i++)
+	{
+		const SContact& sContact = vContacts[i];
+
+		if (sContact.cSolidObjectA->GetType() == CSolidObject::TYPE::PLAYER)
+			bResult = true;
+
+		if (bLogging)
+		{
+			if (sContact.ePairType == PAIRTYPE::PLAYER_NPC)
+				cout << "** Collision between Player and an Entity ***" << endl;
+			else if (sContact.ePairType == PAIRTYPE::NPC_NPC)
+				cout << "** Collision between 2 Entities ***" << endl;
+			else
+				cout << "** Collision between Entity and Structure ***" << endl;
+		}
+
+		// Call the callback for this type of pair
+		if (arrCallbacks[(unsigned int)sContact.ePairType])
+			arrCallbacks[(unsigned int)sContact.ePairType](sContact);
+	}
+
+	return bResult;
+}
+
+/**
+ @brief Get the type of a pair of CSolidObjects, and order them so that cSolidObjectA is the movable one
+ @param cSolidObjectA A CSolidObject*& variable storing the first CSolidObject
+ @param cSolidObjectB A CSolidObject*& variable storing the second CSolidObject
+ @param ePairType A PAIRTYPE& variable to store the type of pair
+ @return A bool variable which is true if this pair has a collision response
+ */
+bool CNarrowphase::GetPairType(CSolidObject*& cSolidObjectA, CSolidObject*& cSolidObjectB, PAIRTYPE& ePairType) const
+{
+	// Order the 2 CSolidObjects so that the player comes first and a structure comes last
+	if (((cSolidObjectB->GetType() == CSolidObject::TYPE::PLAYER) && (cSolidObjectA->GetType() != CSolidObject::TYPE::PLAYER)) ||
+		((cSolidObjectA->GetType() == CSolidObject::TYPE::STRUCTURE) && (cSolidObjectB->GetType() != CSolidObject::TYPE::STRUCTURE)))
+	{
+		CSolidObject* cTemp = cSolidObjectA;
+		cSolidObjectA = cSolidObjectB;
+		cSolidObjectB = cTemp;
+	}
+
+	const bool bIsAMovable = ((cSolidObjectA->GetType() >= CSolidObject::TYPE::PLAYER) &&
+								(cSolidObjectA->GetType() <= CSolidObject::TYPE::OTHERS));
+	const bool bIsBNPC = ((cSolidObjectB->GetType() >= CSolidObject::TYPE::NPC) &&
+							(cSolidObjectB->GetType() <= CSolidObject::TYPE::OTHERS));
+
+	// Check if a movable entity collides with another movable entity
+	if ((cSolidObjectA->GetType() == CSolidObject::TYPE::PLAYER) && (bIsBNPC))
+	{
+		ePairType = PAIRTYPE::PLAYER_NPC;
+		return true;
+	}
+	else if ((bIsAMovable) && (cSolidObjectA->GetType() != CSolidObject::TYPE::PLAYER) && (bIsBNPC))
+	{
+		ePairType = PAIRTYPE::NPC_NPC;
+		return true;
+	}
+	// Check if a movable entity collides with a non-movable entity
+	else if ((bIsAMovable) && (cSolidObjectB->GetType() == CSolidObject::TYPE::STRUCTURE))
+	{
+		ePairType = PAIRTYPE::ENTITY_STRUCTURE;
+		return true;
+	}
+
+	return false;
+}
+
+/**
+ @brief The default response when the player collides with a NPC
+ @param sContact A const SContact& variable containing the contact
+ */
+void CNarrowphase::PlayerNPCResponse(const SContact& sContact)
+{
+	sContact.cSolidObjectA->RollbackPosition();
+	sContact.cSolidObjectB->RollbackPosition();
+}
+
+/**
+ @brief The default response when 2 NPCs collide
+ @param sContact A const SContact& variable containing the contact
+ */
+void CNarrowphase::NPCNPCResponse(const SContact& sContact)
+{
+	sContact.cSolidObjectA->RollbackPosition();
+	sContact.cSolidObjectB->RollbackPosition();
+}
+
+/**
+ @brief The default response when a movable entity collides with a structure
+ @param sContact A const SContact& variable containing the contact
+ */
+void CNarrowphase::EntityStructureResponse(const SContact& sContact)
+{
+	sContact.cSolidObjectA->RollbackPosition();
+	if (sContact.cSolidObjectA->GetType() == CSolidObject::TYPE::PLAYER)
+	{
+		((CPlayer3D*)sContact.cSolidObjectA)->SetToIdle();
+	}
+}
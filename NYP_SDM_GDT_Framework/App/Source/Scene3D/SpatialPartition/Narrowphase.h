@@ -0,0 +1,137 @@
+/**
+ CNarrowphase
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include CSolidObject
+#include "../Entities/SolidObject.h"
+
+#include <vector>
+#include <unordered_set>
+#include <functional>
+using namespace std;
+
+class CNarrowphase
+{
+public:
+	// Defines the types of pairs of CSolidObjects which have a collision response
+	enum class PAIRTYPE : unsigned int
+	{
+		PLAYER_NPC = 0,
+		NPC_NPC,
+		ENTITY_STRUCTURE,
+		NUM_PAIRTYPE
+	};
+
+	// A contact between 2 colliding CSolidObjects.
+	// cSolidObjectA is the player or a movable entity, and cSolidObjectB is the other CSolidObject.
+	struct SContact
+	{
+		CSolidObject* cSolidObjectA;
+		CSolidObject* cSolidObjectB;
+		PAIRTYPE ePairType;
+	};
+
+	// The callback which responds to a contact
+	using CollisionCallback = std::function<void(const SContact&)>;
+
+	// Constructor
+	CNarrowphase(void);
+	// Destructor
+	virtual ~CNarrowphase(void);
+
+	// Clear the pairs and contacts from the previous frame
+	void Reset(void);
+
+	// Add a pair of CSolidObjects from the broadphase
+	bool AddPair(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB);
+
+	// Test the pairs, store the contacts and call the callbacks
+	bool Resolve(void);
+
+	// Prepare one buffer of candidate contacts for each thread, for the parallel path
+	void PrepareThreadBuffers(const unsigned int uiNumOfThreads);
+	// Test a pair on a worker thread, and store the contact in the buffer of that thread
+	bool TestPairInThread(	CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB,
+							const unsigned int uiThreadIndex,
+							const unsigned int uiGridOrder, const unsigned int uiPairOrder);
+	// Merge the buffers of all the threads in the serial order, then call the callbacks
+	bool ResolveThreadBuffers(void);
+
+	// Set the callback for a type of pair
+	void SetCallback(const PAIRTYPE ePairType, CollisionCallback cCollisionCallback);
+
+	// Get the contacts found in this frame
+	const std::vector<SContact>& GetContacts(void) const;
+	// Get the number of unique pairs added in this frame, or the number of pairs tested by the threads
+	int GetNumOfPairs(void) const;
+	// Get the number of duplicated pairs which were skipped in this frame
+	int GetNumOfDuplicates(void) const;
+
+	// Set the logging of contacts
+	void SetLogging(const bool bLogging);
+	// Get the logging of contacts
+	bool GetLogging(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// A pair of CSolidObjects from the broadphase
+	struct SPair
+	{
+		CSolidObject* cSolidObjectA;
+		CSolidObject* cSolidObjectB;
+	};
+
+	// A contact found by a thread, with the order which the serial path would have added its pair in
+	struct SCandidate
+	{
+		SContact sContact;
+		unsigned long long ullPairKey;
+		unsigned int uiGridOrder;
+		unsigned int uiPairOrder;
+	};
+
+	// Calculate a key which is the same regardless of the order of the 2 CSolidObjects
+	static unsigned long long GetPairKey(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB);
+	// Test a pair and fill in the contact if they collide. It does not change any CSolidObject.
+	bool TestPair(CSolidObject* cSolidObjectA, CSolidObject* cSolidObjectB, SContact& sContact) const;
+	// Call the callbacks for the contacts in vContacts, in order
+	bool Respond(void);
+
+	// Get the type of a pair of CSolidObjects, and order them so that cSolidObjectA is the movable one
+	bool GetPairType(CSolidObject*& cSolidObjectA, CSolidObject*& cSolidObjectB, PAIRTYPE& ePairType) const;
+
+	// The default responses for each type of pair
+	static void PlayerNPCResponse(const SContact& sContact);
+	static void NPCNPCResponse(const SContact& sContact);
+	static void EntityStructureResponse(const SContact& sContact);
+
+	// The set of pair keys, used to skip pairs which were already added
+	std::unordered_set<unsigned long long> setPairKeys;
+	// The unique pairs in the order which they were added
+	std::vector<SPair> vPairs;
+	// The contacts found in this frame
+	std::vector<SContact> vContacts;
+	// The candidate contacts found by each thread in the parallel path
+	std::vector<std::vector<SCandidate>> vThreadCandidates;
+	// The number of pairs tested by each thread in the parallel path
+	std::vector<int> vThreadNumOfPairs;
+	// The candidate contacts of all the threads, sorted in the serial order
+	std::vector<SCandidate> vMergedCandidates;
+	// The number of pairs tested by the threads in this frame
+	int iNumOfThreadPairs;
+	// The callback for each type of pair
+	CollisionCallback arrCallbacks[(unsigned int)PAIRTYPE::NUM_PAIRTYPE];
+
+	// The number of duplicated pairs which were skipped in this frame
+	int iNumOfDuplicates;
+	// Boolean flag to indicate if contacts are printed to the console
+	bool bLogging;
+};
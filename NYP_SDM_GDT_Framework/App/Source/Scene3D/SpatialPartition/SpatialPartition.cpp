@@ -7,11 +7,19 @@
 #include "../Terrain/TerrainManager.h"
 // Include Player3D
 #include "../Entities/Player3D.h"
+// Include CCameraEffectsManager
+#include "../CameraEffects/CameraEffectsManager.h"
+
+// Include CJobSystem
+#include "../../JobSystem/JobSystem.h"
 
 // Include this for glm::to_string() function
 #define GLM_ENABLE_EXPERIMENTAL
 #include <includes/gtx/string_cast.hpp>
 
+#include <cfloat>
+#include <cmath>
+
 #include <iostream>
 using namespace std;
 
@@ -29,6 +37,10 @@ CSpatialPartition::CSpatialPartition(void)
 	, fPreviousLineWidth(0.0f)
 	, cFrustumCulling(NULL)
 	, frustumCullingView(glm::mat4(1.0f))
+	, eBroadphase(BROADPHASE::GRID)
+	, cSweepAndPrune(NULL)
+	, cNarrowphase(NULL)
+	, bParallelNarrowphase(true)
 {
 }
 
@@ -51,6 +63,18 @@ void CSpatialPartition::Destroy()
 		cFrustumCulling = NULL;
 	}
 
+	if (cSweepAndPrune)
+	{
+		delete cSweepAndPrune;
+		cSweepAndPrune = NULL;
+	}
+
+	if (cNarrowphase)
+	{
+		delete cNarrowphase;
+		cNarrowphase = NULL;
+	}
+
 	// Destroy all the CGrids
 	for (int iRow = 0; iRow < i32vec3NumGrid.x; iRow++)
 	{
@@ -154,6 +178,9 @@ bool CSpatialPartition::Init(glm::vec3 vec3SpatialPartitionSize, glm::i32vec3 i3
 	cFrustumCulling->SetProjection(projection);
 	cFrustumCulling->Init();
 
+	cSweepAndPrune = new CSweepAndPrune();
+	cNarrowphase = new CNarrowphase();
+
 	return false;
 }
 
@@ -169,35 +196,46 @@ bool CSpatialPartition::Update(const double dElapsedTime)
 	cFrustumCulling->SetProjection(CPlayer3D::GetInstance()->GetPerspectiveMatrix());
 	cFrustumCulling->Update(dElapsedTime);
 
-	// Determine the visibility of all the CGrids
-	for (int iRow = 0; iRow < i32vec3NumGrid.x; iRow++)
+	// Determine the visibility and the LOD of all the CGrids on the worker threads.
+	// Each job only writes to the CGrids in its own rows, and to their flags in vVisibleGrids.
+	const glm::vec3 vec3ViewPosition = glm::vec3(frustumCullingView[3]);
+	vVisibleGrids.assign(i32vec3NumGrid.x * i32vec3NumGrid.z, 0);
+	CJobSystem::GetInstance()->ParallelFor((unsigned int)i32vec3NumGrid.x, 1,
+		[this, vec3ViewPosition](const unsigned int uiBegin, const unsigned int uiEnd)
 	{
-		for (int iCol = 0; iCol < i32vec3NumGrid.z; iCol++)
+		for (int iRow = (int)uiBegin; iRow < (int)uiEnd; iRow++)
 		{
-			glm::vec3 vec3BottomRight = glm::vec3(vGrids[iRow][iCol]->vec3TopRight.x, vGrids[iRow][iCol]->vec3BottomLeft.y, vGrids[iRow][iCol]->vec3BottomLeft.z);
-			glm::vec3 vec3TopLeft = glm::vec3(vGrids[iRow][iCol]->vec3BottomLeft.x, vGrids[iRow][iCol]->vec3TopRight.y, vGrids[iRow][iCol]->vec3TopRight.z);
-				 
-			//	vGrids[iRow][iCol]->vec3TopRight) == true)
-			if ((cFrustumCulling->IsPointWithin(vGrids[iRow][iCol]->vec3BottomLeft) == true) ||
-				(cFrustumCulling->IsPointWithin(vGrids[iRow][iCol]->vec3TopRight) == true) ||
-				(cFrustumCulling->IsPointWithin(vec3BottomRight) == true) ||
-				(cFrustumCulling->IsPointWithin(vec3TopLeft) == true))
+			for (int iCol = 0; iCol < i32vec3NumGrid.z; iCol++)
 			{
-				// Set the grid to visible
-				vGrids[iRow][iCol]->SetVisiblity(true);
+				glm::vec3 vec3BottomRight = glm::vec3(vGrids[iRow][iCol]->vec3TopRight.x, vGrids[iRow][iCol]->vec3BottomLeft.y, vGrids[iRow][iCol]->vec3BottomLeft.z);
+				glm::vec3 vec3TopLeft = glm::vec3(vGrids[iRow][iCol]->vec3BottomLeft.x, vGrids[iRow][iCol]->vec3TopRight.y, vGrids[iRow][iCol]->vec3TopRight.z);
+
+				if ((cFrustumCulling->IsPointWithin(vGrids[iRow][iCol]->vec3BottomLeft) == true) ||
+					(cFrustumCulling->IsPointWithin(vGrids[iRow][iCol]->vec3TopRight) == true) ||
+					(cFrustumCulling->IsPointWithin(vec3BottomRight) == true) ||
+					(cFrustumCulling->IsPointWithin(vec3TopLeft) == true))
+				{
+					// Flag the grid as visible
+					vVisibleGrids[iRow * i32vec3NumGrid.z + iCol] = 1;
+
+					// Check the distance of the grid to the player and determine the LOD
+					float fDistance = glm::distance(vec3ViewPosition, vGrids[iRow][iCol]->GetPosition());
+					vGrids[iRow][iCol]->UpdateLOD(fDistance);
+				}
+			}
+		}
+	});
 
-				// Check the distance of the grid to the player and determine the LOD
-				float fDistance = glm::distance(glm::vec3(frustumCullingView[3]), vGrids[iRow][iCol]->GetPosition());
-				vGrids[iRow][iCol]->UpdateLOD(fDistance);
+	// Set the visibility of the CGrids and assign their LOD to their CSolidObjects on this thread,
+	// since a CSolidObject can be in more than one CGrid
+	for (int iRow = 0; iRow < i32vec3NumGrid.x; iRow++)
+	{
+		for (int iCol = 0; iCol < i32vec3NumGrid.z; iCol++)
+		{
+			vGrids[iRow][iCol]->SetVisiblity(vVisibleGrids[iRow * i32vec3NumGrid.z + iCol] == 1);
 
-				// Update this grid
-				vGrids[iRow][iCol]->Update(dElapsedTime);
-			}
-			else
-			{
-				// Set the grid to not visible
-				vGrids[iRow][iCol]->SetVisiblity(false);
-			}
+			// Update this grid. It does nothing if this grid is not visible.
+			vGrids[iRow][iCol]->Update(dElapsedTime);
 		}
 	}
 
@@ -215,6 +253,9 @@ bool CSpatialPartition::Update(const double dElapsedTime)
 	if (tempGrid)
 		tempGrid->SetVisiblity(true);
 
+	// Check for collisions between the CSolidObjects which are found by the broadphase
+	CheckForCollision();
+
 	return true;
 }
 
@@ -315,6 +356,163 @@ CGrid* CSpatialPartition::GetGrid(glm::vec3 vecPosition) const
 	return NULL;
 }
 
+/**
+@brief Get the grids which a line segment passes through, in the order from the start to the end.
+		This walks the grids with a digital differential analyzer (DDA), so only the grids crossed are visited.
+		The spatial partition has 1 layer of grids in the y-axis, so the walk is done in the X- and Z-axes.
+@param vec3Start A const glm::vec3& variable containing the start of the line segment
+@param vec3End A const glm::vec3& variable containing the end of the line segment
+@param vGridsAlongSegment A std::vector<CGrid*>& variable to store the grids in
+@return An int variable containing the number of grids found
+*/
+int CSpatialPartition::GetGridsAlongSegment(const glm::vec3& vec3Start, const glm::vec3& vec3End, std::vector<CGrid*>& vGridsAlongSegment) const
+{
+	vGridsAlongSegment.clear();
+
+	// Convert the line segment into grid coordinates
+	const float fStartX = (vec3Start.x - vec3BottomLeft.x) / vec3GridSize.x;
+	const float fStartZ = (vec3Start.z - vec3BottomLeft.z) / vec3GridSize.z;
+	const float fEndX = (vec3End.x - vec3BottomLeft.x) / vec3GridSize.x;
+	const float fEndZ = (vec3End.z - vec3BottomLeft.z) / vec3GridSize.z;
+
+	int iRow = (int)floor(fStartX);
+	int iCol = (int)floor(fStartZ);
+	const int iEndRow = (int)floor(fEndX);
+	const int iEndCol = (int)floor(fEndZ);
+
+	// The direction to step through the grids
+	const int iStepRow = (fEndX > fStartX) ? 1 : -1;
+	const int iStepCol = (fEndZ > fStartZ) ? 1 : -1;
+
+	// The distance along the segment, in the range of [0, 1], to cross 1 grid in each axis
+	const float fDeltaX = fabs(fEndX - fStartX);
+	const float fDeltaZ = fabs(fEndZ - fStartZ);
+	const float fTDeltaX = (fDeltaX > 0.0f) ? (1.0f / fDeltaX) : FLT_MAX;
+	const float fTDeltaZ = (fDeltaZ > 0.0f) ? (1.0f / fDeltaZ) : FLT_MAX;
+
+	// The distance along the segment to the first grid boundary in each axis
+	float fTMaxX = FLT_MAX;
+	if (fDeltaX > 0.0f)
+		fTMaxX = ((iStepRow > 0) ? ((float)(iRow + 1) - fStartX) : (fStartX - (float)iRow)) * fTDeltaX;
+	float fTMaxZ = FLT_MAX;
+	if (fDeltaZ > 0.0f)
+		fTMaxZ = ((iStepCol > 0) ? ((float)(iCol + 1) - fStartZ) : (fStartZ - (float)iCol)) * fTDeltaZ;
+
+	// Walk through the grids until the grid with the end of the segment is reached
+	int iNumOfSteps = abs(iEndRow - iRow) + abs(iEndCol - iCol);
+	for (int i = 0; i <= iNumOfSteps; i++)
+	{
+		if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
+			vGridsAlongSegment.push_back(vGrids[iRow][iCol]);
+
+		if (fTMaxX < fTMaxZ)
+		{
+			fTMaxX += fTDeltaX;
+			iRow += iStepRow;
+		}
+		else
+		{
+			fTMaxZ += fTDeltaZ;
+			iCol += iStepCol;
+		}
+	}
+
+	// Ensure that the grid with the end of the segment is included despite any rounding errors
+	CGrid* cEndGrid = GetGrid(iEndRow, iEndCol);
+	if ((cEndGrid) && ((vGridsAlongSegment.size() == 0) || (vGridsAlongSegment.back() != cEndGrid)))
+		vGridsAlongSegment.push_back(cEndGrid);
+
+	return (int)vGridsAlongSegment.size();
+}
+
+/**
+@brief Cast a ray downwards and get the nearest CSolidObject below a position.
+		Every CSolidObject is added to all the grids which it overlaps in the X- and Z-axes,
+		so only the CSolidObjects in the grid containing the position need to be tested.
+		It only uses local variables, so it can be called from the worker threads of the CJobSystem.
+@param vec3Origin A const glm::vec3& variable containing the origin of the ray
+@param fMaxDistance A const float variable containing the maximum distance to test up to
+@param t A float& variable to store the distance to the top of the nearest CSolidObject
+@param cIgnore A CSolidObject* variable storing a CSolidObject to skip, such as the caller itself
+@param cSupport A CSolidObject** variable to store the nearest CSolidObject. It is optional.
+@return A bool variable which is true if a CSolidObject was found below the position
+*/
+bool CSpatialPartition::RaycastDown(const glm::vec3& vec3Origin,
+									const float fMaxDistance,
+									float& t,
+									CSolidObject* cIgnore,
+									CSolidObject** cSupport)
+{
+	t = FLT_MAX;
+	if (cSupport)
+		*cSupport = NULL;
+
+	CGrid* cGrid = GetGrid(vec3Origin);
+	if (cGrid == NULL)
+		return false;
+
+	// Collect the active CSolidObjects in this grid
+	std::vector<CSolidObject*> vRaycastSolidObjects;
+	CCollisionBatch::SBoxBatch sRaycastBoxBatch;
+	vRaycastSolidObjects.reserve(cGrid->SolidObjectMap.size());
+	sRaycastBoxBatch.Reserve((unsigned int)cGrid->SolidObjectMap.size());
+	std::map<unsigned int, CSolidObject*>::iterator it, end;
+	end = cGrid->SolidObjectMap.end();
+	for (it = cGrid->SolidObjectMap.begin(); it != end; ++it)
+	{
+		if ((it->second == cIgnore) || (it->second->GetStatus() == false))
+			continue;
+
+		vRaycastSolidObjects.push_back(it->second);
+		sRaycastBoxBatch.Add(	it->second->GetPosition() + it->second->boxMin,
+								it->second->GetPosition() + it->second->boxMax);
+	}
+
+	// Find the nearest CSolidObject below the position
+	int iNearest = CCollisionBatch::RayBoxBatchNearest(	vec3Origin,
+														glm::vec3(0.0f, -1.0f, 0.0f),
+														fMaxDistance,
+														sRaycastBoxBatch,
+														t);
+	if (iNearest < 0)
+		return false;
+
+	if (cSupport)
+		*cSupport = vRaycastSolidObjects[iNearest];
+	return true;
+}
+
+/**
+@brief Update the heights of the CGrids in an area after the terrain was changed
+@param vec3Min A const glm::vec3& variable containing the minimum x- and z-coordinates of the area
+@param vec3Max A const glm::vec3& variable containing the maximum x- and z-coordinates of the area
+*/
+void CSpatialPartition::UpdateGridHeights(const glm::vec3& vec3Min, const glm::vec3& vec3Max)
+{
+	if (vGrids.empty())
+		return;
+
+	// Find the rows and columns of the CGrids which overlap the area
+	const int iFirstRow = (int)glm::clamp((vec3Min.x - vec3BottomLeft.x) / vec3GridSize.x, 0.0f, (float)(i32vec3NumGrid.x - 1));
+	const int iLastRow = (int)glm::clamp((vec3Max.x - vec3BottomLeft.x) / vec3GridSize.x, 0.0f, (float)(i32vec3NumGrid.x - 1));
+	const int iFirstCol = (int)glm::clamp((vec3Min.z - vec3BottomLeft.z) / vec3GridSize.z, 0.0f, (float)(i32vec3NumGrid.z - 1));
+	const int iLastCol = (int)glm::clamp((vec3Max.z - vec3BottomLeft.z) / vec3GridSize.z, 0.0f, (float)(i32vec3NumGrid.z - 1));
+
+	CTerrainManager* cTerrainManager = CTerrainManager::GetInstance();
+	for (int iRow = iFirstRow; iRow <= iLastRow; iRow++)
+	{
+		for (int iCol = iFirstCol; iCol <= iLastCol; iCol++)
+		{
+			// Read the heights at the corners in the same way as Init
+			CGrid* cGrid = vGrids[iRow][iCol];
+			cGrid->SetHeights(cTerrainManager->GetHeight(cGrid->vec3BottomLeft.x, cGrid->vec3BottomLeft.z),
+							  cTerrainManager->GetHeight(cGrid->vec3TopRight.x, cGrid->vec3TopRight.z),
+							  cTerrainManager->GetHeight(cGrid->vec3BottomLeft.x, cGrid->vec3TopRight.z),
+							  cTerrainManager->GetHeight(cGrid->vec3TopRight.x, cGrid->vec3BottomLeft.z));
+		}
+	}
+}
+
 /**
 @brief Reset the list of CSolidObjects in the Spatial Partition
 @param cSolidObjectManager A CSolidObjectManager* handler containing all CSolidObjects in the scene
@@ -344,6 +542,10 @@ void CSpatialPartition::Reset(CSolidObjectManager* cSolidObjectManager)
 		this->Add(*it);
 	}
 
+	// Add and remove the CSolidObjects in the CSweepAndPrune. 
+	// Unlike the CGrids, the CSweepAndPrune is not cleared every frame.
+	if ((eBroadphase == BROADPHASE::SWEEPANDPRUNE) && (cSweepAndPrune))
+		cSweepAndPrune->Synchronise(cSolidObjectManager->lSolidObject);
 }
 
 /**
@@ -352,45 +554,19 @@ void CSpatialPartition::Reset(CSolidObjectManager* cSolidObjectManager)
 */
 void CSpatialPartition::Add(CSolidObject* cSolidObject)
 {
-		// Get the indices of the object's boxMin position
-		int iRow = (int)((cSolidObject->GetPosition().x - cSolidObject->boxMin.x + (vec3SpatialPartitionSize.x * 0.5f)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-		int iCol = (int)((cSolidObject->GetPosition().z - cSolidObject->boxMin.z + (vec3SpatialPartitionSize.z * 0.5f)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
-		// Add this position into each grid
-		if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
-		{
-			//cout << "Add to [" << iRow << "][" << iCol << "]" << endl;
-			vGrids[iRow][iCol]->Add(cSolidObject);
-		}
+	int iMinRow, iMinCol, iMaxRow, iMaxCol;
+	GetGridRange(cSolidObject, iMinRow, iMinCol, iMaxRow, iMaxCol);
 
-		// Get the indices of the object's boxMin position
-		iRow = (int)((cSolidObject->GetPosition().x + cSolidObject->boxMax.x + (vec3SpatialPartitionSize.x * 0.5f)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-		iCol = (int)((cSolidObject->GetPosition().z + cSolidObject->boxMin.z + (vec3SpatialPartitionSize.z * 0.5f)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
-		// Add this position into each grid
-		if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
-		{
-			//cout << "Add to [" << iRow << "][" << iCol << "]" << endl;
-			vGrids[iRow][iCol]->Add(cSolidObject);
-		}
-
-		// Get the indices of the object's boxMin position
-		iRow = (int)((cSolidObject->GetPosition().x - cSolidObject->boxMin.x + (vec3SpatialPartitionSize.x * 0.5f)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-		iCol = (int)((cSolidObject->GetPosition().z + cSolidObject->boxMax.z + (vec3SpatialPartitionSize.z * 0.5f)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
-		// Add this position into each grid
-		if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
-		{
-			//cout << "Add to [" << iRow << "][" << iCol << "]" << endl;
-			vGrids[iRow][iCol]->Add(cSolidObject);
-		}
-
-		// Get the indices of the object's boxMin position
-		iRow = (int)((cSolidObject->GetPosition().x + cSolidObject->boxMax.x + (vec3SpatialPartitionSize.x * 0.5f)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-		iCol = (int)((cSolidObject->GetPosition().z + cSolidObject->boxMax.z + (vec3SpatialPartitionSize.z * 0.5f)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
-		// Add this position into each grid
-		if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
+	// Add this object into each grid which its bounding box overlaps,
+	// so that a query in any of these grids will find it
+	for (int iRow = iMinRow; iRow <= iMaxRow; iRow++)
+	{
+		for (int iCol = iMinCol; iCol <= iMaxCol; iCol++)
 		{
 			//cout << "Add to [" << iRow << "][" << iCol << "]" << endl;
 			vGrids[iRow][iCol]->Add(cSolidObject);
 		}
+	}
 }
 
 /**
@@ -399,19 +575,43 @@ void CSpatialPartition::Add(CSolidObject* cSolidObject)
 */
 void CSpatialPartition::Remove(CSolidObject* cSolidObject)
 {
-	// Get the indices of the object's position
-	//int iRow = (((int)cSolidObject->localTransform[3][0] - (-((int)vec3SpatialPartitionSize.x) >> 1)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-	//int iCol = (((int)cSolidObject->localTransform[3][2] - (-((int)vec3SpatialPartitionSize.z) >> 1)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
-	int iRow = int(((int)cSolidObject->GetPosition().x - (-((int)vec3SpatialPartitionSize.x) >> 1)) / (vec3SpatialPartitionSize.x / i32vec3NumGrid.x));
-	int iCol = int(((int)cSolidObject->GetPosition().z - (-((int)vec3SpatialPartitionSize.z) >> 1)) / (vec3SpatialPartitionSize.z / i32vec3NumGrid.z));
+	int iMinRow, iMinCol, iMaxRow, iMaxCol;
+	GetGridRange(cSolidObject, iMinRow, iMinCol, iMaxRow, iMaxCol);
 
-	// Remove from the grid
-	if (((iRow >= 0) && (iRow < i32vec3NumGrid.x)) && ((iCol >= 0) && (iCol < i32vec3NumGrid.z)))
+	// Remove this object from each grid which Add put it into
+	for (int iRow = iMinRow; iRow <= iMaxRow; iRow++)
 	{
-		vGrids[iRow][iCol]->Remove(cSolidObject);
+		for (int iCol = iMinCol; iCol <= iMaxCol; iCol++)
+		{
+			vGrids[iRow][iCol]->Remove(cSolidObject);
+		}
 	}
 }
 
+/**
+@brief Get the rows and columns of the CGrids which the bounding box of a CSolidObject overlaps.
+		They are clamped to the spatial partition, so an object outside of it uses the nearest CGrids.
+@param cSolidObject A CSolidObject* variable storing the handler of the Scene Node
+@param iMinRow An int& variable which the first row is returned in
+@param iMinCol An int& variable which the first column is returned in
+@param iMaxRow An int& variable which the last row is returned in
+@param iMaxCol An int& variable which the last column is returned in
+*/
+void CSpatialPartition::GetGridRange(CSolidObject* cSolidObject, int& iMinRow, int& iMinCol, int& iMaxRow, int& iMaxCol) const
+{
+	// Get the indices of the grids at the object's boxMin and boxMax positions
+	iMinRow = (int)floor((cSolidObject->GetPosition().x + cSolidObject->boxMin.x - vec3BottomLeft.x) / vec3GridSize.x);
+	iMinCol = (int)floor((cSolidObject->GetPosition().z + cSolidObject->boxMin.z - vec3BottomLeft.z) / vec3GridSize.z);
+	iMaxRow = (int)floor((cSolidObject->GetPosition().x + cSolidObject->boxMax.x - vec3BottomLeft.x) / vec3GridSize.x);
+	iMaxCol = (int)floor((cSolidObject->GetPosition().z + cSolidObject->boxMax.z - vec3BottomLeft.z) / vec3GridSize.z);
+
+	// Clamp the indices to the spatial partition
+	iMinRow = glm::max(iMinRow, 0);
+	iMinCol = glm::max(iMinCol, 0);
+	iMaxRow = glm::min(iMaxRow, i32vec3NumGrid.x - 1);
+	iMaxCol = glm::min(iMaxCol, i32vec3NumGrid.z - 1);
+}
+
 /**
 @brief Collision Check for an entity against Spatial Partition's entities
 */
@@ -452,6 +652,172 @@ bool CSpatialPartition::CheckForCollisionWithEntity(CEntity3D* cEntity3D)
 	return bResult;
 }
 
+/**
+@brief Set the broadphase
+@param eBroadphase A const BROADPHASE variable storing the new broadphase
+*/
+void CSpatialPartition::SetBroadphase(const BROADPHASE eBroadphase)
+{
+	if ((eBroadphase < BROADPHASE::GRID) || (eBroadphase >= BROADPHASE::NUM_BROADPHASE))
+		return;
+
+	this->eBroadphase = eBroadphase;
+
+	// Clear the CSweepAndPrune when it is not used, so that it does not keep deleted CSolidObjects
+	if ((eBroadphase != BROADPHASE::SWEEPANDPRUNE) && (cSweepAndPrune))
+		cSweepAndPrune->Reset();
+}
+
+/**
+@brief Get the broadphase
+@return A BROADPHASE variable containing the current broadphase
+*/
+CSpatialPartition::BROADPHASE CSpatialPartition::GetBroadphase(void) const
+{
+	return eBroadphase;
+}
+
+/**
+@brief Set if the CGrids are tested for collisions on the worker threads
+@param bParallelNarrowphase A const bool variable which is true if the CGrids are tested on the worker threads
+*/
+void CSpatialPartition::SetParallelNarrowphase(const bool bParallelNarrowphase)
+{
+	this->bParallelNarrowphase = bParallelNarrowphase;
+}
+
+/**
+@brief Get if the CGrids are tested for collisions on the worker threads
+@return A bool variable which is true if the CGrids are tested on the worker threads
+*/
+bool CSpatialPartition::GetParallelNarrowphase(void) const
+{
+	return bParallelNarrowphase;
+}
+
+/**
+@brief Get the CNarrowphase, to set its callbacks or to get its contacts
+@return A CNarrowphase* variable containing the handler to the CNarrowphase
+*/
+CNarrowphase* CSpatialPartition::GetNarrowphase(void) const
+{
+	return cNarrowphase;
+}
+
+/**
+@brief Get the bottom left corner of the spatial partition
+@return A glm::vec3 variable
+*/
+glm::vec3 CSpatialPartition::GetBottomLeft(void) const
+{
+	return vec3BottomLeft;
+}
+
+/**
+@brief Get the size of each grid
+@return A glm::vec3 variable
+*/
+glm::vec3 CSpatialPartition::GetGridSize(void) const
+{
+	return vec3GridSize;
+}
+
+/**
+@brief Get the number of the grids in X-, Z-axes
+@return A glm::i32vec3 variable
+*/
+glm::i32vec3 CSpatialPartition::GetNumOfGrids(void) const
+{
+	return i32vec3NumGrid;
+}
+
+/**
+@brief Check for collisions between the pairs of CSolidObjects found by the broadphase.
+		Each unique pair only has one response, even if it was found in several CGrids.
+		In the parallel path, each visible CGrid is tested on a worker thread, and the responses
+		are applied afterwards on this thread in the same order as the serial path.
+@return A bool variable which is true if the player had collided with another CSolidObject
+*/
+bool CSpatialPartition::CheckForCollision(void)
+{
+	if (cNarrowphase == NULL)
+		return false;
+
+	cNarrowphase->Reset();
+
+	// Boolean flag to indicate if the pairs were tested on the worker threads
+	bool bTestedInThreads = false;
+
+	if ((eBroadphase == BROADPHASE::SWEEPANDPRUNE) && (cSweepAndPrune))
+	{
+		// Update the sorted axes. Only the pairs which had moved across each other are tested.
+		cSweepAndPrune->Update();
+
+		// Add the pairs which are overlapping in the CSweepAndPrune
+		cSweepAndPrune->GetOverlappingPairs(vOverlappingPairs);
+		for (unsigned int i = 0; i < vOverlappingPairs.size(); i++)
+		{
+			cNarrowphase->AddPair(vOverlappingPairs[i].cSolidObjectA, vOverlappingPairs[i].cSolidObjectB);
+		}
+	}
+	else if (bParallelNarrowphase == true)
+	{
+		// Get the visible CGrids in the same order as the serial path
+		vCollisionGrids.clear();
+		for (int iRow = 0; iRow < i32vec3NumGrid.x; iRow++)
+		{
+			for (int iCol = 0; iCol < i32vec3NumGrid.z; iCol++)
+			{
+				if (vGrids[iRow][iCol]->GetVisibility() == true)
+					vCollisionGrids.push_back(vGrids[iRow][iCol]);
+			}
+		}
+
+		// Test the pairs in each visible CGrid on the worker threads.
+		// The contacts are stored in a buffer for each thread, and nothing is changed until they are merged.
+		CJobSystem* cJobSystem = CJobSystem::GetInstance();
+		cNarrowphase->PrepareThreadBuffers(cJobSystem->GetNumOfThreads());
+		cJobSystem->ParallelFor((unsigned int)vCollisionGrids.size(), 1,
+			[this, cJobSystem](const unsigned int uiBegin, const unsigned int uiEnd)
+		{
+			const unsigned int uiThreadIndex = cJobSystem->GetThreadIndex();
+			for (unsigned int i = uiBegin; i < uiEnd; i++)
+			{
+				vCollisionGrids[i]->TestPairs(cNarrowphase, i, uiThreadIndex);
+			}
+		});
+		bTestedInThreads = true;
+	}
+	else
+	{
+		// Add the pairs in the visible CGrids
+		for (int iRow = 0; iRow < i32vec3NumGrid.x; iRow++)
+		{
+			for (int iCol = 0; iCol < i32vec3NumGrid.z; iCol++)
+			{
+				if (vGrids[iRow][iCol]->GetVisibility() == true)
+					vGrids[iRow][iCol]->CollectPairs(cNarrowphase);
+			}
+		}
+	}
+
+	// Test the unique pairs and respond to the contacts.
+	// In the parallel path, the pairs were already tested, so the contacts are merged and responded to.
+	bool bResult;
+	if (bTestedInThreads == true)
+		bResult = cNarrowphase->ResolveThreadBuffers();
+	else
+		bResult = cNarrowphase->Resolve();
+
+	// If the player had collided with another CSolidObject, then set the bloodscreen to true
+	if (bResult == true)
+	{
+		CCameraEffectsManager::GetInstance()->Get("BloodScreen")->SetStatus(true);
+	}
+
+	return bResult;
+}
+
 /**
 @brief PrintSelf
 */
@@ -474,6 +840,10 @@ void CSpatialPartition::PrintSelf(void) const
 		cout << endl;
 	}
 
+	if (eBroadphase == BROADPHASE::SWEEPANDPRUNE)
+		cSweepAndPrune->PrintSelf();
+	cNarrowphase->PrintSelf();
+
 	cout << "Printing out the frustum view" << endl;
 	cFrustumCulling->PrintSelf();
 
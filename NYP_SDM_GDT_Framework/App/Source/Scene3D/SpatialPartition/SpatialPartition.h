@@ -16,6 +16,13 @@
 
 #include "FrustumCulling.h"
 
+// Include CSweepAndPrune
+#include "SweepAndPrune.h"
+// Include CNarrowphase
+#include "Narrowphase.h"
+// Include CCollisionBatch
+#include "CollisionBatch.h"
+
 //#include "../Player3D.h"
 #include "../Entities/SolidObjectManager.h"
 
@@ -24,6 +31,16 @@ class CSpatialPartition : public CSingletonTemplate<CSpatialPartition>, public C
 {
 	friend class CSingletonTemplate<CSpatialPartition>;
 public:
+	// Defines the broadphases used to find pairs of colliding CSolidObjects.
+	// GRID tests every pair of CSolidObjects within each visible CGrid.
+	// SWEEPANDPRUNE keeps sorted axes of all CSolidObjects and tracks their overlaps.
+	enum class BROADPHASE : unsigned int
+	{
+		GRID = 0,
+		SWEEPANDPRUNE,
+		NUM_BROADPHASE
+	};
+
 	// Destroy the Singleton instance
 	void Destroy();
 
@@ -44,6 +61,17 @@ public:
 	CGrid* GetGrid(const int iRow, const int iCol) const;
 	// Get a particular grid using a position
 	CGrid* GetGrid(glm::vec3 vecPosition) const;
+	// Get the grids which a line segment passes through, in the order from the start to the end
+	int GetGridsAlongSegment(const glm::vec3& vec3Start, const glm::vec3& vec3End, std::vector<CGrid*>& vGridsAlongSegment) const;
+	// Cast a ray downwards and get the nearest CSolidObject below a position
+	bool RaycastDown(	const glm::vec3& vec3Origin,
+						const float fMaxDistance,
+						float& t,
+						CSolidObject* cIgnore = NULL,
+						CSolidObject** cSupport = NULL);
+
+	// Update the heights of the CGrids in an area after the terrain was changed
+	void UpdateGridHeights(const glm::vec3& vec3Min, const glm::vec3& vec3Max);
 
 	// Reset the list of CSolidObjects in the Spatial Partition
 	void Reset(CSolidObjectManager* cSolidObjectManager);
@@ -56,6 +84,26 @@ public:
 	// Collision Check for an entity against Spatial Partition's entities
 	virtual bool CheckForCollisionWithEntity(CEntity3D* cEntity3D);
 
+	// Set the broadphase
+	void SetBroadphase(const BROADPHASE eBroadphase);
+	// Get the broadphase
+	BROADPHASE GetBroadphase(void) const;
+
+	// Set if the CGrids are tested for collisions on the worker threads
+	void SetParallelNarrowphase(const bool bParallelNarrowphase);
+	// Get if the CGrids are tested for collisions on the worker threads
+	bool GetParallelNarrowphase(void) const;
+
+	// Get the CNarrowphase, to set its callbacks or to get its contacts
+	CNarrowphase* GetNarrowphase(void) const;
+
+	// Get the bottom left corner of the spatial partition
+	glm::vec3 GetBottomLeft(void) const;
+	// Get the size of each grid
+	glm::vec3 GetGridSize(void) const;
+	// Get the number of the grids in X-, Z-axes
+	glm::i32vec3 GetNumOfGrids(void) const;
+
 	//PrintSelf
 	void PrintSelf() const;
 
@@ -93,5 +141,25 @@ protected:
 	// This view is for calculating frustum culling 
 	// as we may detach the camera from the player.
 	glm::mat4 frustumCullingView;
+	// The visibility flag of each CGrid, which is set by the jobs in Update
+	std::vector<unsigned char> vVisibleGrids;
+
+	// The current broadphase
+	BROADPHASE eBroadphase;
+	// Handler to the CSweepAndPrune instance
+	CSweepAndPrune* cSweepAndPrune;
+	// The pairs of CSolidObjects which are overlapping in the CSweepAndPrune
+	std::vector<CSweepAndPrune::SOverlapEvent> vOverlappingPairs;
+	// Handler to the CNarrowphase instance
+	CNarrowphase* cNarrowphase;
+	// Boolean flag to indicate if the CGrids are tested for collisions on the worker threads
+	bool bParallelNarrowphase;
+	// The visible CGrids which are tested for collisions, in the order of the serial path
+	std::vector<CGrid*> vCollisionGrids;
+
+	// Check for collisions between the pairs of CSolidObjects found by the broadphase
+	bool CheckForCollision(void);
+	// Get the rows and columns of the CGrids which the bounding box of a CSolidObject overlaps
+	void GetGridRange(CSolidObject* cSolidObject, int& iMinRow, int& iMinCol, int& iMaxRow, int& iMaxCol) const;
 
 };
@@ -0,0 +1,428 @@
+/**
+ CSweepAndPrune
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#include "SweepAndPrune.h"
+
+#include <algorithm>
+
+#include <iostream>
+using namespace std;
+
+/**
+ @brief Constructor
+ */
+CSweepAndPrune::CSweepAndPrune(void)
+	: iNumOfSwaps(0)
+{
+}
+
+/**
+ @brief Destructor
+ */
+CSweepAndPrune::~CSweepAndPrune(void)
+{
+	// We won't delete the CSolidObjects since they were created elsewhere
+	Reset();
+}
+
+/**
+ @brief Add a new CSolidObject into this broadphase
+ @param cSolidObject A CSolidObject* variable storing the CSolidObject to add
+ @return A bool variable to indicate if the CSolidObject was added
+ */
+bool CSweepAndPrune::Add(CSolidObject* cSolidObject)
+{
+	if ((cSolidObject == NULL) || (IsHere(cSolidObject) == true))
+		return false;
+
+	// Reuse a free proxy if there is one, else create a new proxy
+	unsigned int uiProxy = 0;
+	if (vFreeProxies.size() > 0)
+	{
+		uiProxy = vFreeProxies.back();
+		vFreeProxies.pop_back();
+	}
+	else
+	{
+		uiProxy = (unsigned int)vProxies.size();
+		vProxies.push_back(SProxy());
+	}
+	vProxies[uiProxy].cSolidObject = cSolidObject;
+	UpdateProxy(vProxies[uiProxy]);
+	mapProxyIndex[cSolidObject] = uiProxy;
+
+	// Append the endpoints to the end of each axis.
+	// They will be moved to their sorted positions in the next Update
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		SEndPoint sEndPoint;
+		sEndPoint.uiProxy = uiProxy;
+
+		sEndPoint.fValue = vProxies[uiProxy].fMin[iAxis];
+		sEndPoint.bIsMin = true;
+		vEndPoints[iAxis].push_back(sEndPoint);
+
+		sEndPoint.fValue = vProxies[uiProxy].fMax[iAxis];
+		sEndPoint.bIsMin = false;
+		vEndPoints[iAxis].push_back(sEndPoint);
+	}
+
+	return true;
+}
+
+/**
+ @brief Remove but not delete a CSolidObject from this broadphase.
+		The CSolidObject is not dereferenced, so it is safe to call this after it was deleted.
+ @param cSolidObject A CSolidObject* variable storing the CSolidObject to remove
+ @return A bool variable to indicate if the CSolidObject was removed
+ */
+bool CSweepAndPrune::Remove(CSolidObject* cSolidObject)
+{
+	std::map<CSolidObject*, unsigned int>::iterator itProxy = mapProxyIndex.find(cSolidObject);
+	if (itProxy == mapProxyIndex.end())
+		return false;
+
+	const unsigned int uiProxy = itProxy->second;
+
+	// End all the overlaps involving this proxy
+	std::set<unsigned long long>::iterator it = setOverlappingPairs.begin();
+	while (it != setOverlappingPairs.end())
+	{
+		const unsigned int uiProxyA = (unsigned int)((*it) >> 32);
+		const unsigned int uiProxyB = (unsigned int)((*it) & 0xFFFFFFFF);
+		if ((uiProxyA == uiProxy) || (uiProxyB == uiProxy))
+		{
+			SOverlapEvent sOverlapEvent;
+			sOverlapEvent.cSolidObjectA = vProxies[uiProxyA].cSolidObject;
+			sOverlapEvent.cSolidObjectB = vProxies[uiProxyB].cSolidObject;
+			vEndEvents.push_back(sOverlapEvent);
+			it = setOverlappingPairs.erase(it);
+		}
+		else
+			++it;
+	}
+
+	// Remove the endpoints from each axis while keeping the rest of the axis sorted
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		std::vector<SEndPoint>::iterator itEndPoint = vEndPoints[iAxis].begin();
+		while (itEndPoint != vEndPoints[iAxis].end())
+		{
+			if ((*itEndPoint).uiProxy == uiProxy)
+				itEndPoint = vEndPoints[iAxis].erase(itEndPoint);
+			else
+				++itEndPoint;
+		}
+	}
+
+	vProxies[uiProxy].cSolidObject = NULL;
+	vFreeProxies.push_back(uiProxy);
+	mapProxyIndex.erase(itProxy);
+
+	return true;
+}
+
+/**
+ @brief Check if a CSolidObject is in this broadphase
+ @param cSolidObject A CSolidObject* variable storing the CSolidObject to check for
+ @return A bool variable which is true if the CSolidObject is in this broadphase
+ */
+bool CSweepAndPrune::IsHere(CSolidObject* cSolidObject) const
+{
+	if (mapProxyIndex.count(cSolidObject) == 0)
+		return false;
+	return true;
+}
+
+/**
+ @brief Remove all CSolidObjects from this broadphase
+ */
+void CSweepAndPrune::Reset(void)
+{
+	vProxies.clear();
+	vFreeProxies.clear();
+	mapProxyIndex.clear();
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+		vEndPoints[iAxis].clear();
+	setOverlappingPairs.clear();
+	vBeginEvents.clear();
+	vEndEvents.clear();
+	iNumOfSwaps = 0;
+}
+
+/**
+ @brief Add and remove CSolidObjects so that this broadphase matches a list of CSolidObjects
+ @param lSolidObject A const std::list<CSolidObject*>& variable containing the CSolidObjects in the scene
+ */
+void CSweepAndPrune::Synchronise(const std::list<CSolidObject*>& lSolidObject)
+{
+	// Clear the events here, so that removals done below are reported in this frame
+	vBeginEvents.clear();
+	vEndEvents.clear();
+
+	// Remove the CSolidObjects which are no longer in the list
+	if (mapProxyIndex.size() > 0)
+	{
+		std::set<CSolidObject*> setSolidObject(lSolidObject.begin(), lSolidObject.end());
+		std::vector<CSolidObject*> vToRemove;
+		std::map<CSolidObject*, unsigned int>::iterator it, end;
+		end = mapProxyIndex.end();
+		for (it = mapProxyIndex.begin(); it != end; ++it)
+		{
+			if (setSolidObject.count(it->first) == 0)
+				vToRemove.push_back(it->first);
+		}
+		for (unsigned int i = 0; i < vToRemove.size(); i++)
+			Remove(vToRemove[i]);
+	}
+
+	// Add the new CSolidObjects
+	std::list<CSolidObject*>::const_iterator it, end;
+	end = lSolidObject.end();
+	for (it = lSolidObject.begin(); it != end; ++it)
+	{
+		Add(*it);
+	}
+}
+
+/**
+ @brief Update the sorted axes and the list of overlapping pairs.
+		Since most CSolidObjects barely move between frames, each axis is nearly sorted
+		and the insertion sort only does a few swaps. Each swap is where a pair may start or stop overlapping.
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CSweepAndPrune::Update(void)
+{
+	iNumOfSwaps = 0;
+
+	// Update the bounding boxes of all proxies
+	for (unsigned int i = 0; i < vProxies.size(); i++)
+	{
+		if (vProxies[i].cSolidObject)
+			UpdateProxy(vProxies[i]);
+	}
+
+	// Copy the new bounding boxes into the endpoints
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		std::vector<SEndPoint>& vAxis = vEndPoints[iAxis];
+		for (unsigned int i = 0; i < vAxis.size(); i++)
+		{
+			if (vAxis[i].bIsMin)
+				vAxis[i].fValue = vProxies[vAxis[i].uiProxy].fMin[iAxis];
+			else
+				vAxis[i].fValue = vProxies[vAxis[i].uiProxy].fMax[iAxis];
+		}
+	}
+
+	// Sort the axes
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		SortAxis(iAxis);
+	}
+
+	return true;
+}
+
+/**
+ @brief Get the overlap events which started in the last Update
+ @return A const std::vector<SOverlapEvent>& variable containing the events
+ */
+const std::vector<CSweepAndPrune::SOverlapEvent>& CSweepAndPrune::GetBeginEvents(void) const
+{
+	return vBeginEvents;
+}
+
+/**
+ @brief Get the overlap events which ended in the last Update
+ @return A const std::vector<SOverlapEvent>& variable containing the events
+ */
+const std::vector<CSweepAndPrune::SOverlapEvent>& CSweepAndPrune::GetEndEvents(void) const
+{
+	return vEndEvents;
+}
+
+/**
+ @brief Get all the pairs which are currently overlapping
+ @param vOverlappingPairs A std::vector<SOverlapEvent>& variable to store the pairs in
+ */
+void CSweepAndPrune::GetOverlappingPairs(std::vector<SOverlapEvent>& vOverlappingPairs) const
+{
+	vOverlappingPairs.clear();
+	vOverlappingPairs.reserve(setOverlappingPairs.size());
+
+	std::set<unsigned long long>::const_iterator it, end;
+	end = setOverlappingPairs.end();
+	for (it = setOverlappingPairs.begin(); it != end; ++it)
+	{
+		SOverlapEvent sOverlapEvent;
+		sOverlapEvent.cSolidObjectA = vProxies[(unsigned int)((*it) >> 32)].cSolidObject;
+		sOverlapEvent.cSolidObjectB = vProxies[(unsigned int)((*it) & 0xFFFFFFFF)].cSolidObject;
+		vOverlappingPairs.push_back(sOverlapEvent);
+	}
+}
+
+/**
+ @brief Get the number of pairs which are currently overlapping
+ @return An int variable containing the number of overlapping pairs
+ */
+int CSweepAndPrune::GetNumOfOverlappingPairs(void) const
+{
+	return (int)setOverlappingPairs.size();
+}
+
+/**
+ @brief Get the number of endpoint swaps done in the last Update
+ @return An int variable containing the number of swaps
+ */
+int CSweepAndPrune::GetNumOfSwaps(void) const
+{
+	return iNumOfSwaps;
+}
+
+/**
+ @brief PrintSelf
+ */
+void CSweepAndPrune::PrintSelf(void) const
+{
+	cout << "CSweepAndPrune::PrintSelf()" << endl;
+	cout << "\tNumber of proxies: " << mapProxyIndex.size() << endl;
+	cout << "\tNumber of overlapping pairs: " << setOverlappingPairs.size() << endl;
+	cout << "\tNumber of swaps: " << iNumOfSwaps << endl;
+	cout << "\tNumber of begin events: " << vBeginEvents.size() << endl;
+	cout << "\tNumber of end events: " << vEndEvents.size() << endl;
+}
+
+/**
+ @brief Update the bounding box of a proxy using its CSolidObject's position
+ @param sProxy A SProxy& variable storing the proxy to update
+ */
+void CSweepAndPrune::UpdateProxy(SProxy& sProxy)
+{
+	const glm::vec3 vec3Min = sProxy.cSolidObject->GetPosition() + sProxy.cSolidObject->boxMin;
+	const glm::vec3 vec3Max = sProxy.cSolidObject->GetPosition() + sProxy.cSolidObject->boxMax;
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		sProxy.fMin[iAxis] = vec3Min[iAxis];
+		sProxy.fMax[iAxis] = vec3Max[iAxis];
+	}
+}
+
+/**
+ @brief Insertion sort an axis, starting from the current order.
+		When a min endpoint moves before a max endpoint, the 2 proxies may start overlapping.
+		When a max endpoint moves before a min endpoint, the 2 proxies stop overlapping.
+ @param iAxis A const int variable containing the index of the axis to sort
+ */
+void CSweepAndPrune::SortAxis(const int iAxis)
+{
+	std::vector<SEndPoint>& vAxis = vEndPoints[iAxis];
+	for (unsigned int i = 1; i < vAxis.size(); i++)
+	{
+		const SEndPoint sEndPoint = vAxis[i];
+		int j = (int)i - 1;
+		while ((j >= 0) && (IsLess(sEndPoint, vAxis[j]) == true))
+		{
+			const SEndPoint& sOther = vAxis[j];
+			if ((sEndPoint.bIsMin == true) && (sOther.bIsMin == false))
+			{
+				// Test the other axes with the latest bounding boxes
+				if (IsOverlapping(sEndPoint.uiProxy, sOther.uiProxy) == true)
+					AddPair(sEndPoint.uiProxy, sOther.uiProxy);
+			}
+			else if ((sEndPoint.bIsMin == false) && (sOther.bIsMin == true))
+			{
+				RemovePair(sEndPoint.uiProxy, sOther.uiProxy);
+			}
+
+			vAxis[j + 1] = vAxis[j];
+			j--;
+			iNumOfSwaps++;
+		}
+		vAxis[j + 1] = sEndPoint;
+	}
+}
+
+/**
+ @brief Check if an endpoint should be placed before another endpoint.
+		A min endpoint is placed before a max endpoint of the same value, so that touching boxes overlap.
+ @param sEndPointA A const SEndPoint& variable containing the first endpoint
+ @param sEndPointB A const SEndPoint& variable containing the second endpoint
+ @return A bool variable which is true if sEndPointA is placed before sEndPointB
+ */
+bool CSweepAndPrune::IsLess(const SEndPoint& sEndPointA, const SEndPoint& sEndPointB) const
+{
+	if (sEndPointA.fValue < sEndPointB.fValue)
+		return true;
+	if ((sEndPointA.fValue == sEndPointB.fValue) && (sEndPointA.bIsMin == true) && (sEndPointB.bIsMin == false))
+		return true;
+	return false;
+}
+
+/**
+ @brief Check if 2 proxies overlap on all axes
+ @param uiProxyA A const unsigned int variable containing the index of the first proxy
+ @param uiProxyB A const unsigned int variable containing the index of the second proxy
+ @return A bool variable which is true if the 2 proxies overlap
+ */
+bool CSweepAndPrune::IsOverlapping(const unsigned int uiProxyA, const unsigned int uiProxyB) const
+{
+	if (uiProxyA == uiProxyB)
+		return false;
+
+	const SProxy& sProxyA = vProxies[uiProxyA];
+	const SProxy& sProxyB = vProxies[uiProxyB];
+	for (int iAxis = 0; iAxis < iNumOfAxes; iAxis++)
+	{
+		if ((sProxyA.fMax[iAxis] < sProxyB.fMin[iAxis]) || (sProxyB.fMax[iAxis] < sProxyA.fMin[iAxis]))
+			return false;
+	}
+	return true;
+}
+
+/**
+ @brief Add an overlapping pair, and report a begin event if it is a new pair
+ @param uiProxyA A const unsigned int variable containing the index of the first proxy
+ @param uiProxyB A const unsigned int variable containing the index of the second proxy
+ */
+void CSweepAndPrune::AddPair(const unsigned int uiProxyA, const unsigned int uiProxyB)
+{
+	if (setOverlappingPairs.insert(GetPairKey(uiProxyA, uiProxyB)).second == true)
+	{
+		SOverlapEvent sOverlapEvent;
+		sOverlapEvent.cSolidObjectA = vProxies[std::min(uiProxyA, uiProxyB)].cSolidObject;
+		sOverlapEvent.cSolidObjectB = vProxies[std::max(uiProxyA, uiProxyB)].cSolidObject;
+		vBeginEvents.push_back(sOverlapEvent);
+	}
+}
+
+/**
+ @brief Remove an overlapping pair, and report an end event if the pair existed
+ @param uiProxyA A const unsigned int variable containing the index of the first proxy
+ @param uiProxyB A const unsigned int variable containing the index of the second proxy
+ */
+void CSweepAndPrune::RemovePair(const unsigned int uiProxyA, const unsigned int uiProxyB)
+{
+	if (setOverlappingPairs.erase(GetPairKey(uiProxyA, uiProxyB)) > 0)
+	{
+		SOverlapEvent sOverlapEvent;
+		sOverlapEvent.cSolidObjectA = vProxies[std::min(uiProxyA, uiProxyB)].cSolidObject;
+		sOverlapEvent.cSolidObjectB = vProxies[std::max(uiProxyA, uiProxyB)].cSolidObject;
+		vEndEvents.push_back(sOverlapEvent);
+	}
+}
+
+/**
+ @brief Get the key of a pair of proxies. The key is the same regardless of the order of the proxies.
+ @param uiProxyA A const unsigned int variable containing the index of the first proxy
+ @param uiProxyB A const unsigned int variable containing the index of the second proxy
+ @return An unsigned long long variable containing the key
+ */
+unsigned long long CSweepAndPrune::GetPairKey(const unsigned int uiProxyA, const unsigned int uiProxyB) const
+{
+	if (uiProxyA < uiProxyB)
+		return ((unsigned long long)uiProxyA << 32) | (unsigned long long)uiProxyB;
+	return ((unsigned long long)uiProxyB << 32) | (unsigned long long)uiProxyA;
+}
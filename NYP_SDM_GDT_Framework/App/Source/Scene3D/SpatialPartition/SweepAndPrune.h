@@ -0,0 +1,120 @@
+/**
+ CSweepAndPrune
+ By: Toh Da Jun
+ Date: Sep 2020
+ */
+#pragma once
+
+// Include GLM
+#include <includes/glm.hpp>
+
+// Include CSolidObject
+#include "../Entities/SolidObject.h"
+
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+using namespace std;
+
+class CSweepAndPrune
+{
+public:
+	// The number of axes which are sorted
+	static const int iNumOfAxes = 3;
+
+	// An overlap event between 2 CSolidObjects
+	struct SOverlapEvent
+	{
+		CSolidObject* cSolidObjectA;
+		CSolidObject* cSolidObjectB;
+	};
+
+	// Constructor
+	CSweepAndPrune(void);
+	// Destructor
+	virtual ~CSweepAndPrune(void);
+
+	// Add a new CSolidObject into this broadphase
+	bool Add(CSolidObject* cSolidObject);
+	// Remove but not delete a CSolidObject from this broadphase
+	bool Remove(CSolidObject* cSolidObject);
+	// Check if a CSolidObject is in this broadphase
+	bool IsHere(CSolidObject* cSolidObject) const;
+	// Remove all CSolidObjects from this broadphase
+	void Reset(void);
+
+	// Add and remove CSolidObjects so that this broadphase matches a list of CSolidObjects
+	void Synchronise(const std::list<CSolidObject*>& lSolidObject);
+
+	// Update the sorted axes and the list of overlapping pairs
+	bool Update(void);
+
+	// Get the overlap events which started in the last Update
+	const std::vector<SOverlapEvent>& GetBeginEvents(void) const;
+	// Get the overlap events which ended in the last Update
+	const std::vector<SOverlapEvent>& GetEndEvents(void) const;
+	// Get all the pairs which are currently overlapping
+	void GetOverlappingPairs(std::vector<SOverlapEvent>& vOverlappingPairs) const;
+	// Get the number of pairs which are currently overlapping
+	int GetNumOfOverlappingPairs(void) const;
+	// Get the number of endpoint swaps done in the last Update
+	int GetNumOfSwaps(void) const;
+
+	// PrintSelf
+	void PrintSelf(void) const;
+
+protected:
+	// A proxy stores the bounding box of a CSolidObject in this broadphase
+	struct SProxy
+	{
+		CSolidObject* cSolidObject;
+		float fMin[iNumOfAxes];
+		float fMax[iNumOfAxes];
+	};
+
+	// An endpoint of a proxy's bounding box along an axis
+	struct SEndPoint
+	{
+		float fValue;
+		unsigned int uiProxy;
+		bool bIsMin;
+	};
+
+	// Update the bounding box of a proxy using its CSolidObject's position
+	void UpdateProxy(SProxy& sProxy);
+	// Insertion sort an axis, starting from the current order
+	void SortAxis(const int iAxis);
+	// Check if an endpoint should be placed before another endpoint
+	bool IsLess(const SEndPoint& sEndPointA, const SEndPoint& sEndPointB) const;
+	// Check if 2 proxies overlap on all axes
+	bool IsOverlapping(const unsigned int uiProxyA, const unsigned int uiProxyB) const;
+
+	// Add an overlapping pair
+	void AddPair(const unsigned int uiProxyA, const unsigned int uiProxyB);
+	// Remove an overlapping pair
+	void RemovePair(const unsigned int uiProxyA, const unsigned int uiProxyB);
+	// Get the key of a pair of proxies
+	unsigned long long GetPairKey(const unsigned int uiProxyA, const unsigned int uiProxyB) const;
+
+	// The proxies of the CSolidObjects
+	std::vector<SProxy> vProxies;
+	// The indices of proxies which can be reused
+	std::vector<unsigned int> vFreeProxies;
+	// Look-up of a CSolidObject's proxy index
+	std::map<CSolidObject*, unsigned int> mapProxyIndex;
+
+	// The endpoints of the proxies, sorted along each axis
+	std::vector<SEndPoint> vEndPoints[iNumOfAxes];
+
+	// The pairs of proxies which are currently overlapping
+	std::set<unsigned long long> setOverlappingPairs;
+
+	// The overlap events which started in the last Update
+	std::vector<SOverlapEvent> vBeginEvents;
+	// The overlap events which ended in the last Update
+	std::vector<SOverlapEvent> vEndEvents;
+
+	// The number of endpoint swaps done in the last Update
+	int iNumOfSwaps;
+};
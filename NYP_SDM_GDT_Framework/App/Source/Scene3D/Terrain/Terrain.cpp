@@ -9,6 +9,15 @@ Date: Sep 2021
 #include "Terrain.h"
 
 #include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+
+#if defined(TERRAIN_AVX2)
+	#include <immintrin.h>
+#elif defined(TERRAIN_SSE2)
+	#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -26,13 +35,34 @@ using namespace std;
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
+// Include CJobSystem
+#include "../../JobSystem/JobSystem.h"
+
 /**
  @brief Constructor
  */
 CTerrain::CTerrain(void)
-	: vRenderScale(glm::vec3(1.0f, 1.0f, 1.0f))
+	: uiVAO(0)
+	, bLoaded(false)
+	, iRows(0)
+	, iCols(0)
+	, vRenderScale(glm::vec3(1.0f, 1.0f, 1.0f))
 	, vMinPos(glm::vec3(-1.0f))
 	, vMaxPos(glm::vec3(1.0f))
+	, fRowsPerUnit(0.0f)
+	, fColsPerUnit(0.0f)
+	, iNumOfChunkCols(0)
+	, iNumOfChunkRows(0)
+	, bLODEnabled(true)
+	, fLODDistance(20.0f)
+	, uiNumOfVisibleChunks(0)
+	, uiNumOfVertices(0)
+	, uiNumOfFullDetailVertices(0)
+	, bGPUDisplacementEnabled(false)
+	, uiHeightTextureID(0)
 {
 	// Set the default position of the Terrain
 	vec3Position = glm::vec3(0.0f, 0.0f, 0.0f);
@@ -112,15 +142,25 @@ void CTerrain::Render(void)
 	CShaderManager::GetInstance()->activeShader->setMat4("matrices.projMatrix", projection);
 	CShaderManager::GetInstance()->activeShader->setMat4("matrices.viewMatrix", view);
 
-	// We bind all 5 textures - 3 of them are textures for layers, 1 texture is a "path" texture, and last one is
-	// the places in heightmap where path should be and how intense should it be
-	for (int i = 0; i < 5; i++)
+	// We bind the texture arrays which have all 5 textures - 3 of them are textures for layers, 1 texture is a "path" texture,
+	// and last one is the places in heightmap where path should be and how intense should it be.
+	// The textures which have the same size share a texture array, and each array is bound to its own texture unit.
+	for (unsigned int i = 0; i < cTerrainMaterialTable.GetNumOfArrays(); i++)
 	{
+		cTerrainMaterialTable.Bind(i, i);
+
 		char sSamplerName[256];
-		sprintf(sSamplerName, "gSampler[%d]", i);
-		tTextures[i].BindTexture(i);
+		sprintf(sSamplerName, "gSamplers[%d]", i);
 		CShaderManager::GetInstance()->activeShader->setInt(sSamplerName, i);
 	}
+	for (int i = 0; i < NUMTEXTURES; i++)
+	{
+		char sLayerName[256];
+		sprintf(sLayerName, "fLayers[%d]", i);
+		CShaderManager::GetInstance()->activeShader->setFloat(sLayerName, (float)cTerrainMaterialTable.GetMaterial(i).uiLayer);
+		sprintf(sLayerName, "iArrays[%d]", i);
+		CShaderManager::GetInstance()->activeShader->setInt(sLayerName, (int)cTerrainMaterialTable.GetMaterial(i).uiArray);
+	}
 
 	// Create model transformations
 	model = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
@@ -136,21 +176,82 @@ void CTerrain::Render(void)
 
 	CShaderManager::GetInstance()->activeShader->setMat4("HeightmapScaleMatrix", glm::scale(glm::mat4(1.0), glm::vec3(vRenderScale)));
 
-	// Now we're ready to render - we are drawing set of triangle strips using one call, but we g otta enable primitive restart
-	glBindVertexArray(uiVAO);
-	glEnable(GL_PRIMITIVE_RESTART);
-	glPrimitiveRestartIndex(iRows * iCols);
+	// The GPU displacement reads the heights from the height texture in the texture unit after the texture arrays
+	CShaderManager::GetInstance()->activeShader->setInt("bDisplacement", bGPUDisplacementEnabled ? 1 : 0);
+	if (bGPUDisplacementEnabled)
+	{
+		glActiveTexture(GL_TEXTURE0 + NUMTEXTURES);
+		glBindTexture(GL_TEXTURE_2D, uiHeightTextureID);
+		CShaderManager::GetInstance()->activeShader->setInt("heightmapSampler", NUMTEXTURES);
+	}
 
-	int iNumIndices = (iRows - 1) * iCols * 2 + iRows - 1;
-	glDrawElements(GL_TRIANGLE_STRIP, iNumIndices, GL_UNSIGNED_INT, 0);
-	glDisable(GL_PRIMITIVE_RESTART);
-	glBindVertexArray(0);
+	// Cull the chunks against the frustum of this view and projection, so that the minimap
+	// and the main view only draw the chunks which they can see
+	cFrustumCulling.SetView(view);
+	cFrustumCulling.SetProjection(projection);
+	cFrustumCulling.UpdatePlanes();
+
+	// Select the level of detail of the chunks from the camera of this view
+	SelectLODs(glm::vec3(glm::inverse(view)[3]));
+
+	vDrawCounts.clear();
+	vDrawOffsets.clear();
+	vDrawBaseVertices.clear();
+	uiNumOfVertices = 0;
+	uiNumOfFullDetailVertices = 0;
+	for (int iChunkRow = 0; iChunkRow < iNumOfChunkRows; iChunkRow++)
+	{
+		for (int iChunkCol = 0; iChunkCol < iNumOfChunkCols; iChunkCol++)
+		{
+			const SChunk& sChunk = vChunks[iChunkRow * iNumOfChunkCols + iChunkCol];
+
+			// Scale and translate the bounds of the chunk in the same way as the vertex shader
+			glm::vec3 vec3BoundsMin = vec3Position + vRenderScale * sChunk.vec3BoundsMin;
+			glm::vec3 vec3BoundsMax = vec3Position + vRenderScale * sChunk.vec3BoundsMax;
+			if (cFrustumCulling.IsBoxVisible(vec3BoundsMin, vec3BoundsMax) == false)
+				continue;
+
+			const SPattern& sPattern = vPatterns[sChunk.uiFirstPattern + sChunk.iLOD * NUM_STITCHES + GetStitches(iChunkRow, iChunkCol)];
+			vDrawCounts.push_back(sPattern.iNumOfIndices);
+			vDrawOffsets.push_back((const void*)(sPattern.uiFirstIndex * sizeof(GLuint)));
+			vDrawBaseVertices.push_back(sChunk.iBaseVertex);
+
+			uiNumOfVertices += ((sChunk.iNumOfCols >> sChunk.iLOD) + 1) * ((sChunk.iNumOfRows >> sChunk.iLOD) + 1);
+			uiNumOfFullDetailVertices += (sChunk.iNumOfCols + 1) * (sChunk.iNumOfRows + 1);
+		}
+	}
+	uiNumOfVisibleChunks = (unsigned int)vDrawCounts.size();
+
+	// Now we're ready to render - we are drawing the triangles of all the visible chunks using one call
+	if ((uiNumOfVisibleChunks > 0) && (bGPUDisplacementEnabled == false))
+	{
+		glBindVertexArray(uiVAO);
+		glMultiDrawElementsBaseVertex(GL_TRIANGLES, &vDrawCounts[0], GL_UNSIGNED_INT, &vDrawOffsets[0],
+									  (GLsizei)uiNumOfVisibleChunks, &vDrawBaseVertices[0]);
+		glBindVertexArray(0);
+	}
+	// With the GPU displacement, the grid patch is drawn once for every visible chunk, at the column and row of its top-left vertex
+	else if (uiNumOfVisibleChunks > 0)
+	{
+		glBindVertexArray(uiVAO);
+		for (unsigned int i = 0; i < uiNumOfVisibleChunks; i++)
+		{
+			CShaderManager::GetInstance()->activeShader->setVec2("vec2ChunkOrigin",
+				glm::vec2(float(vDrawBaseVertices[i] % iCols), float(vDrawBaseVertices[i] / iCols)));
+			glDrawElements(GL_TRIANGLES, vDrawCounts[i], GL_UNSIGNED_INT, vDrawOffsets[i]);
+		}
+		glBindVertexArray(0);
+
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glActiveTexture(GL_TEXTURE0);
+	}
 
-	// Unbind the texture and samplers
-	for (int i = 0; i < 5; i++)
+	// Unbind the texture arrays
+	for (unsigned int i = 0; i < cTerrainMaterialTable.GetNumOfArrays(); i++)
 	{
-		tTextures[i].UnBindTexture(i);
+		cTerrainMaterialTable.Unbind(i);
 	}
+	glActiveTexture(GL_TEXTURE0);
 }
 
 /**
@@ -170,18 +271,18 @@ void CTerrain::PostRender(void)
 bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 {
 	if (bLoaded)
-	{
-		bLoaded = false;
 		ReleaseHeightmap();
-	}
 
 	// Load the player texture
 	int iNrChannels = 0;
-	BYTE* bDataPointer = CImageLoader::GetInstance()->Load(sImagePath.c_str(), iCols, iRows, iNrChannels);
+	BYTE* bDataPointer = NULL;
+	bDataPointer = CAssetLoader::GetInstance()->DecodeImage(sImagePath.c_str(), iCols, iRows, iNrChannels);
 	// We also require our image to be either 24-bit (classic RGB) or 8-bit (luminance)
 	if (bDataPointer == NULL || iRows == 0 || iCols == 0 || (iNrChannels != 3 && iNrChannels != 1))
 	{
 		cout << "Unable to load the heightmap." << endl;
+		if (bDataPointer)
+			free(bDataPointer);
 		return false;
 	}
 
@@ -189,6 +290,7 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 	if ((iRows < 3) || (iCols < 3))
 	{
 		cout << "The heightmap should have more than 3 rows or columns: Currently it has " << iRows << " rows and " << iCols << " columns." << endl;
+		free(bDataPointer);
 		return false;
 	}
 
@@ -197,156 +299,30 @@ bool CTerrain::LoadHeightMapFromImage(const string sImagePath)
 	// Length of one row in data
 	unsigned int row_step = ptr_inc * iCols;
 
-	vboHeightmapData.CreateVBO();
-	// All vertex data are here (there are iRows*iCols vertices in this heightmap), we will get to normals later
-	//vector< vector< glm::vec3> > vVertexData(iRows, vector<glm::vec3>(iCols));
-	//vector< vector< glm::vec2> > vCoordsData(iRows, vector<glm::vec2>(iCols));
-
-	vVertexData.resize(iRows, vector<glm::vec3>(iCols, glm::vec3(0.0f)));
-	vCoordsData.resize(iRows, vector<glm::vec2>(iCols, glm::vec2(0.0f)));
+	CJobSystem* cJobSystem = CJobSystem::GetInstance();
 
-	float fTextureU = float(iCols) * 0.1f;
-	float fTextureV = float(iRows) * 0.1f;
-
-	for (int i = 0; i < iRows; i++)
+	// Read the heights from the image. Each job writes to its own rows, so no locking is needed.
+	vHeights.resize(iRows * iCols);
+	cJobSystem->ParallelFor((unsigned int)iRows, uiRowsPerJob,
+		[this, bDataPointer, ptr_inc, row_step](const unsigned int uiBegin, const unsigned int uiEnd)
 	{
-		for (int j = 0; j < iCols; j++)
+		for (int i = (int)uiBegin; i < (int)uiEnd; i++)
 		{
-			float fScaleC = float(j) / float(iCols - 1);
-			float fScaleR = float(i) / float(iRows - 1);
-			float fVertexHeight = float(*(bDataPointer + row_step * i + j * ptr_inc)) / 255.0f;
-			vVertexData[i][j] = glm::vec3(-0.5f + fScaleC, fVertexHeight, -0.5f + fScaleR);
-			vCoordsData[i][j] = glm::vec2(fTextureU * fScaleC, fTextureV * fScaleR);
+			const BYTE* pRow = bDataPointer + row_step * i;
+			float* pfHeights = &vHeights[i * iCols];
+			for (int j = 0; j < iCols; j++)
+				pfHeights[j] = float(pRow[j * ptr_inc]) / 255.0f;
 		}
-	}
+	});
 
 	// Clear the memory
-	delete bDataPointer;
+	free(bDataPointer);
 	bDataPointer = NULL;
 
-	// Normals are here - the heightmap contains ( (iRows-1)*(iCols-1) quads, each one containing 2 triangles, therefore array of we have 3D array)
-	vector< vector<glm::vec3> > vNormals[2];
-	for (int i = 0; i < 2; i++)
-		vNormals[i] = vector< vector<glm::vec3> >(iRows - 1, vector<glm::vec3>(iCols - 1));
-
-	for (int i = 0; i < iRows - 1; i++)
-	{
-		for (int j = 0; j < iCols - 1; j++)
-		{
-			glm::vec3 vTriangle0[] =
-			{
-				vVertexData[i][j],
-				vVertexData[i + 1][j],
-				vVertexData[i + 1][j + 1]
-			};
-			glm::vec3 vTriangle1[] =
-			{
-				vVertexData[i + 1][j + 1],
-				vVertexData[i][j + 1],
-				vVertexData[i][j]
-			};
-
-			glm::vec3 vTriangleNorm0 = glm::cross(vTriangle0[0] - vTriangle0[1], vTriangle0[1] - vTriangle0[2]);
-			glm::vec3 vTriangleNorm1 = glm::cross(vTriangle1[0] - vTriangle1[1], vTriangle1[1] - vTriangle1[2]);
-
-			vNormals[0][i][j] = glm::normalize(vTriangleNorm0);
-			vNormals[1][i][j] = glm::normalize(vTriangleNorm1);
-		}
-	}
-
-	vector< vector<glm::vec3> > vFinalNormals = vector< vector<glm::vec3> >(iRows, vector<glm::vec3>(iCols));
-
-	for (int i = 0; i < iRows; i++)
-		for (int j = 0; j < iCols; j++)
-		{
-			// Now we wanna calculate final normal for [i][j] vertex. We will have a look at all triangles this vertex is part of, and then we will make average vector
-			// of all adjacent triangles' normals
-			glm::vec3 vFinalNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-			// Look for upper-left triangles
-			if (j != 0 && i != 0)
-				for (int k = 0; k < 2; k++)
-					vFinalNormal += vNormals[k][i - 1][j - 1];
-			// Look for upper-right triangles
-			if (i != 0 && j != iCols - 1)
-				vFinalNormal += vNormals[0][i - 1][j];
-			// Look for bottom-right triangles
-			if (i != iRows - 1 && j != iCols - 1)
-				for (int k = 0; k < 2; k++)
-					vFinalNormal += vNormals[k][i][j];
-			// Look for bottom-left triangles
-			if (i != iRows - 1 && j != 0)
-				vFinalNormal += vNormals[1][i][j - 1];
-			vFinalNormal = glm::normalize(vFinalNormal);
-
-			vFinalNormals[i][j] = vFinalNormal; // Store final normal of j-th vertex in i-th row
-		}
-
-	// First, create a VBO with only vertex data
-	int counter = 0;
-	vboHeightmapData.CreateVBO(iRows * iCols * (2 * sizeof(glm::vec3) + sizeof(glm::vec2))); // Preallocate memory
-	for (int i = 0; i < iRows; i++)
-	{
-		for (int j = 0; j < iCols; j++)
-		{
-			vboHeightmapData.AddData(&vVertexData[i][j], sizeof(glm::vec3)); // Add vertex
-			vboHeightmapData.AddData(&vCoordsData[i][j], sizeof(glm::vec2)); // Add tex. coord
-			vboHeightmapData.AddData(&vFinalNormals[i][j], sizeof(glm::vec3)); // Add normal
-			counter++;
-		}
-	}
-
-	// Now create a VBO with heightmap indices
-	/*
-		0-1-2
-		|/|/|
-		3-4-5
-		and
-		3-4-5
-		|/|/|
-		6-7-8
-
-		0, 3, 1, 4, 2, 5 for first strip and
-		3, 6, 4, 7, 5, 8 for second strip
-	*/
-	vboHeightmapIndices.CreateVBO();
-	int iPrimitiveRestartIndex = iRows * iCols;
-	for (int i = 0; i < iRows - 1; i++)
-	{
-		for (int j = 0; j < iCols - 1; j++)
-			for (int k = 1; k >= 0; k--)
-			{
-				int iRow = i + (1 - k);
-				int iIndex = iRow * iCols + j;
-				vboHeightmapIndices.AddData(&iIndex, sizeof(int));
-			}
-		// Restart triangle strips
-		vboHeightmapIndices.AddData(&iPrimitiveRestartIndex, sizeof(int));
-	}
-
-	glGenVertexArrays(1, &uiVAO);
-	glBindVertexArray(uiVAO);
-	// Attach vertex data to this VAO
-	vboHeightmapData.BindVBO();
-	vboHeightmapData.UploadDataToGPU(GL_STATIC_DRAW);
-
-	// Vertex positions
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3) + sizeof(glm::vec2), 0);
-	// Texture coordinates
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3) + sizeof(glm::vec2), (void*)sizeof(glm::vec3));
-	// Normal vectors
-	glEnableVertexAttribArray(2);
-	glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3) + sizeof(glm::vec2), (void*)(sizeof(glm::vec3) + sizeof(glm::vec2)));
+	// Create the buffers of the current render path
+	CreateBuffers();
 
-	// And now attach index data to this VAO
-	// Here don't forget to bind another type of VBO - the element array buffer, or simplier indices to vertices
-	vboHeightmapIndices.BindVBO(GL_ELEMENT_ARRAY_BUFFER);
-	vboHeightmapIndices.UploadDataToGPU(GL_STATIC_DRAW);
-	vboHeightmapData.BindVBO();
-
-	glBindVertexArray(0);
+	UpdateHeightScales();
 
 	bLoaded = true; // If get here, we succeeded with generating heightmap
 	return true;
@@ -365,6 +341,8 @@ void CTerrain::SetRenderSize(const float fRenderX, const float fHeight, const fl
 	// Calculate the min and max positions
 	vMinPos = glm::vec3(fRenderX * -0.5f, 0.0f, fRenderZ * -0.5f);
 	vMaxPos = glm::vec3(fRenderX * 0.5f, fHeight, fRenderZ * 0.5f);
+
+	UpdateHeightScales();
 }
 
 /**
@@ -375,6 +353,8 @@ void CTerrain::SetRenderSize(const float fRenderX, const float fHeight, const fl
 void CTerrain::SetRenderSize(const float fQuadSize, const float fHeight)
 {
 	vRenderScale = glm::vec3(float(iCols) * fQuadSize, fHeight, float(iRows) * fQuadSize);
+
+	UpdateHeightScales();
 }
 
 /**
@@ -385,14 +365,16 @@ void CTerrain::ReleaseHeightmap(void)
 	if (!bLoaded)
 		return; // Heightmap must be loaded
 
-	vboHeightmapData.DeleteVBO();
-	vboHeightmapIndices.DeleteVBO();
+	ReleaseBuffers();
+	vHeights.clear();
+	vChunks.clear();
+	vPatterns.clear();
+	iNumOfChunkCols = 0;
+	iNumOfChunkRows = 0;
+	uiNumOfVisibleChunks = 0;
+	uiNumOfVertices = 0;
+	uiNumOfFullDetailVertices = 0;
 
-	glDisableVertexAttribArray(2);
-	glDisableVertexAttribArray(1);
-	glDisableVertexAttribArray(0);
-
-	glDeleteVertexArrays(1, &uiVAO);
 	bLoaded = false;
 }
 
@@ -420,78 +402,149 @@ int CTerrain::GetNumHeightmapCols(void) const
  @param fZ A const float variable containing the z coordinate to check for the height
  @return A float variable
  */
-float CTerrain::GetHeight(const float fX, const float fZ)
+float CTerrain::GetHeight(const float fX, const float fZ) const
 {
-	int iCol = 0, iRow = 0;
-	float fCol = 0.0f, fRow = 0.0f;
+	// If it is out of the boundary, then return 0.0f. This is written as a check for being inside,
+	// so that a NaN coordinate is also treated as being out of the boundary.
+	if ((vHeights.empty() == true) ||
+		!(((fX >= vMinPos.x) && (fX < vMaxPos.x)) &&
+		  ((fZ >= vMinPos.z) && (fZ < vMaxPos.z))))
+		return 0.0f;
 
-	// If it is out of the boundary, then clamp it to the limits of this terrain
-	if (fX < vMinPos.x)
-	{
-		iCol = 0;
-		// Calculate the raw indices for these coordinates
-		fCol = 0.0f;
-	}
-	else if (fX >= vMaxPos.x)
-	{
-		// Calculate the indices for these coordinates
-		iCol = iCols - 2;
-		// Calculate the raw indices for these coordinates
-		fCol = (float)iCol;
-	}
-	else
-	{
-		// Calculate the raw indices for these coordinates
-		fCol = ((fX - (vRenderScale.x * -0.5f)) / vRenderScale.x) * iCols;
-		// Calculate the indices for these coordinates
-		iCol = (int)floor(fCol);
-	}
+	// Calculate the raw indices for these coordinates
+	float fCol = max((fX + vRenderScale.x * 0.5f) * fColsPerUnit, 0.0f);
+	float fRow = max((fZ + vRenderScale.z * 0.5f) * fRowsPerUnit, 0.0f);
+
+	// Calculate the indices for these coordinates, and keep the 4 samples inside the heightmap
+	int iCol = min((int)fCol, iCols - 2);
+	int iRow = min((int)fRow, iRows - 2);
 
-	if (fZ < vMinPos.z)
+	// Use Bilinear interpolation of the surrounding 4 indices to smooth out the height
+	float fTCol = fCol - iCol;
+	float fTRow = fRow - iRow;
+	const float* pfSamples = &vHeights[iRow * iCols + iCol];
+	float fTop = pfSamples[0] + (pfSamples[1] - pfSamples[0]) * fTCol;
+	float fBottom = pfSamples[iCols] + (pfSamples[iCols + 1] - pfSamples[iCols]) * fTCol;
+
+	return vRenderScale.y * (fTop + (fBottom - fTop) * fTRow);
+}
+
+/**
+ @brief Get the heights at a batch of X- and Z-coordinates. SSE or AVX2 is used to interpolate
+		the heights at 4 or 8 coordinates per instruction. The heights outside of this terrain are 0.0f.
+ @param pfX A const float* variable containing the x coordinates to check for the heights
+ @param pfZ A const float* variable containing the z coordinates to check for the heights
+ @param pfHeights A float* variable to store the heights. It must have space for all the coordinates.
+ @param uiNumOfPositions A const unsigned int variable containing the number of coordinates
+ */
+void CTerrain::GetHeights(const float* pfX, const float* pfZ, float* pfHeights, const unsigned int uiNumOfPositions) const
+{
+	unsigned int i = 0;
+
+	if (vHeights.empty() == true)
 	{
-		iRow = 0;
-		// Calculate the raw indices for these coordinates
-		fRow = 0.0f;
+		for (; i < uiNumOfPositions; i++)
+			pfHeights[i] = 0.0f;
+		return;
 	}
-	else if (fZ >= vMaxPos.z)
+
+#if defined(TERRAIN_AVX2)
+	const __m256 m256MinX = _mm256_set1_ps(vMinPos.x);
+	const __m256 m256MaxX = _mm256_set1_ps(vMaxPos.x);
+	const __m256 m256MinZ = _mm256_set1_ps(vMinPos.z);
+	const __m256 m256MaxZ = _mm256_set1_ps(vMaxPos.z);
+	const __m256 m256OffsetX = _mm256_set1_ps(vRenderScale.x * 0.5f);
+	const __m256 m256OffsetZ = _mm256_set1_ps(vRenderScale.z * 0.5f);
+	const __m256 m256ColsPerUnit = _mm256_set1_ps(fColsPerUnit);
+	const __m256 m256RowsPerUnit = _mm256_set1_ps(fRowsPerUnit);
+	const __m256 m256MaxCol = _mm256_set1_ps(float(iCols - 2));
+	const __m256 m256MaxRow = _mm256_set1_ps(float(iRows - 2));
+	const __m256 m256NumOfCols = _mm256_set1_ps(float(iCols));
+	const __m256 m256HeightScale = _mm256_set1_ps(vRenderScale.y);
+	const __m256 m256Zero = _mm256_setzero_ps();
+	for (; i + 8 <= uiNumOfPositions; i += 8)
 	{
-		// Calculate the indices for these coordinates
-		iRow = iRows - 2;
-		// Calculate the raw indices for these coordinates
-		fRow = (float)iRow;
+		const __m256 m256X = _mm256_loadu_ps(&pfX[i]);
+		const __m256 m256Z = _mm256_loadu_ps(&pfZ[i]);
+		const __m256 m256Inside = _mm256_and_ps(
+			_mm256_and_ps(_mm256_cmp_ps(m256X, m256MinX, _CMP_GE_OQ), _mm256_cmp_ps(m256X, m256MaxX, _CMP_LT_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(m256Z, m256MinZ, _CMP_GE_OQ), _mm256_cmp_ps(m256Z, m256MaxZ, _CMP_LT_OQ)));
+
+		// Calculate the raw indices, and keep the 4 samples of every coordinate inside the heightmap
+		const __m256 m256Col = _mm256_max_ps(_mm256_mul_ps(_mm256_add_ps(m256X, m256OffsetX), m256ColsPerUnit), m256Zero);
+		const __m256 m256Row = _mm256_max_ps(_mm256_mul_ps(_mm256_add_ps(m256Z, m256OffsetZ), m256RowsPerUnit), m256Zero);
+		const __m256 m256FloorCol = _mm256_floor_ps(_mm256_min_ps(m256Col, m256MaxCol));
+		const __m256 m256FloorRow = _mm256_floor_ps(_mm256_min_ps(m256Row, m256MaxRow));
+		const __m256i m256iIndex = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(m256FloorRow, m256NumOfCols), m256FloorCol));
+
+		// Gather the 4 samples around each coordinate
+		const __m256 m256Sample00 = _mm256_i32gather_ps(&vHeights[0], m256iIndex, 4);
+		const __m256 m256Sample01 = _mm256_i32gather_ps(&vHeights[1], m256iIndex, 4);
+		const __m256 m256Sample10 = _mm256_i32gather_ps(&vHeights[iCols], m256iIndex, 4);
+		const __m256 m256Sample11 = _mm256_i32gather_ps(&vHeights[iCols + 1], m256iIndex, 4);
+
+		// Use Bilinear interpolation of the 4 samples
+		const __m256 m256TCol = _mm256_sub_ps(m256Col, m256FloorCol);
+		const __m256 m256TRow = _mm256_sub_ps(m256Row, m256FloorRow);
+		const __m256 m256Top = _mm256_add_ps(m256Sample00, _mm256_mul_ps(_mm256_sub_ps(m256Sample01, m256Sample00), m256TCol));
+		const __m256 m256Bottom = _mm256_add_ps(m256Sample10, _mm256_mul_ps(_mm256_sub_ps(m256Sample11, m256Sample10), m256TCol));
+		const __m256 m256Height = _mm256_mul_ps(m256HeightScale, _mm256_add_ps(m256Top, _mm256_mul_ps(_mm256_sub_ps(m256Bottom, m256Top), m256TRow)));
+		_mm256_storeu_ps(&pfHeights[i], _mm256_and_ps(m256Inside, m256Height));
 	}
-	else
+#elif defined(TERRAIN_SSE2)
+	const __m128 m128MinX = _mm_set1_ps(vMinPos.x);
+	const __m128 m128MaxX = _mm_set1_ps(vMaxPos.x);
+	const __m128 m128MinZ = _mm_set1_ps(vMinPos.z);
+	const __m128 m128MaxZ = _mm_set1_ps(vMaxPos.z);
+	const __m128 m128OffsetX = _mm_set1_ps(vRenderScale.x * 0.5f);
+	const __m128 m128OffsetZ = _mm_set1_ps(vRenderScale.z * 0.5f);
+	const __m128 m128ColsPerUnit = _mm_set1_ps(fColsPerUnit);
+	const __m128 m128RowsPerUnit = _mm_set1_ps(fRowsPerUnit);
+	const __m128 m128MaxCol = _mm_set1_ps(float(iCols - 2));
+	const __m128 m128MaxRow = _mm_set1_ps(float(iRows - 2));
+	const __m128 m128NumOfCols = _mm_set1_ps(float(iCols));
+	const __m128 m128HeightScale = _mm_set1_ps(vRenderScale.y);
+	const __m128 m128Zero = _mm_setzero_ps();
+	int iIndices[4];
+	for (; i + 4 <= uiNumOfPositions; i += 4)
 	{
-		// Calculate the raw indices for these coordinates
-		fRow = ((fZ - (vRenderScale.z * -0.5f)) / vRenderScale.z) * iRows;
-		// Calculate the indices for these coordinates
-		iRow = (int)floor(fRow);
+		const __m128 m128X = _mm_loadu_ps(&pfX[i]);
+		const __m128 m128Z = _mm_loadu_ps(&pfZ[i]);
+		const __m128 m128Inside = _mm_and_ps(
+			_mm_and_ps(_mm_cmpge_ps(m128X, m128MinX), _mm_cmplt_ps(m128X, m128MaxX)),
+			_mm_and_ps(_mm_cmpge_ps(m128Z, m128MinZ), _mm_cmplt_ps(m128Z, m128MaxZ)));
+
+		// Calculate the raw indices, and keep the 4 samples of every coordinate inside the heightmap.
+		// The indices are not negative after the clamping, so the truncation is the same as the floor.
+		const __m128 m128Col = _mm_max_ps(_mm_mul_ps(_mm_add_ps(m128X, m128OffsetX), m128ColsPerUnit), m128Zero);
+		const __m128 m128Row = _mm_max_ps(_mm_mul_ps(_mm_add_ps(m128Z, m128OffsetZ), m128RowsPerUnit), m128Zero);
+		const __m128 m128FloorCol = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(m128Col, m128MaxCol)));
+		const __m128 m128FloorRow = _mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_min_ps(m128Row, m128MaxRow)));
+		_mm_storeu_si128((__m128i*)iIndices, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(m128FloorRow, m128NumOfCols), m128FloorCol)));
+
+		// Gather the 4 samples around each coordinate
+		const float* pfSamples0 = &vHeights[iIndices[0]];
+		const float* pfSamples1 = &vHeights[iIndices[1]];
+		const float* pfSamples2 = &vHeights[iIndices[2]];
+		const float* pfSamples3 = &vHeights[iIndices[3]];
+		const __m128 m128Sample00 = _mm_setr_ps(pfSamples0[0], pfSamples1[0], pfSamples2[0], pfSamples3[0]);
+		const __m128 m128Sample01 = _mm_setr_ps(pfSamples0[1], pfSamples1[1], pfSamples2[1], pfSamples3[1]);
+		const __m128 m128Sample10 = _mm_setr_ps(pfSamples0[iCols], pfSamples1[iCols], pfSamples2[iCols], pfSamples3[iCols]);
+		const __m128 m128Sample11 = _mm_setr_ps(pfSamples0[iCols + 1], pfSamples1[iCols + 1], pfSamples2[iCols + 1], pfSamples3[iCols + 1]);
+
+		// Use Bilinear interpolation of the 4 samples
+		const __m128 m128TCol = _mm_sub_ps(m128Col, m128FloorCol);
+		const __m128 m128TRow = _mm_sub_ps(m128Row, m128FloorRow);
+		const __m128 m128Top = _mm_add_ps(m128Sample00, _mm_mul_ps(_mm_sub_ps(m128Sample01, m128Sample00), m128TCol));
+		const __m128 m128Bottom = _mm_add_ps(m128Sample10, _mm_mul_ps(_mm_sub_ps(m128Sample11, m128Sample10), m128TCol));
+		const __m128 m128Height = _mm_mul_ps(m128HeightScale, _mm_add_ps(m128Top, _mm_mul_ps(_mm_sub_ps(m128Bottom, m128Top), m128TRow)));
+		_mm_storeu_ps(&pfHeights[i], _mm_and_ps(m128Inside, m128Height));
 	}
+#endif
 
-	// If it is out of the boundary, then return 0.0f
-	if (((fX < vMinPos.x) || (fX >= vMaxPos.x)) ||
-		((fZ < vMinPos.z) || (fZ >= vMaxPos.z)))
-		return 0.0f;
-
-	//// Calculate the raw indices for these coordinates
-	//float fCol = ((fX - (vRenderScale.x * -0.5f)) / vRenderScale.x) * iCols;
-	//float fRow = ((fZ - (vRenderScale.z * -0.5f)) / vRenderScale.z) * iRows;
-
-	//// Calculate the indices for these coordinates
-	//int iCol = (int)floor(fCol);
-	//int iRow = (int)floor(fRow);
-
-	// Use Bilinear interpolation of the surrounding 4 indices to smooth out the height
-	float fTX = fRow - iRow;
-	float fTZ = fCol - iCol;
-	float fSampleH1 = vVertexData[iRow][iCol].y;
-	float fSampleH2 = vVertexData[iRow + 1][iCol].y;
-	float fSampleH3 = vVertexData[iRow][iCol + 1].y;
-	float fSampleH4 = vVertexData[iRow + 1][iCol + 1].y;
-	float fFinalHeight = (fSampleH1 * (1.0f - fTX) + fSampleH2 * fTX) * (1.0f - fTZ) +
-		(fSampleH3 * (1.0f - fTX) + fSampleH4 * fTX) * (fTZ);
-
-	return vRenderScale.y * fFinalHeight;
+	// Get the remaining heights with the scalar instructions
+	for (; i < uiNumOfPositions; i++)
+		pfHeights[i] = GetHeight(pfX[i], pfZ[i]);
 }
 
 /**
@@ -512,6 +565,105 @@ glm::vec3 CTerrain::GetMaxPos(void) const
 	return vMaxPos;
 }
 
+/**
+ @brief Set if the chunks further away from the camera are drawn with less detail
+ @param bLODEnabled A const bool variable which is true to draw the chunks with less detail, or false to draw them at full detail
+ */
+void CTerrain::SetLODEnabled(const bool bLODEnabled)
+{
+	this->bLODEnabled = bLODEnabled;
+}
+
+/**
+ @brief Check if the chunks further away from the camera are drawn with less detail
+ @return A bool variable
+ */
+bool CTerrain::IsLODEnabled(void) const
+{
+	return bLODEnabled;
+}
+
+/**
+ @brief Set if the terrain is drawn with one grid patch which is displaced by a height texture in the vertex shader,
+		instead of storing every vertex of the heightmap. The buffers are created again if the heightmap is loaded.
+ @param bGPUDisplacementEnabled A const bool variable which is true to displace the grid patch, or false to store every vertex
+ */
+void CTerrain::SetGPUDisplacementEnabled(const bool bGPUDisplacementEnabled)
+{
+	if (this->bGPUDisplacementEnabled == bGPUDisplacementEnabled)
+		return;
+
+	this->bGPUDisplacementEnabled = bGPUDisplacementEnabled;
+	if (bLoaded)
+	{
+		ReleaseBuffers();
+		CreateBuffers();
+	}
+}
+
+/**
+ @brief Check if the terrain is drawn with one grid patch which is displaced by a height texture in the vertex shader
+ @return A bool variable
+ */
+bool CTerrain::IsGPUDisplacementEnabled(void) const
+{
+	return bGPUDisplacementEnabled;
+}
+
+/**
+ @brief Set the distance from the camera where the chunks start to lose detail
+ @param fLODDistance A const float variable containing the distance
+ */
+void CTerrain::SetLODDistance(const float fLODDistance)
+{
+	this->fLODDistance = fLODDistance;
+}
+
+/**
+ @brief Get the distance from the camera where the chunks start to lose detail
+ @return A float variable
+ */
+float CTerrain::GetLODDistance(void) const
+{
+	return fLODDistance;
+}
+
+/**
+ @brief Get the number of chunks
+ @return A unsigned int variable
+ */
+unsigned int CTerrain::GetNumOfChunks(void) const
+{
+	return (unsigned int)vChunks.size();
+}
+
+/**
+ @brief Get the number of chunks which were drawn in the last Render
+ @return A unsigned int variable
+ */
+unsigned int CTerrain::GetNumOfVisibleChunks(void) const
+{
+	return uiNumOfVisibleChunks;
+}
+
+/**
+ @brief Get the number of vertices which were drawn in the last Render
+ @return A unsigned int variable
+ */
+unsigned int CTerrain::GetNumOfVertices(void) const
+{
+	return uiNumOfVertices;
+}
+
+/**
+ @brief Get the number of vertices which the last Render would have drawn at full detail
+ @return A unsigned int variable
+ */
+unsigned int CTerrain::GetNumOfFullDetailVertices(void) const
+{
+	return uiNumOfFullDetailVertices;
+}
+
 /**
  @brief Print Self
  */
@@ -519,4 +671,501 @@ void CTerrain::PrintSelf(void)
 {
 	cout << "CTerrain::PrintSelf()" << endl;
 	cout << "========================" << endl;
+	cout << "Chunks: " << uiNumOfVisibleChunks << " visible out of " << vChunks.size() << endl;
+	cout << "Level of detail: " << (bLODEnabled ? "on" : "off") << ", starting at a distance of " << fLODDistance << endl;
+	cout << "Render path: " << (bGPUDisplacementEnabled ? "grid patch displaced by the height texture" : "vertex buffer of the heightmap") << endl;
+	cout << "Vertices: " << uiNumOfVertices << " drawn, " << uiNumOfFullDetailVertices << " at full detail";
+	if (uiNumOfFullDetailVertices > 0)
+		cout << " (" << (100.0f * uiNumOfVertices / uiNumOfFullDetailVertices) << "%)";
+	cout << ", " << iRows * iCols << " in the heightmap" << endl;
+}
+
+/**
+ @brief Create the VAO, the vertex and index buffers and the height texture of the current render path.
+		With the GPU displacement, the vertex buffer only has one grid patch of the size of a chunk, which
+		is drawn for every chunk and displaced by the height texture in the vertex shader. Otherwise, the
+		vertex buffer has the positions, texture coordinates and normals of every vertex of the heightmap.
+ */
+void CTerrain::CreateBuffers(void)
+{
+	// Create a VBO with heightmap indices, which are grouped into chunks
+	BuildChunks();
+
+	glGenVertexArrays(1, &uiVAO);
+	glBindVertexArray(uiVAO);
+	vboHeightmapData.CreateVBO();
+	vboHeightmapData.BindVBO();
+
+	if (bGPUDisplacementEnabled)
+	{
+		// The grid patch only has the column and row of each vertex in the chunk
+		vector<glm::vec2> vPatch((iChunkSize + 1) * (iChunkSize + 1));
+		for (int i = 0; i <= iChunkSize; i++)
+			for (int j = 0; j <= iChunkSize; j++)
+				vPatch[i * (iChunkSize + 1) + j] = glm::vec2(float(j), float(i));
+		vboHeightmapData.UploadDataToGPU(&vPatch[0], (unsigned int)(vPatch.size() * sizeof(glm::vec2)), GL_STATIC_DRAW);
+
+		// Grid coordinates
+		glEnableVertexAttribArray(3);
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), 0);
+
+		// The heights are read with texelFetch, so they are not filtered
+		glGenTextures(1, &uiHeightTextureID);
+		glBindTexture(GL_TEXTURE_2D, uiHeightTextureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, iCols, iRows, 0, GL_RED, GL_FLOAT, &vHeights[0]);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+	else
+	{
+		// Build all the vertices in one pass, since the normals only need the heights around each vertex
+		vector<SHeightmapVertex> vVertices(iRows * iCols);
+		CJobSystem::GetInstance()->ParallelFor((unsigned int)iRows, uiRowsPerJob,
+			[this, &vVertices](const unsigned int uiBegin, const unsigned int uiEnd)
+		{
+			for (int i = (int)uiBegin; i < (int)uiEnd; i++)
+				BuildVertices(i, 0, iCols - 1, &vVertices[i * iCols]);
+		});
+		// The vertices are uploaded without copying them into the VBO first
+		vboHeightmapData.UploadDataToGPU(&vVertices[0], (unsigned int)(vVertices.size() * sizeof(SHeightmapVertex)), GL_STATIC_DRAW);
+
+		// Vertex positions
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SHeightmapVertex), (void*)offsetof(SHeightmapVertex, vec3Position));
+		// Texture coordinates
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SHeightmapVertex), (void*)offsetof(SHeightmapVertex, vec2TexCoord));
+		// Normal vectors
+		glEnableVertexAttribArray(2);
+		glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(SHeightmapVertex), (void*)offsetof(SHeightmapVertex, vec3Normal));
+	}
+
+	// And now attach index data to this VAO
+	// Here don't forget to bind another type of VBO - the element array buffer, or simplier indices to vertices
+	vboHeightmapIndices.BindVBO(GL_ELEMENT_ARRAY_BUFFER);
+	vboHeightmapIndices.UploadDataToGPU(GL_STATIC_DRAW);
+	vboHeightmapData.BindVBO();
+
+	glBindVertexArray(0);
+}
+
+/**
+ @brief Release the VAO, the vertex and index buffers and the height texture
+ */
+void CTerrain::ReleaseBuffers(void)
+{
+	vboHeightmapData.DeleteVBO();
+	vboHeightmapIndices.DeleteVBO();
+
+	if (uiHeightTextureID != 0)
+	{
+		glDeleteTextures(1, &uiHeightTextureID);
+		uiHeightTextureID = 0;
+	}
+
+	glDeleteVertexArrays(1, &uiVAO);
+	uiVAO = 0;
+}
+
+/**
+ @brief Raise, lower or flatten the terrain in a radius. The heights fall off smoothly from the centre to the radius.
+		Only the vertices or the part of the height texture around the radius are updated on the GPU.
+ @param eDeformation A const DEFORMATION variable containing how the terrain is changed
+ @param fX A const float variable containing the x coordinate of the centre
+ @param fZ A const float variable containing the z coordinate of the centre
+ @param fRadius A const float variable containing the radius
+ @param fStrength A const float variable containing the height to raise or lower the centre by,
+		or the fraction from 0.0 to 1.0 to flatten the centre by towards its height
+ @return A bool variable which is false if no part of the terrain is in the radius
+ */
+bool CTerrain::Deform(const DEFORMATION eDeformation, const float fX, const float fZ, const float fRadius, const float fStrength)
+{
+	if ((bLoaded == false) || !(fRadius > 0.0f) || std::isnan(fX) || std::isnan(fZ) || (vRenderScale.y <= 0.0f))
+		return false;
+
+	// Find the columns and rows of the vertices in the radius, in the same way as GetHeight
+	const float fCentreCol = (fX + vRenderScale.x * 0.5f) * fColsPerUnit;
+	const float fCentreRow = (fZ + vRenderScale.z * 0.5f) * fRowsPerUnit;
+	const int iFirstCol = (int)max(ceil(fCentreCol - fRadius * fColsPerUnit), 0.0f);
+	const int iLastCol = (int)min(floor(fCentreCol + fRadius * fColsPerUnit), float(iCols - 1));
+	const int iFirstRow = (int)max(ceil(fCentreRow - fRadius * fRowsPerUnit), 0.0f);
+	const int iLastRow = (int)min(floor(fCentreRow + fRadius * fRowsPerUnit), float(iRows - 1));
+	if ((iFirstCol > iLastCol) || (iFirstRow > iLastRow))
+		return false;
+
+	// The heights are stored from 0.0 to 1.0, so the strength is scaled down to them
+	const float fHeightChange = fStrength / vRenderScale.y;
+	const float fFlattenHeight = GetHeight(fX, fZ) / vRenderScale.y;
+	const float fFlattenFraction = min(max(fStrength, 0.0f), 1.0f);
+	for (int i = iFirstRow; i <= iLastRow; i++)
+	{
+		for (int j = iFirstCol; j <= iLastCol; j++)
+		{
+			const float fDistanceX = (float(j) - fCentreCol) / fColsPerUnit;
+			const float fDistanceZ = (float(i) - fCentreRow) / fRowsPerUnit;
+			float fFalloff = 1.0f - (fDistanceX * fDistanceX + fDistanceZ * fDistanceZ) / (fRadius * fRadius);
+			if (fFalloff <= 0.0f)
+				continue;
+			fFalloff *= fFalloff;
+
+			float& fHeight = vHeights[i * iCols + j];
+			if (eDeformation == DEFORMATION::RAISE)
+				fHeight += fHeightChange * fFalloff;
+			else if (eDeformation == DEFORMATION::LOWER)
+				fHeight -= fHeightChange * fFalloff;
+			else
+				fHeight += (fFlattenHeight - fHeight) * fFlattenFraction * fFalloff;
+			fHeight = min(max(fHeight, 0.0f), 1.0f);
+		}
+	}
+
+	UpdateRegion(iFirstRow, iLastRow, iFirstCol, iLastCol);
+
+	return true;
+}
+
+/**
+ @brief Update the chunk bounds and the GPU copy of the heights after the heights in a region were changed.
+		The normals of the vertices next to the region are changed too, so the vertices are updated one vertex further.
+ @param iFirstRow A const int variable containing the first row which was changed
+ @param iLastRow A const int variable containing the last row which was changed
+ @param iFirstCol A const int variable containing the first column which was changed
+ @param iLastCol A const int variable containing the last column which was changed
+ */
+void CTerrain::UpdateRegion(const int iFirstRow, const int iLastRow, const int iFirstCol, const int iLastCol)
+{
+	// The vertices on the edges of a chunk are shared with the next chunk
+	const int iFirstChunkRow = max(iFirstRow - 1, 0) / iChunkSize;
+	const int iLastChunkRow = min(iLastRow / iChunkSize, iNumOfChunkRows - 1);
+	const int iFirstChunkCol = max(iFirstCol - 1, 0) / iChunkSize;
+	const int iLastChunkCol = min(iLastCol / iChunkSize, iNumOfChunkCols - 1);
+	for (int iChunkRow = iFirstChunkRow; iChunkRow <= iLastChunkRow; iChunkRow++)
+		for (int iChunkCol = iFirstChunkCol; iChunkCol <= iLastChunkCol; iChunkCol++)
+			UpdateChunkBounds(iChunkRow, iChunkCol);
+
+	if (bGPUDisplacementEnabled)
+	{
+		// Copy the region of the heights into the height texture. The normals are calculated by the vertex shader.
+		glBindTexture(GL_TEXTURE_2D, uiHeightTextureID);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, iCols);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, iFirstCol, iFirstRow, iLastCol - iFirstCol + 1, iLastRow - iFirstRow + 1,
+						GL_RED, GL_FLOAT, &vHeights[iFirstRow * iCols + iFirstCol]);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return;
+	}
+
+	const int iFirstVertexRow = max(iFirstRow - 1, 0);
+	const int iLastVertexRow = min(iLastRow + 1, iRows - 1);
+	const int iFirstVertexCol = max(iFirstCol - 1, 0);
+	const int iLastVertexCol = min(iLastCol + 1, iCols - 1);
+	const int iNumOfVertexCols = iLastVertexCol - iFirstVertexCol + 1;
+
+	vector<SHeightmapVertex> vVertices((iLastVertexRow - iFirstVertexRow + 1) * iNumOfVertexCols);
+	for (int i = iFirstVertexRow; i <= iLastVertexRow; i++)
+		BuildVertices(i, iFirstVertexCol, iLastVertexCol, &vVertices[(i - iFirstVertexRow) * iNumOfVertexCols]);
+
+	vboHeightmapData.BindVBO();
+	if (iNumOfVertexCols == iCols)
+	{
+		// The rows are next to each other in the VBO, so they are updated together
+		vboHeightmapData.UpdateDataOnGPU(&vVertices[0], (unsigned int)(iFirstVertexRow * iCols * sizeof(SHeightmapVertex)),
+										 (unsigned int)(vVertices.size() * sizeof(SHeightmapVertex)));
+	}
+	else
+	{
+		for (int i = iFirstVertexRow; i <= iLastVertexRow; i++)
+		{
+			vboHeightmapData.UpdateDataOnGPU(&vVertices[(i - iFirstVertexRow) * iNumOfVertexCols],
+											 (unsigned int)((i * iCols + iFirstVertexCol) * sizeof(SHeightmapVertex)),
+											 (unsigned int)(iNumOfVertexCols * sizeof(SHeightmapVertex)));
+		}
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/**
+ @brief Find the lowest and highest heights of a chunk for its bounds
+ @param iChunkRow A const int variable containing the row of the chunk
+ @param iChunkCol A const int variable containing the column of the chunk
+ */
+void CTerrain::UpdateChunkBounds(const int iChunkRow, const int iChunkCol)
+{
+	SChunk& sChunk = vChunks[iChunkRow * iNumOfChunkCols + iChunkCol];
+	const int iStartRow = iChunkRow * iChunkSize;
+	const int iEndRow = iStartRow + sChunk.iNumOfRows;
+	const int iStartCol = iChunkCol * iChunkSize;
+	const int iEndCol = iStartCol + sChunk.iNumOfCols;
+
+	// The x- and z-coordinates are set by the corners, so find the lowest and highest heights
+	sChunk.vec3BoundsMin = glm::vec3(-0.5f + float(iStartCol) / float(iCols - 1),
+									 vHeights[iStartRow * iCols + iStartCol],
+									 -0.5f + float(iStartRow) / float(iRows - 1));
+	sChunk.vec3BoundsMax = glm::vec3(-0.5f + float(iEndCol) / float(iCols - 1),
+									 sChunk.vec3BoundsMin.y,
+									 -0.5f + float(iEndRow) / float(iRows - 1));
+	for (int i = iStartRow; i <= iEndRow; i++)
+		for (int j = iStartCol; j <= iEndCol; j++)
+		{
+			sChunk.vec3BoundsMin.y = min(sChunk.vec3BoundsMin.y, vHeights[i * iCols + j]);
+			sChunk.vec3BoundsMax.y = max(sChunk.vec3BoundsMax.y, vHeights[i * iCols + j]);
+		}
+}
+
+/**
+ @brief Build the vertices of a row of the heightmap from the heights. The normals are calculated from
+		the central differences of the heights around each vertex, or the one-sided differences on the edges.
+ @param iRow A const int variable containing the row to build
+ @param iFirstCol A const int variable containing the first column to build
+ @param iLastCol A const int variable containing the last column to build
+ @param pVertices A SHeightmapVertex* variable to store the vertices from iFirstCol to iLastCol
+ */
+void CTerrain::BuildVertices(const int iRow, const int iFirstCol, const int iLastCol, SHeightmapVertex* pVertices) const
+{
+	const float fTextureU = float(iCols) * 0.1f;
+	const float fTextureV = float(iRows) * 0.1f;
+	// The distance between 2 vertices along the x- and z-axes, before the heightmap is scaled
+	const float fStepX = 1.0f / float(iCols - 1);
+	const float fStepZ = 1.0f / float(iRows - 1);
+
+	const int iRowUp = max(iRow - 1, 0);
+	const int iRowDown = min(iRow + 1, iRows - 1);
+	const float fScaleR = float(iRow) / float(iRows - 1);
+	for (int j = iFirstCol; j <= iLastCol; j++, pVertices++)
+	{
+		const int iColLeft = max(j - 1, 0);
+		const int iColRight = min(j + 1, iCols - 1);
+		const float fScaleC = float(j) / float(iCols - 1);
+
+		pVertices->vec3Position = glm::vec3(-0.5f + fScaleC, vHeights[iRow * iCols + j], -0.5f + fScaleR);
+		pVertices->vec2TexCoord = glm::vec2(fTextureU * fScaleC, fTextureV * fScaleR);
+
+		// The normal is perpendicular to the slopes along the x- and z-axes
+		float fSlopeX = (vHeights[iRow * iCols + iColRight] - vHeights[iRow * iCols + iColLeft]) / (fStepX * (iColRight - iColLeft));
+		float fSlopeZ = (vHeights[iRowDown * iCols + j] - vHeights[iRowUp * iCols + j]) / (fStepZ * (iRowDown - iRowUp));
+		pVertices->vec3Normal = glm::normalize(glm::vec3(-fSlopeX, 1.0f, -fSlopeZ));
+	}
+}
+
+/**
+ @brief Update the number of rows and columns in each unit after the size of the heightmap or the render size is changed
+ */
+void CTerrain::UpdateHeightScales(void)
+{
+	fColsPerUnit = (vRenderScale.x > 0.0f) ? float(iCols - 1) / vRenderScale.x : 0.0f;
+	fRowsPerUnit = (vRenderScale.z > 0.0f) ? float(iRows - 1) / vRenderScale.z : 0.0f;
+}
+
+/**
+ @brief Create the index buffer and the bounds of the chunks. The heightmap is split into squares of
+		iChunkSize quads. The triangles of each chunk size are built once for every level of detail and
+		every stitching of the edges. They are indexed from the top-left vertex of a chunk, so that all
+		the chunks of the same size share them through their base vertex.
+ */
+void CTerrain::BuildChunks(void)
+{
+	vChunks.clear();
+	vPatterns.clear();
+
+	iNumOfChunkCols = (iCols - 2) / iChunkSize + 1;
+	iNumOfChunkRows = (iRows - 2) / iChunkSize + 1;
+
+	// The chunk sizes which have their patterns, and the first of their patterns
+	vector<glm::ivec2> vPatternSizes;
+	vector<unsigned int> vFirstPatterns;
+	vector<GLuint> vIndices;
+	// The number of vertices in each row of the vertex buffer, which the indices are built with
+	const int iVertexStride = (bGPUDisplacementEnabled ? iChunkSize + 1 : iCols);
+
+	for (int iChunkRow = 0; iChunkRow < iNumOfChunkRows; iChunkRow++)
+	{
+		int iStartRow = iChunkRow * iChunkSize;
+		int iEndRow = min(iStartRow + iChunkSize, iRows - 1);
+		for (int iChunkCol = 0; iChunkCol < iNumOfChunkCols; iChunkCol++)
+		{
+			int iStartCol = iChunkCol * iChunkSize;
+			int iEndCol = min(iStartCol + iChunkSize, iCols - 1);
+
+			SChunk sChunk;
+			sChunk.iNumOfCols = iEndCol - iStartCol;
+			sChunk.iNumOfRows = iEndRow - iStartRow;
+			sChunk.iBaseVertex = iStartRow * iCols + iStartCol;
+			sChunk.iLOD = 0;
+
+			// The detail can only be lowered while the step between the vertices divides the size of the chunk.
+			// The chunks on the far edges of a heightmap which is not 2^n+1 vertices wide may stay at full detail.
+			sChunk.iMaxLOD = 0;
+			while ((sChunk.iMaxLOD < iNumOfLODs - 1) &&
+				   (sChunk.iNumOfCols % (2 << sChunk.iMaxLOD) == 0) &&
+				   (sChunk.iNumOfRows % (2 << sChunk.iMaxLOD) == 0))
+				sChunk.iMaxLOD++;
+
+			// Build the patterns of this chunk size if no other chunk has this size
+			glm::ivec2 vec2Size(sChunk.iNumOfCols, sChunk.iNumOfRows);
+			unsigned int uiSize = 0;
+			while ((uiSize < vPatternSizes.size()) &&
+				   ((vPatternSizes[uiSize].x != vec2Size.x) || (vPatternSizes[uiSize].y != vec2Size.y)))
+				uiSize++;
+			if (uiSize == vPatternSizes.size())
+			{
+				vPatternSizes.push_back(vec2Size);
+				vFirstPatterns.push_back((unsigned int)vPatterns.size());
+				for (int iLOD = 0; iLOD < iNumOfLODs; iLOD++)
+				{
+					for (unsigned int uiStitches = 0; uiStitches < NUM_STITCHES; uiStitches++)
+					{
+						SPattern sPattern;
+						sPattern.uiFirstIndex = (unsigned int)vIndices.size();
+						if (iLOD <= sChunk.iMaxLOD)
+							BuildPattern(sChunk.iNumOfCols, sChunk.iNumOfRows, iLOD, uiStitches, iVertexStride, vIndices);
+						sPattern.iNumOfIndices = (int)(vIndices.size() - sPattern.uiFirstIndex);
+						vPatterns.push_back(sPattern);
+					}
+				}
+			}
+			sChunk.uiFirstPattern = vFirstPatterns[uiSize];
+
+			vChunks.push_back(sChunk);
+			UpdateChunkBounds(iChunkRow, iChunkCol);
+		}
+	}
+
+	// A heightmap which is less than 2 vertices wide or long has no triangles
+	vboHeightmapIndices.CreateVBO();
+	if (vIndices.empty() == false)
+		vboHeightmapIndices.AddData(&vIndices[0], (unsigned int)(vIndices.size() * sizeof(GLuint)));
+}
+
+/**
+ @brief Add the triangles of a chunk size at a level of detail to an index buffer. The vertices are
+		2^iLOD quads apart. On a stitched edge, every other vertex is moved onto the previous vertex of
+		the neighbour with less detail, so the triangles along that edge become a fan with no cracks.
+ @param iNumOfCols A const int variable containing the number of quads along the x-axis of the chunk
+ @param iNumOfRows A const int variable containing the number of quads along the z-axis of the chunk
+ @param iLOD A const int variable containing the level of detail
+ @param uiStitches A const unsigned int variable containing the STITCH flags of the edges to stitch
+ @param iVertexStride A const int variable containing the number of vertices in each row of the vertex buffer
+ @param vIndices A vector<GLuint>& variable which the indices are added to. They are relative to the top-left vertex of the chunk.
+ */
+void CTerrain::BuildPattern(const int iNumOfCols, const int iNumOfRows, const int iLOD, const unsigned int uiStitches, const int iVertexStride, vector<GLuint>& vIndices) const
+{
+	const int iStep = 1 << iLOD;
+	for (int iRow = 0; iRow < iNumOfRows; iRow += iStep)
+	{
+		for (int iCol = 0; iCol < iNumOfCols; iCol += iStep)
+		{
+			// The row and column of the corners of this quad, in the same order as the triangle strips before
+			glm::ivec2 vCorners[4] =
+			{
+				glm::ivec2(iRow, iCol),
+				glm::ivec2(iRow + iStep, iCol),
+				glm::ivec2(iRow, iCol + iStep),
+				glm::ivec2(iRow + iStep, iCol + iStep)
+			};
+			for (int i = 0; i < 4; i++)
+			{
+				if (((vCorners[i].x == 0) && (uiStitches & STITCH_TOP)) ||
+					((vCorners[i].x == iNumOfRows) && (uiStitches & STITCH_BOTTOM)))
+					vCorners[i].y -= vCorners[i].y % (iStep * 2);
+				if (((vCorners[i].y == 0) && (uiStitches & STITCH_LEFT)) ||
+					((vCorners[i].y == iNumOfCols) && (uiStitches & STITCH_RIGHT)))
+					vCorners[i].x -= vCorners[i].x % (iStep * 2);
+			}
+
+			const int iTriangles[2][3] = { { 0, 1, 2 }, { 2, 1, 3 } };
+			for (int i = 0; i < 2; i++)
+			{
+				const glm::ivec2& vA = vCorners[iTriangles[i][0]];
+				const glm::ivec2& vB = vCorners[iTriangles[i][1]];
+				const glm::ivec2& vC = vCorners[iTriangles[i][2]];
+				// Skip the triangles which were collapsed by the stitching. The triangles which became flat
+				// along the x- and z-axes are kept, since they still fill the gap between different heights.
+				if ((vA == vB) || (vB == vC) || (vC == vA))
+					continue;
+
+				for (int j = 0; j < 3; j++)
+					vIndices.push_back(vCorners[iTriangles[i][j]].x * iVertexStride + vCorners[iTriangles[i][j]].y);
+			}
+		}
+	}
+}
+
+/**
+ @brief Select the level of detail of every chunk from its distance to the camera.
+		The detail halves every time the distance doubles after fLODDistance, and neighbouring
+		chunks are kept within one level of each other so that their edges can be stitched.
+ @param vec3CameraPosition A const glm::vec3& variable containing the position of the camera
+ */
+void CTerrain::SelectLODs(const glm::vec3& vec3CameraPosition)
+{
+	for (unsigned int i = 0; i < vChunks.size(); i++)
+	{
+		vChunks[i].iLOD = 0;
+		if (bLODEnabled == false)
+			continue;
+
+		// Find the distance from the camera to the nearest point of the chunk
+		glm::vec3 vec3BoundsMin = vec3Position + vRenderScale * vChunks[i].vec3BoundsMin;
+		glm::vec3 vec3BoundsMax = vec3Position + vRenderScale * vChunks[i].vec3BoundsMax;
+		float fDistance = glm::length(vec3CameraPosition - glm::clamp(vec3CameraPosition, vec3BoundsMin, vec3BoundsMax));
+
+		float fLODEnd = fLODDistance;
+		while ((vChunks[i].iLOD < vChunks[i].iMaxLOD) && (fDistance > fLODEnd))
+		{
+			vChunks[i].iLOD++;
+			fLODEnd *= 2.0f;
+		}
+	}
+
+	// Raise the detail of the chunks which have more than one level less than a neighbour, until no chunk has
+	bool bChanged = bLODEnabled;
+	while (bChanged)
+	{
+		bChanged = false;
+		for (int iChunkRow = 0; iChunkRow < iNumOfChunkRows; iChunkRow++)
+		{
+			for (int iChunkCol = 0; iChunkCol < iNumOfChunkCols; iChunkCol++)
+			{
+				int& iLOD = vChunks[iChunkRow * iNumOfChunkCols + iChunkCol].iLOD;
+				int iMaxLOD = iLOD;
+				if (iChunkRow > 0)
+					iMaxLOD = min(iMaxLOD, vChunks[(iChunkRow - 1) * iNumOfChunkCols + iChunkCol].iLOD + 1);
+				if (iChunkRow < iNumOfChunkRows - 1)
+					iMaxLOD = min(iMaxLOD, vChunks[(iChunkRow + 1) * iNumOfChunkCols + iChunkCol].iLOD + 1);
+				if (iChunkCol > 0)
+					iMaxLOD = min(iMaxLOD, vChunks[iChunkRow * iNumOfChunkCols + iChunkCol - 1].iLOD + 1);
+				if (iChunkCol < iNumOfChunkCols - 1)
+					iMaxLOD = min(iMaxLOD, vChunks[iChunkRow * iNumOfChunkCols + iChunkCol + 1].iLOD + 1);
+				if (iMaxLOD < iLOD)
+				{
+					iLOD = iMaxLOD;
+					bChanged = true;
+				}
+			}
+		}
+	}
+}
+
+/**
+ @brief Get the edges of a chunk which are next to a chunk with less detail
+ @param iChunkRow A const int variable containing the row of the chunk
+ @param iChunkCol A const int variable containing the column of the chunk
+ @return A unsigned int variable containing the STITCH flags of the edges
+ */
+unsigned int CTerrain::GetStitches(const int iChunkRow, const int iChunkCol) const
+{
+	const int iLOD = vChunks[iChunkRow * iNumOfChunkCols + iChunkCol].iLOD;
+	unsigned int uiStitches = 0;
+	if ((iChunkRow > 0) && (vChunks[(iChunkRow - 1) * iNumOfChunkCols + iChunkCol].iLOD > iLOD))
+		uiStitches |= STITCH_TOP;
+	if ((iChunkRow < iNumOfChunkRows - 1) && (vChunks[(iChunkRow + 1) * iNumOfChunkCols + iChunkCol].iLOD > iLOD))
+		uiStitches |= STITCH_BOTTOM;
+	if ((iChunkCol > 0) && (vChunks[iChunkRow * iNumOfChunkCols + iChunkCol - 1].iLOD > iLOD))
+		uiStitches |= STITCH_LEFT;
+	if ((iChunkCol < iNumOfChunkCols - 1) && (vChunks[iChunkRow * iNumOfChunkCols + iChunkCol + 1].iLOD > iLOD))
+		uiStitches |= STITCH_RIGHT;
+	return uiStitches;
 }
\ No newline at end of file
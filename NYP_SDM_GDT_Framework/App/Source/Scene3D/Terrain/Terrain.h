@@ -16,6 +16,9 @@ Date: Sep 2021
 
 #include "vertexBufferObject.h"
 
+// Include FrustumCulling
+#include "../SpatialPartition/FrustumCulling.h"
+
 // Include GLM
 #include <includes/glm.hpp>
 #include <includes/gtc/matrix_transform.hpp>
@@ -24,10 +27,26 @@ Date: Sep 2021
 #include <string>
 using namespace std;
 
+// Select the widest SIMD instruction set which the compiler is targeting
+#if defined(__AVX2__)
+	#define TERRAIN_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define TERRAIN_SSE2
+#endif
+
 class CTerrain : /*public CSingletonTemplate<CTerrain>,*/ public CEntity3D
 {
 //	friend CSingletonTemplate<CTerrain>;
 public:
+	// The ways to change the heights of the terrain in a radius
+	enum class DEFORMATION : unsigned int
+	{
+		RAISE = 0,
+		LOWER,
+		FLATTEN,
+		NUM_DEFORMATIONS
+	};
+
 	// Constructor
 	CTerrain(void);
 	// Destructor
@@ -58,16 +77,92 @@ public:
 	// Get Height Map columns
 	int GetNumHeightmapCols(void) const;
 	// Get the height at a X- and Z-coordinate
-	float GetHeight(const float fX, const float fZ);
+	float GetHeight(const float fX, const float fZ) const;
+	// Get the heights at a batch of X- and Z-coordinates
+	void GetHeights(const float* pfX, const float* pfZ, float* pfHeights, const unsigned int uiNumOfPositions) const;
 	// Get the vMinPos
 	glm::vec3 GetMinPos(void) const;
 	// Get the vMaxPos
 	glm::vec3 GetMaxPos(void) const;
 
+	// Raise, lower or flatten the terrain in a radius
+	bool Deform(const DEFORMATION eDeformation, const float fX, const float fZ, const float fRadius, const float fStrength);
+
+	// Set if the chunks further away from the camera are drawn with less detail
+	void SetLODEnabled(const bool bLODEnabled);
+	// Check if the chunks further away from the camera are drawn with less detail
+	bool IsLODEnabled(void) const;
+	// Set if the terrain is drawn with one grid patch which is displaced by a height texture in the vertex shader
+	void SetGPUDisplacementEnabled(const bool bGPUDisplacementEnabled);
+	// Check if the terrain is drawn with one grid patch which is displaced by a height texture in the vertex shader
+	bool IsGPUDisplacementEnabled(void) const;
+	// Set the distance from the camera where the chunks start to lose detail
+	void SetLODDistance(const float fLODDistance);
+	// Get the distance from the camera where the chunks start to lose detail
+	float GetLODDistance(void) const;
+
+	// Get the number of chunks
+	unsigned int GetNumOfChunks(void) const;
+	// Get the number of chunks which were drawn in the last Render
+	unsigned int GetNumOfVisibleChunks(void) const;
+	// Get the number of vertices which were drawn in the last Render
+	unsigned int GetNumOfVertices(void) const;
+	// Get the number of vertices which the last Render would have drawn at full detail
+	unsigned int GetNumOfFullDetailVertices(void) const;
+
 	// Print Self
 	void PrintSelf(void);
 
 protected:
+	// A square of the heightmap, which is culled against the frustum and has its own level of detail
+	struct SChunk
+	{
+		// The number of quads along each side of this chunk
+		int iNumOfCols, iNumOfRows;
+		// The index of the top-left vertex of this chunk, which is added to the indices of its patterns
+		int iBaseVertex;
+		// The first of the patterns which are used by chunks of this size
+		unsigned int uiFirstPattern;
+		// The lowest detail which the size of this chunk allows, and the level of detail of the current Render
+		int iMaxLOD;
+		int iLOD;
+		// The bounds of this chunk, before it is scaled to the render size and translated
+		glm::vec3 vec3BoundsMin, vec3BoundsMax;
+	};
+
+	// The triangles of a chunk size at one level of detail, with some of its edges stitched
+	struct SPattern
+	{
+		// The first index and the number of indices of this pattern in the index buffer
+		unsigned int uiFirstIndex;
+		int iNumOfIndices;
+	};
+
+	// A vertex of the heightmap, as it is interleaved in the VBO
+	struct SHeightmapVertex
+	{
+		glm::vec3 vec3Position;
+		glm::vec2 vec2TexCoord;
+		glm::vec3 vec3Normal;
+	};
+
+	// The edges of a chunk which are stitched to a neighbour with less detail
+	enum STITCH : unsigned int
+	{
+		STITCH_TOP = 1,
+		STITCH_BOTTOM = 2,
+		STITCH_LEFT = 4,
+		STITCH_RIGHT = 8,
+		NUM_STITCHES = 16
+	};
+
+	// The number of quads along each side of a chunk
+	static const int iChunkSize = 32;
+	// The number of levels of detail. The lowest detail draws a full size chunk as one quad.
+	static const int iNumOfLODs = 6;
+	// The number of heightmap rows which are built by each job
+	static const unsigned int uiRowsPerJob = 16;
+
 	unsigned int uiVAO;
 
 	bool bLoaded;
@@ -80,13 +175,66 @@ protected:
 	// The min and max positions for this terrain
 	glm::vec3 vMinPos, vMaxPos;
 
-	// The VBOs of the heightmap
+	// The VBOs of the heightmap. With the GPU displacement, vboHeightmapData only has one grid patch.
 	CVertexBufferObject vboHeightmapData;
 	// The indices for the VBOs of the heightmap
 	CVertexBufferObject vboHeightmapIndices;
-	// The raw vertex data
-	vector< vector< glm::vec3> > vVertexData;
-	// The raw coordinates data
-	vector< vector< glm::vec2> > vCoordsData;
+	// The heights of the heightmap from 0.0 to 1.0, row by row. They are scaled by vRenderScale.y when they are read.
+	vector<float> vHeights;
+	// The number of rows and columns of the heightmap in each unit along the z- and x-axes
+	float fRowsPerUnit, fColsPerUnit;
+
+	// The chunks of the heightmap, row by row, and the number of chunks in each row and column
+	vector<SChunk> vChunks;
+	int iNumOfChunkCols, iNumOfChunkRows;
+	// The patterns of every chunk size, level of detail and stitching
+	vector<SPattern> vPatterns;
+	// The frustum which the chunks are culled against. It is updated with the view and projection of each Render.
+	CFrustumCulling cFrustumCulling;
+	// The number of indices, the offsets and the base vertices of the visible chunks,
+	// which are drawn with one glMultiDrawElementsBaseVertex
+	vector<GLsizei> vDrawCounts;
+	vector<const void*> vDrawOffsets;
+	vector<GLint> vDrawBaseVertices;
+
+	// Indicate if the chunks further away from the camera are drawn with less detail
+	bool bLODEnabled;
+	// The distance from the camera where the chunks start to lose detail. The detail halves every time the distance doubles.
+	float fLODDistance;
+
+	// Indicate if the terrain is drawn with one grid patch which is displaced by the height texture in the vertex shader
+	bool bGPUDisplacementEnabled;
+	// The texture with the heights of the heightmap, which is only created for the GPU displacement
+	GLuint uiHeightTextureID;
+
+	// The number of chunks and vertices which were drawn in the last Render
+	unsigned int uiNumOfVisibleChunks;
+	unsigned int uiNumOfVertices;
+	// The number of vertices which the last Render would have drawn at full detail
+	unsigned int uiNumOfFullDetailVertices;
+
+	// Update the number of rows and columns in each unit after the size of the heightmap or the render size is changed
+	void UpdateHeightScales(void);
+
+	// Create the VAO, the vertex and index buffers and the height texture of the current render path
+	void CreateBuffers(void);
+	// Release the VAO, the vertex and index buffers and the height texture
+	void ReleaseBuffers(void);
+
+	// Build the vertices of a part of a row of the heightmap from the heights
+	void BuildVertices(const int iRow, const int iFirstCol, const int iLastCol, SHeightmapVertex* pVertices) const;
+	// Update the chunk bounds and the GPU copy of the heights after the heights in a region were changed
+	void UpdateRegion(const int iFirstRow, const int iLastRow, const int iFirstCol, const int iLastCol);
+	// Find the lowest and highest heights of a chunk for its bounds
+	void UpdateChunkBounds(const int iChunkRow, const int iChunkCol);
+
+	// Create the index buffer and the bounds of the chunks
+	void BuildChunks(void);
+	// Add the triangles of a chunk size at a level of detail to an index buffer
+	void BuildPattern(const int iNumOfCols, const int iNumOfRows, const int iLOD, const unsigned int uiStitches, const int iVertexStride, vector<GLuint>& vIndices) const;
+	// Select the level of detail of every chunk from its distance to the camera
+	void SelectLODs(const glm::vec3& vec3CameraPosition);
+	// Get the edges of a chunk which are next to a chunk with less detail
+	unsigned int GetStitches(const int iChunkRow, const int iChunkCol) const;
 
 };
\ No newline at end of file
@@ -7,6 +7,7 @@ Date: Nov 2022
 #include "TerrainManager.h"
 
 #include <vector>
+#include <stdio.h>
 
 using namespace std;
 
@@ -24,13 +25,20 @@ using namespace std;
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CSpatialPartition
+#include "../SpatialPartition/SpatialPartition.h"
+
 /**
  @brief Constructor
  */
 CTerrainManager::CTerrainManager(void)
 	: m_iIndex(0)
+	, uiMaxNumOfResident(2)
+	, uiUseCounter(0)
+	, bLODEnabled(true)
+	, bGPUDisplacementEnabled(false)
 {
-	terrainInstances.clear();
+	vTerrains.clear();
 }
 
 /**
@@ -38,11 +46,8 @@ CTerrainManager::CTerrainManager(void)
  */
 CTerrainManager::~CTerrainManager(void)
 {
-	for (unsigned int i = 0; i < terrainInstances.size(); i++)
-	{
-		delete terrainInstances[i];
-	}
-	terrainInstances.clear();
+	ReleaseAll();
+	vTerrains.clear();
 }
 
 /**
@@ -51,51 +56,79 @@ CTerrainManager::~CTerrainManager(void)
  */
 bool CTerrainManager::Init(void)
 {
-	terrainInstances.clear();
+	ReleaseAll();
+	vTerrains.clear();
+	m_iIndex = 0;
+	uiUseCounter = 0;
 
 	return true;
 }
 
 /**
- @brief Add a terrain to this class instance
- @param m_iIndex A const int variable containing the new m_iIndex
+ @brief Register a terrain with this class instance. The terrain is loaded when it is selected by SetIndex,
+		except for the first terrain, which is selected now so that there is always a terrain to render.
+ @param _name A const std::string& variable containing the name of the shader for the terrain
+ @param sImagePath A const string variable containing the path to the heightmap image
+ @param fRenderX A const float variable containing the size of the terrain along the x-axis
+ @param fHeight A const float variable containing the height of the terrain
+ @param fRenderZ A const float variable containing the size of the terrain along the z-axis
  @return true if the operation is successful, false is otherwise.
  */
 bool CTerrainManager::Add(const std::string& _name,
 						const string sImagePath,
 						const float fRenderX, const float fHeight, const float fRenderZ)
 {
-	CTerrain* cTerrain = new CTerrain();
-	cTerrain->SetShader("Shader3D_Terrain");
-	if (cTerrain->Init(sImagePath) == false)
+	// Check that the heightmap can be read, so that the terrain does not fail when it is selected later
+	FILE* pFile = fopen(sImagePath.c_str(), "rb");
+	if (pFile == NULL)
 	{
-		cout << "Unable to add terrain: " << sImagePath << endl;
+		cout << "Unable to find terrain: " << sImagePath << endl;
 		return false;
 	}
+	fclose(pFile);
 
-	// Set the size of the Terrain
-	cTerrain->SetRenderSize(100.0f, 5.0f, 100.0f);
+	STerrainEntry sEntry;
+	sEntry.sShaderName = _name;
+	sEntry.sImagePath = sImagePath;
+	sEntry.vec3RenderSize = glm::vec3(fRenderX, fHeight, fRenderZ);
+	sEntry.cTerrain = NULL;
+	sEntry.uiLastUsed = 0;
+	sEntry.bDeformed = false;
 
-	// Push this new CTerrain into the vector
-	terrainInstances.push_back(cTerrain);
+	// Push this new terrain into the vector
+	vTerrains.push_back(sEntry);
+
+	if (vTerrains.size() == 1)
+	{
+		if (SetIndex(0) == false)
+		{
+			vTerrains.pop_back();
+			return false;
+		}
+	}
 
 	return true;
 }
 
 /**
- @brief Set the index of the Terrain to render
+ @brief Set the index of the Terrain to render. The terrain is loaded if it is not loaded yet.
  @param m_iIndex A const int variable containing the new m_iIndex
  @return true if the operation is successful, false is otherwise.
  */
 bool CTerrainManager::SetIndex(const int m_iIndex)
 {
-	if ((m_iIndex >= 0) && (m_iIndex < int(terrainInstances.size())))
-	{
-		this->m_iIndex = m_iIndex;
-		return true;;
-	}
+	if ((m_iIndex < 0) || (m_iIndex >= int(vTerrains.size())))
+		return false;
+
+	if ((vTerrains[m_iIndex].cTerrain == NULL) && (Load(m_iIndex) == false))
+		return false;
+
+	this->m_iIndex = m_iIndex;
+	vTerrains[m_iIndex].uiLastUsed = ++uiUseCounter;
 
-	return false;
+	ReleaseLeastRecentlyUsed();
+
+	return true;
 }
 
 /**
@@ -107,13 +140,68 @@ int CTerrainManager::GetIndex(void) const
 	return m_iIndex;
 }
 
+/**
+ @brief Get the number of terrains which are registered
+ @return A int variable
+ */
+int CTerrainManager::GetNumOfTerrains(void) const
+{
+	return int(vTerrains.size());
+}
+
+/**
+ @brief Set the maximum number of terrains which are loaded at the same time
+ @param uiMaxNumOfResident A const unsigned int variable containing the maximum number of terrains. It is at least 1.
+ */
+void CTerrainManager::SetMaxNumOfResident(const unsigned int uiMaxNumOfResident)
+{
+	this->uiMaxNumOfResident = (uiMaxNumOfResident > 0 ? uiMaxNumOfResident : 1);
+	ReleaseLeastRecentlyUsed();
+}
+
+/**
+ @brief Get the maximum number of terrains which are loaded at the same time
+ @return A unsigned int variable
+ */
+unsigned int CTerrainManager::GetMaxNumOfResident(void) const
+{
+	return uiMaxNumOfResident;
+}
+
+/**
+ @brief Get the number of terrains which are loaded
+ @return A unsigned int variable
+ */
+unsigned int CTerrainManager::GetNumOfResident(void) const
+{
+	unsigned int uiNumOfResident = 0;
+	for (unsigned int i = 0; i < vTerrains.size(); i++)
+	{
+		if (vTerrains[i].cTerrain != NULL)
+			uiNumOfResident++;
+	}
+	return uiNumOfResident;
+}
+
+/**
+ @brief Check if a terrain is loaded
+ @param iIndex A const int variable containing the index of the terrain
+ @return A bool variable
+ */
+bool CTerrainManager::IsResident(const int iIndex) const
+{
+	if ((iIndex < 0) || (iIndex >= int(vTerrains.size())))
+		return false;
+	return (vTerrains[iIndex].cTerrain != NULL);
+}
+
 /**
  @brief Set model
  @param model A glm::mat4 variable to be assigned to this class instance
  */
 void CTerrainManager::SetModel(const glm::mat4 model)
 {
-	terrainInstances[m_iIndex]->SetModel(model);
+	vTerrains[m_iIndex].cTerrain->SetModel(model);
 }
 
 /**
@@ -122,7 +210,7 @@ void CTerrainManager::SetModel(const glm::mat4 model)
  */
 void CTerrainManager::SetView(const glm::mat4 view)
 {
-	terrainInstances[m_iIndex]->SetView(view);
+	vTerrains[m_iIndex].cTerrain->SetView(view);
 }
 
 /**
@@ -131,7 +219,7 @@ void CTerrainManager::SetView(const glm::mat4 view)
  */
 void CTerrainManager::SetProjection(const glm::mat4 projection)
 {
-	terrainInstances[m_iIndex]->SetProjection(projection);
+	vTerrains[m_iIndex].cTerrain->SetProjection(projection);
 }
 
 /**
@@ -141,7 +229,7 @@ void CTerrainManager::SetProjection(const glm::mat4 projection)
  */
 bool CTerrainManager::Update(const double dElapsedTime)
 {
-	terrainInstances[m_iIndex]->Update(dElapsedTime);
+	vTerrains[m_iIndex].cTerrain->Update(dElapsedTime);
 	return true;
 }
 
@@ -150,7 +238,7 @@ bool CTerrainManager::Update(const double dElapsedTime)
  */
 void CTerrainManager::PreRender(void)
 {
-	terrainInstances[m_iIndex]->PreRender();
+	vTerrains[m_iIndex].cTerrain->PreRender();
 }
 
 /**
@@ -158,7 +246,7 @@ void CTerrainManager::PreRender(void)
  */
 void CTerrainManager::Render(void)
 {
-	terrainInstances[m_iIndex]->Render();
+	vTerrains[m_iIndex].cTerrain->Render();
 }
 
 /**
@@ -166,7 +254,7 @@ void CTerrainManager::Render(void)
  */
 void CTerrainManager::PostRender(void)
 {
-	terrainInstances[m_iIndex]->PostRender();
+	vTerrains[m_iIndex].cTerrain->PostRender();
 }
 
 /**
@@ -177,7 +265,9 @@ void CTerrainManager::PostRender(void)
  */
 void CTerrainManager::SetRenderSize(const float fRenderX, const float fHeight, const float fRenderZ)
 {
-	terrainInstances[m_iIndex]->SetRenderSize(fRenderX, fHeight, fRenderZ);
+	vTerrains[m_iIndex].cTerrain->SetRenderSize(fRenderX, fHeight, fRenderZ);
+	// Store the size so that it is set again if the terrain is released and loaded again
+	vTerrains[m_iIndex].vec3RenderSize = glm::vec3(fRenderX, fHeight, fRenderZ);
 }
 
 /**
@@ -187,7 +277,12 @@ void CTerrainManager::SetRenderSize(const float fRenderX, const float fHeight, c
  */
 void CTerrainManager::SetRenderSize(const float fQuadSize, const float fHeight)
 {
-	terrainInstances[m_iIndex]->SetRenderSize(fQuadSize, fHeight);
+	CTerrain* cTerrain = vTerrains[m_iIndex].cTerrain;
+	cTerrain->SetRenderSize(fQuadSize, fHeight);
+	// Store the size so that it is set again if the terrain is released and loaded again
+	vTerrains[m_iIndex].vec3RenderSize = glm::vec3(float(cTerrain->GetNumHeightmapCols()) * fQuadSize,
+												fHeight,
+												float(cTerrain->GetNumHeightmapRows()) * fQuadSize);
 }
 
 /**
@@ -196,7 +291,7 @@ void CTerrainManager::SetRenderSize(const float fQuadSize, const float fHeight)
  */
 int CTerrainManager::GetNumHeightmapRows(void) const
 {
-	return terrainInstances[m_iIndex]->GetNumHeightmapRows();
+	return vTerrains[m_iIndex].cTerrain->GetNumHeightmapRows();
 }
 
 /**
@@ -205,7 +300,7 @@ int CTerrainManager::GetNumHeightmapRows(void) const
  */
 int CTerrainManager::GetNumHeightmapCols(void) const
 {
-	return terrainInstances[m_iIndex]->GetNumHeightmapCols();
+	return vTerrains[m_iIndex].cTerrain->GetNumHeightmapCols();
 }
 
 /**
@@ -216,7 +311,19 @@ int CTerrainManager::GetNumHeightmapCols(void) const
  */
 float CTerrainManager::GetHeight(const float fX, const float fZ)
 {
-	return terrainInstances[m_iIndex]->GetHeight(fX, fZ);
+	return vTerrains[m_iIndex].cTerrain->GetHeight(fX, fZ);
+}
+
+/**
+ @brief Get the heights at a batch of X- and Z-coordinates
+ @param pfX A const float* variable containing the x coordinates to check for the heights
+ @param pfZ A const float* variable containing the z coordinates to check for the heights
+ @param pfHeights A float* variable to store the heights. It must have space for all the coordinates.
+ @param uiNumOfPositions A const unsigned int variable containing the number of coordinates
+ */
+void CTerrainManager::GetHeights(const float* pfX, const float* pfZ, float* pfHeights, const unsigned int uiNumOfPositions) const
+{
+	vTerrains[m_iIndex].cTerrain->GetHeights(pfX, pfZ, pfHeights, uiNumOfPositions);
 }
 
 /**
@@ -225,7 +332,7 @@ float CTerrainManager::GetHeight(const float fX, const float fZ)
  */
 glm::vec3 CTerrainManager::GetMinPos(void) const
 {
-	return terrainInstances[m_iIndex]->GetMinPos();
+	return vTerrains[m_iIndex].cTerrain->GetMinPos();
 }
 
 /**
@@ -234,7 +341,76 @@ glm::vec3 CTerrainManager::GetMinPos(void) const
  */
 glm::vec3 CTerrainManager::GetMaxPos(void) const
 {
-	return terrainInstances[m_iIndex]->GetMaxPos();
+	return vTerrains[m_iIndex].cTerrain->GetMaxPos();
+}
+
+/**
+ @brief Raise, lower or flatten the current terrain in a radius. The heights of the CGrids in the
+		spatial partition are updated too, so that they stay on the changed terrain. The terrain is not
+		released by ReleaseLeastRecentlyUsed after this, since the changes are only kept in memory.
+ @param eDeformation A const CTerrain::DEFORMATION variable containing how the terrain is changed
+ @param fX A const float variable containing the x coordinate of the centre
+ @param fZ A const float variable containing the z coordinate of the centre
+ @param fRadius A const float variable containing the radius
+ @param fStrength A const float variable containing the height to raise or lower the centre by,
+		or the fraction from 0.0 to 1.0 to flatten the centre by towards its height
+ @return A bool variable which is false if no part of the terrain is in the radius
+ */
+bool CTerrainManager::Deform(const CTerrain::DEFORMATION eDeformation, const float fX, const float fZ, const float fRadius, const float fStrength)
+{
+	if (vTerrains[m_iIndex].cTerrain->Deform(eDeformation, fX, fZ, fRadius, fStrength) == false)
+		return false;
+	vTerrains[m_iIndex].bDeformed = true;
+
+	CSpatialPartition::GetInstance()->UpdateGridHeights(glm::vec3(fX - fRadius, 0.0f, fZ - fRadius),
+														glm::vec3(fX + fRadius, 0.0f, fZ + fRadius));
+	return true;
+}
+
+/**
+ @brief Set if the chunks further away from the camera are drawn with less detail
+ @param bLODEnabled A const bool variable which is true to draw the chunks with less detail, or false to draw them at full detail
+ */
+void CTerrainManager::SetLODEnabled(const bool bLODEnabled)
+{
+	this->bLODEnabled = bLODEnabled;
+	for (unsigned int i = 0; i < vTerrains.size(); i++)
+	{
+		if (vTerrains[i].cTerrain)
+			vTerrains[i].cTerrain->SetLODEnabled(bLODEnabled);
+	}
+}
+
+/**
+ @brief Check if the chunks further away from the camera are drawn with less detail
+ @return A bool variable
+ */
+bool CTerrainManager::IsLODEnabled(void) const
+{
+	return bLODEnabled;
+}
+
+/**
+ @brief Set if the terrains are drawn with one grid patch which is displaced by a height texture in the vertex shader
+ @param bGPUDisplacementEnabled A const bool variable which is true to displace the grid patch, or false to store every vertex
+ */
+void CTerrainManager::SetGPUDisplacementEnabled(const bool bGPUDisplacementEnabled)
+{
+	this->bGPUDisplacementEnabled = bGPUDisplacementEnabled;
+	for (unsigned int i = 0; i < vTerrains.size(); i++)
+	{
+		if (vTerrains[i].cTerrain)
+			vTerrains[i].cTerrain->SetGPUDisplacementEnabled(bGPUDisplacementEnabled);
+	}
+}
+
+/**
+ @brief Check if the terrains are drawn with one grid patch which is displaced by a height texture in the vertex shader
+ @return A bool variable
+ */
+bool CTerrainManager::IsGPUDisplacementEnabled(void) const
+{
+	return bGPUDisplacementEnabled;
 }
 
 /**
@@ -242,5 +418,84 @@ glm::vec3 CTerrainManager::GetMaxPos(void) const
  */
 void CTerrainManager::PrintSelf(void)
 {
-	return terrainInstances[m_iIndex]->PrintSelf();
+	cout << "CTerrainManager::PrintSelf()" << endl;
+	cout << "========================" << endl;
+	cout << "Terrains: " << GetNumOfResident() << " loaded out of " << vTerrains.size()
+		<< ", up to " << uiMaxNumOfResident << " loaded at the same time" << endl;
+	for (unsigned int i = 0; i < vTerrains.size(); i++)
+	{
+		cout << (int(i) == m_iIndex ? "* " : "  ") << i << ": " << vTerrains[i].sImagePath
+			<< (vTerrains[i].cTerrain ? " (loaded)" : "") << (vTerrains[i].bDeformed ? " (deformed)" : "") << endl;
+	}
+
+	vTerrains[m_iIndex].cTerrain->PrintSelf();
+}
+
+/**
+ @brief Load a terrain
+ @param iIndex A const int variable containing the index of the terrain
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CTerrainManager::Load(const int iIndex)
+{
+	STerrainEntry& sEntry = vTerrains[iIndex];
+
+	CTerrain* cTerrain = new CTerrain();
+	cTerrain->SetShader(sEntry.sShaderName);
+	// Select the render path before the heightmap is loaded, so that its buffers are only created once
+	cTerrain->SetGPUDisplacementEnabled(bGPUDisplacementEnabled);
+	if (cTerrain->Init(sEntry.sImagePath) == false)
+	{
+		cout << "Unable to load terrain: " << sEntry.sImagePath << endl;
+		delete cTerrain;
+		return false;
+	}
+
+	// Set the size of the Terrain
+	cTerrain->SetRenderSize(sEntry.vec3RenderSize.x, sEntry.vec3RenderSize.y, sEntry.vec3RenderSize.z);
+	cTerrain->SetLODEnabled(bLODEnabled);
+
+	sEntry.cTerrain = cTerrain;
+
+	return true;
+}
+
+/**
+ @brief Release the least recently used terrains until no more than the maximum number of terrains are loaded.
+		The current terrain and the deformed terrains are never released, so more than the maximum
+		number of terrains may stay loaded.
+ */
+void CTerrainManager::ReleaseLeastRecentlyUsed(void)
+{
+	unsigned int uiNumOfResident = GetNumOfResident();
+	while (uiNumOfResident > uiMaxNumOfResident)
+	{
+		int iLeastRecentlyUsed = -1;
+		for (int i = 0; i < int(vTerrains.size()); i++)
+		{
+			if ((i == m_iIndex) || (vTerrains[i].cTerrain == NULL) || (vTerrains[i].bDeformed == true))
+				continue;
+			if ((iLeastRecentlyUsed < 0) || (vTerrains[i].uiLastUsed < vTerrains[iLeastRecentlyUsed].uiLastUsed))
+				iLeastRecentlyUsed = i;
+		}
+		if (iLeastRecentlyUsed < 0)
+			break;
+
+		delete vTerrains[iLeastRecentlyUsed].cTerrain;
+		vTerrains[iLeastRecentlyUsed].cTerrain = NULL;
+		uiNumOfResident--;
+	}
+}
+
+/**
+ @brief Release all the terrains. They are still registered, and are loaded again when they are selected.
+ */
+void CTerrainManager::ReleaseAll(void)
+{
+	for (unsigned int i = 0; i < vTerrains.size(); i++)
+	{
+		delete vTerrains[i].cTerrain;
+		vTerrains[i].cTerrain = NULL;
+		vTerrains[i].bDeformed = false;
+	}
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 /**
 CTerrainManager
-@brief This class manages the instances of CTerrain.
+@brief This class manages the instances of CTerrain. The terrains are registered by their
+	   heightmap paths, and each terrain is only loaded when it is first selected by SetIndex.
+	   The least recently used terrains are released when more than the maximum number of
+	   terrains are loaded, so the memory stays bounded as more terrains are added.
+	   A terrain which was deformed is not released, since its changes would be lost.
 By: Toh Da Jun
 Date: Nov 2022
 */
@@ -18,6 +22,7 @@ Date: Nov 2022
 #include <includes/gtc/type_ptr.hpp>
 
 #include <string>
+#include <vector>
 using namespace std;
 
 class CTerrainManager : public CSingletonTemplate<CTerrainManager>
@@ -27,7 +32,7 @@ public:
 	// Initialise this class instance
 	bool Init(void);
 
-	// Add a terrain to this class instance
+	// Register a terrain with this class instance. It is loaded when it is selected by SetIndex.
 	bool Add(const std::string& _name,
 			 const string sImagePath,
 			 const float fRenderX, const float fHeight, const float fRenderZ);
@@ -36,6 +41,17 @@ public:
 	bool SetIndex(const int m_iIndex);
 	// Get the index of the Terrain being rendered
 	int GetIndex(void) const;
+	// Get the number of terrains which are registered
+	int GetNumOfTerrains(void) const;
+
+	// Set the maximum number of terrains which are loaded at the same time
+	void SetMaxNumOfResident(const unsigned int uiMaxNumOfResident);
+	// Get the maximum number of terrains which are loaded at the same time
+	unsigned int GetMaxNumOfResident(void) const;
+	// Get the number of terrains which are loaded
+	unsigned int GetNumOfResident(void) const;
+	// Check if a terrain is loaded
+	bool IsResident(const int iIndex) const;
 
 	// Update this class instance
 	virtual bool Update(const double dElapsedTime);
@@ -63,19 +79,63 @@ public:
 	int GetNumHeightmapCols(void) const;
 	// Get the height at a X- and Z-coordinate
 	float GetHeight(const float fX, const float fZ);
+	// Get the heights at a batch of X- and Z-coordinates
+	void GetHeights(const float* pfX, const float* pfZ, float* pfHeights, const unsigned int uiNumOfPositions) const;
 	// Get the vMinPos
 	glm::vec3 GetMinPos(void) const;
 	// Get the vMaxPos
 	glm::vec3 GetMaxPos(void) const;
 
+	// Raise, lower or flatten the current terrain in a radius, and update the heights of the spatial partition
+	bool Deform(const CTerrain::DEFORMATION eDeformation, const float fX, const float fZ, const float fRadius, const float fStrength);
+
+	// Set if the chunks further away from the camera are drawn with less detail
+	void SetLODEnabled(const bool bLODEnabled);
+	// Check if the chunks further away from the camera are drawn with less detail
+	bool IsLODEnabled(void) const;
+	// Set if the terrains are drawn with one grid patch which is displaced by a height texture in the vertex shader
+	void SetGPUDisplacementEnabled(const bool bGPUDisplacementEnabled);
+	// Check if the terrains are drawn with one grid patch which is displaced by a height texture in the vertex shader
+	bool IsGPUDisplacementEnabled(void) const;
+
 	// Print Self
 	void PrintSelf(void);
 
 protected:
-	// The index of the current SkyBox textureID
+	// A registered terrain, which may not be loaded
+	struct STerrainEntry
+	{
+		std::string sShaderName;
+		std::string sImagePath;
+		// The render size which is set when the terrain is loaded
+		glm::vec3 vec3RenderSize;
+		// The loaded terrain, or NULL if it is not loaded
+		CTerrain* cTerrain;
+		// The value of uiUseCounter when this terrain was last selected
+		unsigned int uiLastUsed;
+		// Indicate if this terrain was deformed. It is kept loaded, since its changes are not saved.
+		bool bDeformed;
+	};
+
+	// The index of the current Terrain
 	int m_iIndex;
-	// The vector of CTerrain instances
-	std::vector<CTerrain*> terrainInstances;
+	// The registered terrains
+	std::vector<STerrainEntry> vTerrains;
+	// The maximum number of terrains which are loaded at the same time
+	unsigned int uiMaxNumOfResident;
+	// Counts the selections of the terrains, to find the least recently used terrain
+	unsigned int uiUseCounter;
+	// Indicate if the chunks further away from the camera are drawn with less detail. It is applied to every loaded terrain.
+	bool bLODEnabled;
+	// Indicate if the terrains are drawn with one grid patch which is displaced by a height texture. It is applied to every loaded terrain.
+	bool bGPUDisplacementEnabled;
+
+	// Load a terrain
+	bool Load(const int iIndex);
+	// Release the least recently used terrains until no more than the maximum number of terrains are loaded
+	void ReleaseLeastRecentlyUsed(void);
+	// Release all the terrains
+	void ReleaseAll(void);
 
 	// Constructor
 	CTerrainManager(void);
@@ -22,6 +22,9 @@ using namespace std;
 // Include ImageLoader
 #include "System\ImageLoader.h"
 
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 #include <iostream>
 using namespace std;
 
@@ -140,7 +143,7 @@ bool CTexture::LoadTexture2D(string a_sPath, bool bGenerateMipMaps)
 	int width = 0;
 	int height = 0;
 	int nrChannels = 0;
-	unsigned char* data = CImageLoader::GetInstance()->Load(a_sPath.c_str(), width, height, nrChannels, false);
+	unsigned char* data = CAssetLoader::GetInstance()->DecodeImage(a_sPath.c_str(), width, height, nrChannels, false);
 
 	GLenum format;
 	if (nrChannels == 4)format = GL_RGBA;
@@ -333,25 +336,33 @@ string CTexture::GetPath(void) const
 }
 
 /**
- @brief The array of textures for the terrain
+ @brief The material table which packs the textures for the terrain into the layers of texture arrays
  */
-CTexture tTextures[NUMTEXTURES];
+CMaterialTable cTerrainMaterialTable;
 
 /**
- @brief Load the 5 textures for the terrain
+ @brief Load the 5 textures for the terrain. They are kept at their own sizes and compressed, and the
+		textures which have the same size are packed into the same texture array. They are not resized
+		to one size, since that would either lose the detail of the larger textures, or waste memory on
+		the smaller ones. The texture arrays are shared by all the terrains, so they are only loaded once.
  */
 bool LoadAllTextures(void)
 {
+	if (cTerrainMaterialTable.IsBuilt() == true)
+		return true;
+
 	// Load textures
 	string sTextureNames[] = { "fungus.png", "sand_grass_02.png", "rock_2_4w.png", "sand.png", "path.png" };
 
+	// The RGB images were uploaded as GL_BGR, so swap their red and blue channels to keep their colours
 	for (int i = 0; i < NUMTEXTURES; i++)
 	{
-		if (tTextures[i].LoadTexture2D("Image/Terrain/textures/" + sTextureNames[i], true) == false)
+		if (cTerrainMaterialTable.Add(sTextureNames[i], "Image/Terrain/textures/" + sTextureNames[i], false, true) != i)
+		{
+			cTerrainMaterialTable.Exit();
 			return false;
-
-		tTextures[i].SetFiltering(TEXTURE_FILTER_MAG_BILINEAR, TEXTURE_FILTER_MIN_BILINEAR_MIPMAP);
+		}
 	}
 
-	return true;
+	return cTerrainMaterialTable.Build();
 }
\ No newline at end of file
@@ -58,9 +58,12 @@ protected:
 	string sPath;
 };
 
+// Include CMaterialTable
+#include "../../Assets/MaterialTable.h"
+
 // The number of textures for the terrain
 #define NUMTEXTURES 5
-// The array of textures for the terrain
-extern CTexture tTextures[NUMTEXTURES];
+// The material table which packs the textures for the terrain into the layers of texture arrays
+extern CMaterialTable cTerrainMaterialTable;
 // Load the 5 textures for the terrain
 bool LoadAllTextures(void);
\ No newline at end of file
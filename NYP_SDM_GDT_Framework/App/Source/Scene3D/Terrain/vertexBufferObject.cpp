@@ -132,9 +132,50 @@ Result:	Sends data to GPU.
 
 void CVertexBufferObject::UploadDataToGPU(int iDrawingHint)
 {
-	glBufferData(iBufferType, data.size(), &data[0], iDrawingHint);
+	glBufferData(iBufferType, data.size(), (data.empty() ? NULL : &data[0]), iDrawingHint);
 	bDataUploaded = true;
+	// Free the copy of the data, since it is on the GPU now
 	data.clear();
+	data.shrink_to_fit();
+}
+
+/*-----------------------------------------------
+
+Name:	UploadDataToGPU
+
+Params:	ptrData - pointer to the data to send
+		uiDataSize - data size in bytes
+		iUsageHint - GL_STATIC_DRAW, GL_DYNAMIC_DRAW...
+
+Result:	Sends data to GPU directly, without copying
+		it into this VBO first.
+
+/*---------------------------------------------*/
+
+void CVertexBufferObject::UploadDataToGPU(const void* ptrData, unsigned int uiDataSize, int iDrawingHint)
+{
+	glBufferData(iBufferType, uiDataSize, ptrData, iDrawingHint);
+	bDataUploaded = true;
+	iCurrentSize = uiDataSize;
+}
+
+/*-----------------------------------------------
+
+Name:	UpdateDataOnGPU
+
+Params:	ptrData - pointer to the data to send
+		uiOffset - offset in bytes from the start of the buffer
+		uiDataSize - data size in bytes
+
+Result:	Replaces a part of the data which was
+		sent to GPU before.
+
+/*---------------------------------------------*/
+
+void CVertexBufferObject::UpdateDataOnGPU(const void* ptrData, unsigned int uiOffset, unsigned int uiDataSize)
+{
+	if(!bDataUploaded)return;
+	glBufferSubData(iBufferType, uiOffset, uiDataSize, ptrData);
 }
 
 /*-----------------------------------------------
@@ -32,6 +32,8 @@ public:
 
 	void BindVBO(int a_iBufferType = GL_ARRAY_BUFFER);
 	void UploadDataToGPU(int iUsageHint);
+	void UploadDataToGPU(const void* ptrData, unsigned int uiDataSize, int iUsageHint);
+	void UpdateDataOnGPU(const void* ptrData, unsigned int uiOffset, unsigned int uiDataSize);
 	
 	void AddData(void* ptrData, unsigned int uiDataSize);
 
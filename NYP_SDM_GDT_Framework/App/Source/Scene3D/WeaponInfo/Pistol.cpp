@@ -5,11 +5,8 @@
  */
 #include "Pistol.h"
 
- // Include LoadOBJ
-#include "System/LoadOBJ.h"
-
- // Include ImageLoader
-#include "System\ImageLoader.h"
+ // Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
 
 #include <iostream>
 using namespace std;
@@ -59,45 +56,37 @@ bool CPistol::Init(void)
 	// Set the type
 	SetType(CEntity3D::TYPE::OTHERS);
 
-	std::vector<glm::vec3> vertices;
-	std::vector<glm::vec2> uvs;
-	std::vector<glm::vec3> normals;
-	std::vector<ModelVertex> vertex_buffer_data;
-	std::vector<GLuint> index_buffer_data;
-
-	std::string file_path = "Models/Pistol/gun_type64_01.obj";
-	bool success = CLoadOBJ::LoadOBJ(file_path.c_str(), vertices, uvs, normals, true);
-	if (!success)
+	// Load the OBJ and the texture on the worker threads.
+	// The mesh is uploaded to the graphics card on the main thread when it is loaded.
+	CAssetLoader* cAssetLoader = CAssetLoader::GetInstance();
+	cAssetLoader->LoadMesh("Models/Pistol/gun_type64_01.obj", [this](const CAssetLoader::SMeshData& sMeshData)
 	{
-		cout << "Unable to load Models/Pistol/gun_type64_01.obj" << endl;
-		return false;
-	}
-
-	CLoadOBJ::IndexVBO(vertices, uvs, normals, index_buffer_data, vertex_buffer_data);
-
-	glGenVertexArrays(1, &VAO);
-	glBindVertexArray(VAO);
-	glGenBuffers(1, &VBO);
-	glGenBuffers(1, &IBO);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, vertex_buffer_data.size() * sizeof(ModelVertex), &vertex_buffer_data[0], GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_buffer_data.size() * sizeof(GLuint), &index_buffer_data[0], GL_STATIC_DRAW);
-	iIndicesSize = index_buffer_data.size();
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+		if ((sMeshData.bSuccess == false) || (sMeshData.uiNumOfIndices == 0))
+			return;
+
+		glGenVertexArrays(1, &VAO);
+		glBindVertexArray(VAO);
+		glGenBuffers(1, &VBO);
+		glGenBuffers(1, &IBO);
+
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, sMeshData.GetVertexBufferSize(), sMeshData.pVertices, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sMeshData.GetIndexBufferSize(), sMeshData.pIndices, GL_STATIC_DRAW);
+		iIndicesSize = sMeshData.uiNumOfIndices;
+		eIndexType = sMeshData.eIndexType;
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ModelVertex), (void*)(sizeof(glm::vec3) + sizeof(glm::vec3)));
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	});
 
 	// load and create a texture 
-	iTextureID = CImageLoader::GetInstance()->LoadTextureGetID("Models/Pistol/map_gunType64_01_AO_RGB.png", false);
-	if (iTextureID == 0)
+	cAssetLoader->LoadTexture("Models/Pistol/map_gunType64_01_AO_RGB.png", false, [this](const GLuint uiTextureID)
 	{
-		cout << "Unable to load Models/Pistol/map_gunType64_01_AO.png" << endl;
-		return false;
-	}
+		iTextureID = uiTextureID;
+	});
 
 	// Since this class instance has been initialised successfully, then it is usable
 	bIsUsable = true;
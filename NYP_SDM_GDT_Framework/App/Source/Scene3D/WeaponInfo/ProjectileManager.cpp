@@ -5,6 +5,18 @@
  */
 #include "ProjectileManager.h"
 
+// Include CJobSystem
+#include "../../JobSystem/JobSystem.h"
+
+// Include ShaderManager
+#include "RenderControl/ShaderManager.h"
+
+// Include ImageLoader
+#include "System\ImageLoader.h"
+
+// Include CAssetLoader
+#include "../../Assets/AssetLoader.h"
+
 #include <iostream>
 using namespace std;
 
@@ -15,9 +27,18 @@ CProjectileManager::CProjectileManager(void)
 	: model(glm::mat4(1.0f))
 	, view(glm::mat4(1.0f))
 	, projection(glm::mat4(1.0f))
-	, uiTotalElements(2)
-	, uiIndexFirst(0)
-	, uiIndexLast(0)
+	, uiTotalElements(64)
+	, uiGrainSize(256)
+	, fSize(0.1f)
+	, vec3BoxMin(glm::vec3(-0.05f, -0.05f, -0.05f))
+	, vec3BoxMax(glm::vec3(0.05f, 0.05f, 0.05f))
+	, VAO(0)
+	, VBO(0)
+	, IBO(0)
+	, iIndicesSize(0)
+	, iTextureID(0)
+	, uiInstanceVBO(0)
+	, uiInstanceVBOCapacity(0)
 {
 }
 
@@ -26,13 +47,19 @@ CProjectileManager::CProjectileManager(void)
  */
 CProjectileManager::~CProjectileManager(void)
 {
-	// Remove all CProjectile*
-	for (unsigned int i = 0; i < vProjectile.size(); i++)
+	// We set the sources to NULL only since they were declared somewhere else
+	vSource.clear();
+
+	// Delete the rendering objects in the graphics card
+	if (VAO != 0)
 	{
-		delete vProjectile[i];
-		vProjectile[i] = NULL;
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &IBO);
+		glDeleteBuffers(1, &uiInstanceVBO);
 	}
-	vProjectile.clear();
+	if (iTextureID != 0)
+		glDeleteTextures(1, &iTextureID);
 }
 
 /**
@@ -50,18 +77,17 @@ void CProjectileManager::SetShader(const std::string& _name)
  */
 bool CProjectileManager::Init(void)
 {
-	// Clear the vector
-	vProjectile.clear();
-
-	// Reserve the size of the vector
-	vProjectile.reserve(uiTotalElements);
+	// Clear the pool and reserve its size. The pool grows when it is full.
+	cHandlePool.Init(uiTotalElements, CHandlePool::POLICY::GROW);
+	vPosition.clear();
+	vPreviousPosition.clear();
+	vVelocity.clear();
+	vLifetime.clear();
+	vSource.clear();
+	Resize();
 
-	// Create the instances of CProjectile* and store them in the vector
-	for (unsigned int i = 0; i < uiTotalElements; i++)
-	{
-		vProjectile.push_back(new CProjectile());
-	}
-	return true;
+	// Create the rendering objects which are shared by all the projectiles
+	return InitRenderingObjects();
 }
 
 /**
@@ -92,57 +118,76 @@ void CProjectileManager::SetProjection(glm::mat4 projection)
 }
 
 /**
- @brief Activate a CProjectile* to this class instance
+ @brief Activate a projectile in this class instance.
+		If the pool is full, then it grows or the oldest projectile is reused, depending on the policy.
  @param vec3Position A const glm::vec3 variable containing the source position of the projectile
  @param vec3Front A const glm::vec3 variable containing the direction of the projectile
- @param dLifeTime A const double variable containing the life time of this projectile in milliseconds
+ @param dLifeTime A const double variable containing the life time of this projectile in seconds
  @param fSpeed A const float variable containing the speed of this projectile
  @param pSource A CSolidObject* variable containing the source of this projectile
- @return A int variable
+ @return A CHandlePool::SHandle variable containing the handle of the projectile, which is not valid if the pool is full
  */
-int CProjectileManager::Activate(	glm::vec3 vec3Position, 
-									glm::vec3 vec3Front, 
-									const double dLifetime,
-									const float fSpeed,
-									CSolidObject* pSource)
+CHandlePool::SHandle CProjectileManager::Activate(	glm::vec3 vec3Position,
+													glm::vec3 vec3Front,
+													const double dLifetime,
+													const float fSpeed,
+													CSolidObject* pSource)
 {
-	// Since a projectile has been added, we activate the next element in the vector
-	vProjectile[uiIndexLast]->Init(vec3Position, vec3Front, dLifetime, fSpeed);
-	vProjectile[uiIndexLast]->SetPreviousPosition(vec3Position);
-	vProjectile[uiIndexLast]->InitCollider(	"Shader3D_Line", 
-											glm::vec4(1.0f, 1.0f, 0.0f, 1.0f),
-											glm::vec3(-0.05f, -0.05f, -0.05f), 
-											glm::vec3(0.05f, 0.05f, 0.05f));
-	vProjectile[uiIndexLast]->SetStatus(true);
-	vProjectile[uiIndexLast]->SetSource(pSource);
-	vProjectile[uiIndexLast]->SetShader(sShaderName);
+	CHandlePool::SHandle sHandle;
+	unsigned int uiIndex;
+	if (cHandlePool.Activate(sHandle, uiIndex) == false)
+		return sHandle;
+
+	// Resize the arrays if the pool had grown
+	Resize();
 
-	// Increase the uiIndexLast by 1 since a projectile is going to be added
-	if (uiIndexLast + 1 == vProjectile.size())
-		uiIndexLast = 0;
-	else
-		uiIndexLast++;
+	vPosition[uiIndex] = vec3Position;
+	vPreviousPosition[uiIndex] = vec3Position;
+	vVelocity[uiIndex] = vec3Front * fSpeed;
+	vLifetime[uiIndex] = dLifetime;
+	vSource[uiIndex] = pSource;
 
-	return uiIndexLast;
+	return sHandle;
 }
 
 /**
- @brief Deactivate a CProjectile* from this class instance
+ @brief Deactivate a projectile in this class instance using its index.
+		The last active projectile is moved into this index.
  @param iIndex A const unsigned int variable containing the index of the projectile to deactivate
  @return A bool variable to indicate this method successfully completed its tasks
  */
 bool CProjectileManager::Deactivate(const unsigned int iIndex)
 {
-	if (iIndex<vProjectile.size())
-	{
-		// Set the projectile to inactive
-		vProjectile[iIndex]->SetStatus(false);
-		// Return true
-		return true;
-	}
+	unsigned int uiMovedFrom;
+	if (cHandlePool.DeactivateAt(iIndex, uiMovedFrom) == false)
+		return false;
 
-	// Return false if not found
-	return false;
+	Move(uiMovedFrom, iIndex);
+	return true;
+}
+
+/**
+ @brief Deactivate a projectile in this class instance using its handle
+ @param sHandle A const CHandlePool::SHandle& variable containing the handle of the projectile to deactivate
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CProjectileManager::Deactivate(const CHandlePool::SHandle& sHandle)
+{
+	unsigned int uiIndex, uiMovedFrom;
+	if (cHandlePool.Deactivate(sHandle, uiIndex, uiMovedFrom) == false)
+		return false;
+
+	Move(uiMovedFrom, uiIndex);
+	return true;
+}
+
+/**
+ @brief Set the policy when the pool is full
+ @param ePolicy A const CHandlePool::POLICY variable containing the policy
+ */
+void CProjectileManager::SetPolicy(const CHandlePool::POLICY ePolicy)
+{
+	cHandlePool.SetPolicy(ePolicy);
 }
 
 /**
@@ -151,47 +196,34 @@ bool CProjectileManager::Deactivate(const unsigned int iIndex)
  */
 void CProjectileManager::Update(const double dElapsedTime)
 {
-	uiIndexFirst = uiIndexLast + 1;
-	if (uiIndexFirst >= vProjectile.size())
-	{
-		uiIndexFirst = 0;
-
-		// CollisionCheck all projectiles against CSolidObject
-		// Check the oldest index until the end of 
-		for (unsigned int i = uiIndexFirst; i <= uiIndexLast; i++)
-		{
-			// If this projectile is not active, then skip it
-			if (vProjectile[i]->GetStatus() == false)
-				continue;
-
-			// Update a projectile
-			vProjectile[i]->Update(dElapsedTime);
-		}
-	}
-	else
+	// Integrate the projectiles on the worker threads.
+	// Each job only writes to its own range of the arrays, so no locking is needed.
+	CJobSystem::GetInstance()->ParallelFor(cHandlePool.GetNumOfActive(), uiGrainSize,
+		[this, dElapsedTime](const unsigned int uiBegin, const unsigned int uiEnd)
 	{
-		// CollisionCheck all projectiles against CSolidObject
-		// Check the oldest index until the end of 
-		for (unsigned int i = uiIndexFirst; i < vProjectile.size(); i++)
+		for (unsigned int i = uiBegin; i < uiEnd; i++)
 		{
-			// If this projectile is not active, then skip it
-			if (vProjectile[i]->GetStatus() == false)
-				continue;
+			// Update the lifetime of the projectile
+			vLifetime[i] -= dElapsedTime;
 
-			// Update a projectile
-			vProjectile[i]->Update(dElapsedTime);
+			// Store current position
+			vPreviousPosition[i] = vPosition[i];
+			// Update Position
+			vPosition[i] += vVelocity[i] * (float)dElapsedTime;
 		}
+	});
 
-		// CollisionCheck all projectiles against CSolidObject
-		for (unsigned int i = 0; i <= uiIndexLast; i++)
+	// Deactivate the expired projectiles on this thread, since it moves projectiles between indices.
+	// Check this index again after a deactivation, since the last projectile was moved into it.
+	unsigned int i = 0;
+	while (i < cHandlePool.GetNumOfActive())
+	{
+		if (vLifetime[i] < 0.0)
 		{
-			// If this projectile is not active, then skip it
-			if (vProjectile[i]->GetStatus() == false)
-				continue;
-
-			// Update a projectile
-			vProjectile[i]->Update(dElapsedTime);
+			Deactivate(i);
+			continue;
 		}
+		i++;
 	}
 }
 
@@ -200,26 +232,52 @@ void CProjectileManager::Update(const double dElapsedTime)
  */
 void CProjectileManager::PreRender(void)
 {
+	// Change depth function so depth test passes when values are equal to depth buffer's content
+	glDepthFunc(GL_LEQUAL);
+
+	// Activate shader
+	CShaderManager::GetInstance()->Use(sShaderName);
 }
 
 /**
- @brief Render this class instance
+ @brief Render this class instance. All the active projectiles are drawn in one instanced draw call.
  */
 void CProjectileManager::Render(void)
 {
-	// Render all entities
-	for (unsigned int i = 0; i < vProjectile.size(); i++)
+	// Prepare the transformation matrices of the active projectiles
+	vInstanceMatrices.clear();
+	for (unsigned int i = 0; i < cHandlePool.GetNumOfActive(); i++)
 	{
-		// If this projectile is not active, then skip it
-		if (vProjectile[i]->GetStatus() == false)
-			continue;
-
-		vProjectile[i]->SetView(view);
-		vProjectile[i]->SetProjection(projection);
-		vProjectile[i]->PreRender();
-		vProjectile[i]->Render();
-		vProjectile[i]->PostRender();
+		// Create transformations
+		glm::mat4 instanceModel = glm::mat4(1.0f); // make sure to initialize matrix to identity matrix first
+		instanceModel = glm::translate(instanceModel, vPosition[i]);
+		vInstanceMatrices.push_back(instanceModel);
 	}
+
+	if (vInstanceMatrices.empty())
+		return;
+
+	// Stream the transformation matrices into the instance buffer
+	glBindBuffer(GL_ARRAY_BUFFER, uiInstanceVBO);
+	// Double the capacity of the instance buffer until it fits
+	while (uiInstanceVBOCapacity < vInstanceMatrices.size())
+		uiInstanceVBOCapacity *= 2;
+	// Orphan the instance buffer so that we do not wait for the previous frame's draw call
+	glBufferData(GL_ARRAY_BUFFER, uiInstanceVBOCapacity * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vInstanceMatrices.size() * sizeof(glm::mat4), &vInstanceMatrices[0]);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// configure transformation matrices
+	CShaderManager::GetInstance()->activeShader->setMat4("projection", projection);
+	CShaderManager::GetInstance()->activeShader->setMat4("view", view);
+
+	// bind textures on corresponding texture units
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, iTextureID);
+		glBindVertexArray(VAO);
+			glDrawElementsInstanced(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0, (GLsizei)vInstanceMatrices.size());
+		glBindVertexArray(0);
+	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 /**
@@ -227,6 +285,83 @@ void CProjectileManager::Render(void)
  */
 void CProjectileManager::PostRender(void)
 {
+	glDepthFunc(GL_LESS); // set depth function back to default
+}
+
+/**
+ @brief Get the number of active projectiles, which are at the front of the pool
+ @return An unsigned int variable containing the number of active projectiles
+ */
+unsigned int CProjectileManager::GetNumOfActive(void) const
+{
+	return cHandlePool.GetNumOfActive();
+}
+
+/**
+ @brief Get the capacity of the pool
+ @return An unsigned int variable containing the capacity of the pool
+ */
+unsigned int CProjectileManager::GetCapacity(void) const
+{
+	return cHandlePool.GetCapacity();
+}
+
+/**
+ @brief Get the index of a projectile using its handle
+ @param sHandle A const CHandlePool::SHandle& variable containing the handle of the projectile
+ @return An unsigned int variable containing the index, or CHandlePool::UINT_INVALID if the projectile is not active
+ */
+unsigned int CProjectileManager::GetIndex(const CHandlePool::SHandle& sHandle) const
+{
+	return cHandlePool.GetDenseIndex(sHandle);
+}
+
+/**
+ @brief Get the position of a projectile
+ @param iIndex A const unsigned int variable containing the index of the projectile
+ @return A glm::vec3 variable containing the position of the projectile
+ */
+glm::vec3 CProjectileManager::GetPosition(const unsigned int iIndex) const
+{
+	return vPosition[iIndex];
+}
+
+/**
+ @brief Get the position of a projectile in the previous frame
+ @param iIndex A const unsigned int variable containing the index of the projectile
+ @return A glm::vec3 variable containing the position of the projectile in the previous frame
+ */
+glm::vec3 CProjectileManager::GetPreviousPosition(const unsigned int iIndex) const
+{
+	return vPreviousPosition[iIndex];
+}
+
+/**
+ @brief Get the source of a projectile
+ @param iIndex A const unsigned int variable containing the index of the projectile
+ @return A CSolidObject* variable which is the CSolidObject who created this projectile
+ */
+CSolidObject* CProjectileManager::GetSource(const unsigned int iIndex) const
+{
+	return vSource[iIndex];
+}
+
+/**
+ @brief Get the minimum corner of the bounding box of a projectile, relative to its position
+ @return A glm::vec3 variable containing the minimum corner of the bounding box
+ */
+glm::vec3 CProjectileManager::GetBoxMin(void) const
+{
+	return vec3BoxMin;
+}
+
+/**
+ @brief Get the maximum corner of the bounding box of a projectile, relative to its position
+ @return A glm::vec3 variable containing the maximum corner of the bounding box
+ */
+glm::vec3 CProjectileManager::GetBoxMax(void) const
+{
+	return vec3BoxMax;
 }
 
 /**
@@ -237,11 +372,159 @@ void CProjectileManager::PrintSelf(void)
 	cout << "===============================" << endl;
 	cout << "CProjectileManager::PrintSelf()" << endl;
 	cout << "-------------------------------" << endl;
-	// Render all entities
-	for (unsigned int i = 0; i < vProjectile.size(); i++)
+	cout << "Number of active projectiles: " << cHandlePool.GetNumOfActive() << " / " << cHandlePool.GetCapacity() << endl;
+	cout << "Number of stolen projectiles: " << cHandlePool.GetNumOfSteals() << endl;
+	for (unsigned int i = 0; i < cHandlePool.GetNumOfActive(); i++)
 	{
 		cout << i << "\t: ";
-		vProjectile[i]->PrintSelf();
+		cout << "Position: [" << vPosition[i].x << ", " << vPosition[i].y << ", " << vPosition[i].z << "], ";
+		cout << "Velocity: [" << vVelocity[i].x << ", " << vVelocity[i].y << ", " << vVelocity[i].z << "], ";
+		cout << "LifeTime: " << vLifetime[i] << endl;
 	}
 	cout << "===============================" << endl;
 }
+
+/**
+ @brief Create the rendering objects for the projectiles. The cube mesh and texture are
+		created once and shared by all the projectiles, and the instance buffer is streamed every frame.
+ @return A bool variable to indicate this method successfully completed its tasks
+ */
+bool CProjectileManager::InitRenderingObjects(void)
+{
+	// The rendering objects are only created once
+	if (VAO != 0)
+		return true;
+
+	// The vertices of a cube, with the position and texture coordinates for each vertex
+	const float fHalfSize = fSize * 0.5f;
+	const float arrVertices[] = {
+		// Back face
+		-fHalfSize, -fHalfSize, -fHalfSize,	0.0f, 0.0f,
+		 fHalfSize, -fHalfSize, -fHalfSize,	1.0f, 0.0f,
+		 fHalfSize,  fHalfSize, -fHalfSize,	1.0f, 1.0f,
+		-fHalfSize,  fHalfSize, -fHalfSize,	0.0f, 1.0f,
+		// Front face
+		-fHalfSize, -fHalfSize,  fHalfSize,	0.0f, 0.0f,
+		 fHalfSize, -fHalfSize,  fHalfSize,	1.0f, 0.0f,
+		 fHalfSize,  fHalfSize,  fHalfSize,	1.0f, 1.0f,
+		-fHalfSize,  fHalfSize,  fHalfSize,	0.0f, 1.0f,
+		// Left face
+		-fHalfSize,  fHalfSize,  fHalfSize,	1.0f, 0.0f,
+		-fHalfSize,  fHalfSize, -fHalfSize,	1.0f, 1.0f,
+		-fHalfSize, -fHalfSize, -fHalfSize,	0.0f, 1.0f,
+		-fHalfSize, -fHalfSize,  fHalfSize,	0.0f, 0.0f,
+		// Right face
+		 fHalfSize,  fHalfSize,  fHalfSize,	1.0f, 0.0f,
+		 fHalfSize,  fHalfSize, -fHalfSize,	1.0f, 1.0f,
+		 fHalfSize, -fHalfSize, -fHalfSize,	0.0f, 1.0f,
+		 fHalfSize, -fHalfSize,  fHalfSize,	0.0f, 0.0f,
+		// Bottom face
+		-fHalfSize, -fHalfSize, -fHalfSize,	0.0f, 1.0f,
+		 fHalfSize, -fHalfSize, -fHalfSize,	1.0f, 1.0f,
+		 fHalfSize, -fHalfSize,  fHalfSize,	1.0f, 0.0f,
+		-fHalfSize, -fHalfSize,  fHalfSize,	0.0f, 0.0f,
+		// Top face
+		-fHalfSize,  fHalfSize, -fHalfSize,	0.0f, 1.0f,
+		 fHalfSize,  fHalfSize, -fHalfSize,	1.0f, 1.0f,
+		 fHalfSize,  fHalfSize,  fHalfSize,	1.0f, 0.0f,
+		-fHalfSize,  fHalfSize,  fHalfSize,	0.0f, 0.0f
+	};
+	const GLuint arrIndices[] = {
+		0, 2, 1,		0, 3, 2,		// Back face
+		4, 5, 6,		4, 6, 7,		// Front face
+		8, 9, 10,		8, 10, 11,		// Left face
+		12, 14, 13,		12, 15, 14,		// Right face
+		16, 17, 18,		16, 18, 19,		// Bottom face
+		20, 22, 21,		20, 23, 22		// Top face
+	};
+	iIndicesSize = sizeof(arrIndices) / sizeof(GLuint);
+
+	// Load the data to the graphics card
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &IBO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(arrVertices), arrVertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(arrIndices), arrIndices, GL_STATIC_DRAW);
+
+	// The index for glVertexAttribPointer must match the Shader3D_Instancing.vs shader file
+	// position attribute
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	// texture coord attribute
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+
+	// Create the instance buffer, with enough space for the initial size of the pool
+	uiInstanceVBOCapacity = glm::max(uiTotalElements, 1u);
+	glGenBuffers(1, &uiInstanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, uiInstanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, uiInstanceVBOCapacity * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+
+	// Set transformation matrices as an instance vertex attribute (with divisor 1)
+	// set attribute pointers for matrix (4 times vec4)
+	glEnableVertexAttribArray(3);
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)0);
+	glEnableVertexAttribArray(4);
+	glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4)));
+	glEnableVertexAttribArray(5);
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(2 * sizeof(glm::vec4)));
+	glEnableVertexAttribArray(6);
+	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(3 * sizeof(glm::vec4)));
+
+	glVertexAttribDivisor(3, 1);
+	glVertexAttribDivisor(4, 1);
+	glVertexAttribDivisor(5, 1);
+	glVertexAttribDivisor(6, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// load and create a texture
+	iTextureID = CAssetLoader::GetInstance()->LoadTextureGetID("Image/Scene3D_Player.tga", false);
+	if (iTextureID == 0)
+	{
+		cout << "Unable to load Image/Scene3D_Player.tga" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ @brief Resize the arrays to the capacity of the pool
+ */
+void CProjectileManager::Resize(void)
+{
+	const unsigned int uiCapacity = cHandlePool.GetCapacity();
+	if (uiCapacity <= vPosition.size())
+		return;
+
+	vPosition.resize(uiCapacity, glm::vec3(0.0f));
+	vPreviousPosition.resize(uiCapacity, glm::vec3(0.0f));
+	vVelocity.resize(uiCapacity, glm::vec3(0.0f));
+	vLifetime.resize(uiCapacity, 0.0);
+	vSource.resize(uiCapacity, NULL);
+}
+
+/**
+ @brief Move a projectile to another index in the arrays
+ @param uiFrom A const unsigned int variable containing the index to move from
+ @param uiTo A const unsigned int variable containing the index to move to
+ */
+void CProjectileManager::Move(const unsigned int uiFrom, const unsigned int uiTo)
+{
+	if (uiFrom != uiTo)
+	{
+		vPosition[uiTo] = vPosition[uiFrom];
+		vPreviousPosition[uiTo] = vPreviousPosition[uiFrom];
+		vVelocity[uiTo] = vVelocity[uiFrom];
+		vLifetime[uiTo] = vLifetime[uiFrom];
+		vSource[uiTo] = vSource[uiFrom];
+	}
+	// We set it to NULL only since it was declared somewhere else
+	vSource[uiFrom] = NULL;
+}
@@ -1,5 +1,8 @@
 /**
  CProjectileManager
+ @brief This class stores the projectiles in a pool of arrays (SoA).
+		The active projectiles are kept packed at the front of the arrays by swapping
+		the last one into a deactivated slot, and they are drawn in one instanced draw call.
  By: Toh Da Jun
  Date: Sep 2020
  */
@@ -8,8 +11,14 @@
 // Include SingletonTemplate
 #include "DesignPatterns\SingletonTemplate.h"
 
-// Include Projectile
-#include "Projectile.h"
+// Include CSolidObject
+#include "../Entities/SolidObject.h"
+
+// Include CHandlePool
+#include "../../DesignPatterns/HandlePool.h"
+
+// Include GLEW
+#include <GL/glew.h>
 
 // Include GLM
 #include <includes/glm.hpp>
@@ -37,14 +46,19 @@ public:
 	// Set projection
 	virtual void SetProjection(glm::mat4 projection);
 
-	// Activate a CProjectile* to this class instance
-	virtual int Activate(	glm::vec3 vec3Position,
-							glm::vec3 vec3Front,
-							const double dLifetime,
-							const float fSpeed,
-							CSolidObject* pSource);
-	// Deactivate a CProjectile* from this class instance
+	// Activate a projectile in this class instance
+	virtual CHandlePool::SHandle Activate(	glm::vec3 vec3Position,
+											glm::vec3 vec3Front,
+											const double dLifetime,
+											const float fSpeed,
+											CSolidObject* pSource);
+	// Deactivate a projectile in this class instance using its index
 	virtual bool Deactivate(const unsigned int iIndex);
+	// Deactivate a projectile in this class instance using its handle
+	virtual bool Deactivate(const CHandlePool::SHandle& sHandle);
+
+	// Set the policy when the pool is full
+	void SetPolicy(const CHandlePool::POLICY ePolicy);
 
 	// Update this class instance
 	virtual void Update(const double dElapsedTime);
@@ -58,12 +72,26 @@ public:
 	// PostRender this class instance
 	virtual void PostRender(void);
 
+	// Get the number of active projectiles, which are at the front of the pool
+	unsigned int GetNumOfActive(void) const;
+	// Get the capacity of the pool
+	unsigned int GetCapacity(void) const;
+	// Get the index of a projectile using its handle
+	unsigned int GetIndex(const CHandlePool::SHandle& sHandle) const;
+	// Get the position of a projectile
+	glm::vec3 GetPosition(const unsigned int iIndex) const;
+	// Get the position of a projectile in the previous frame
+	glm::vec3 GetPreviousPosition(const unsigned int iIndex) const;
+	// Get the source of a projectile
+	CSolidObject* GetSource(const unsigned int iIndex) const;
+	// Get the minimum corner of the bounding box of a projectile, relative to its position
+	glm::vec3 GetBoxMin(void) const;
+	// Get the maximum corner of the bounding box of a projectile, relative to its position
+	glm::vec3 GetBoxMax(void) const;
+
 	// PrintSelf
 	virtual void PrintSelf(void);
 
-	// List of CProjectiles
-	std::vector<CProjectile*> vProjectile;
-
 protected:
 	// Name of Shader Program instance
 	std::string sShaderName;
@@ -73,12 +101,44 @@ protected:
 	glm::mat4 view;
 	glm::mat4 projection;
 
-	// The total number of elements to reserve for the vector
+	// The total number of elements to reserve for the pool
 	unsigned int uiTotalElements;
-	// The index of the first active element in the vector to activate
-	unsigned int uiIndexFirst;
-	// The index of the last active element in the vector to activate
-	unsigned int uiIndexLast;
+	// The number of projectiles which each job integrates in Update
+	unsigned int uiGrainSize;
+	// The pool which keeps the active projectiles at the front of the arrays
+	CHandlePool cHandlePool;
+
+	// The pool of projectiles, stored as arrays (SoA)
+	std::vector<glm::vec3> vPosition;
+	std::vector<glm::vec3> vPreviousPosition;
+	std::vector<glm::vec3> vVelocity;
+	// Remaining lifetime in seconds
+	std::vector<double> vLifetime;
+	// The source which fired each projectile
+	std::vector<CSolidObject*> vSource;
+
+	// The size of a projectile
+	float fSize;
+	// The bounding box of a projectile, relative to its position
+	glm::vec3 vec3BoxMin, vec3BoxMax;
+
+	// The rendering objects which are shared by all the projectiles
+	GLuint VAO, VBO, IBO;
+	unsigned int iIndicesSize;
+	unsigned int iTextureID;
+	// The instance buffer which the transformation matrices are streamed into
+	GLuint uiInstanceVBO;
+	// The number of matrices which the instance buffer can hold
+	unsigned int uiInstanceVBOCapacity;
+	// The transformation matrices of the active projectiles in this frame
+	std::vector<glm::mat4> vInstanceMatrices;
+
+	// Create the rendering objects for the projectiles
+	bool InitRenderingObjects(void);
+	// Resize the arrays to the capacity of the pool
+	void Resize(void);
+	// Move a projectile to another index in the arrays
+	void Move(const unsigned int uiFrom, const unsigned int uiTo);
 
 	// Default Constructor
 	CProjectileManager(void);
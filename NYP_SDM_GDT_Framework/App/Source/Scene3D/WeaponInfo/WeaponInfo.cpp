@@ -8,9 +8,6 @@
 // Include CShaderManager
 #include "RenderControl/ShaderManager.h"
 
-// Include CProjectile
-#include "Projectile.h"
-
 // Include CProjectileManager
 #include "ProjectileManager.h"
 
@@ -31,6 +28,8 @@ CWeaponInfo::CWeaponInfo()
 	, dReloadTime(0.0f)
 	, dMaxReloadTime(5.0f)
 	, bFire(true)
+	, iIndicesSize(0)
+	, eIndexType(GL_UNSIGNED_INT)
 {
 }
 
@@ -364,7 +363,7 @@ void CWeaponInfo::Render(void)
 	glBindTexture(GL_TEXTURE_2D, iTextureID);
 		// Render the mesh
 		glBindVertexArray(VAO);
-			glDrawElements(GL_TRIANGLES, iIndicesSize, GL_UNSIGNED_INT, 0);
+			glDrawElements(GL_TRIANGLES, iIndicesSize, eIndexType, 0);
 		glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
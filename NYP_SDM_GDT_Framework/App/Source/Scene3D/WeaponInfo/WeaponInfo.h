@@ -16,8 +16,8 @@
 // Include CSolidObject
 #include "../Entities/SolidObject.h"
 
-// Include Projectile
-#include "Projectile.h"
+// Include CProjectileManager
+#include "ProjectileManager.h"
 
 class CWeaponInfo : public CEntity3D
 {
@@ -106,4 +106,6 @@ protected:
 
 	// For Renderings
 	unsigned int iIndicesSize;
+	// The type of the indices, which is GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+	GLenum eIndexType;
 };